@@ -20,6 +20,7 @@ Source1011:    libcynara-session.manifest
 Source1012:    cynara-db-migration.manifest
 Source1013:    cyad.manifest
 Source1014:    cynara-db-chsgen.manifest
+Source1015:    cynara-db-convert.manifest
 Requires:      default-ac-domains
 Requires:      libcynara-commons = %{version}-%{release}
 Requires(pre): pwdutils
@@ -160,6 +161,7 @@ Cynara helper client session string creation library
 %package -n cynara-db-migration
 Summary:    Migration tools for Cynara's database
 Requires:   findutils
+Requires:   libcynara-commons = %{version}-%{release}
 
 %description -n cynara-db-migration
 Migration tools for Cynara's database
@@ -188,6 +190,7 @@ cp -a %{SOURCE1011} .
 cp -a %{SOURCE1012} .
 cp -a %{SOURCE1013} .
 cp -a %{SOURCE1014} .
+cp -a %{SOURCE1015} .
 
 %build
 %if 0%{?sec_build_binary_debug_enable}
@@ -334,6 +337,9 @@ fi
 %files -n cynara-tests
 %manifest cynara-tests.manifest
 %attr(755,root,root) %{_bindir}/cynara-tests
+%attr(755,root,root) %{_bindir}/cynara-client-tests
+%attr(755,root,root) %{_bindir}/cynara-client-async-tests
+%attr(755,root,root) %{_bindir}/cynara-performance-tests
 %attr(755,root,root) %{_bindir}/cynara-db-migration-tests
 %attr(755,root,root) %{_datarootdir}/%{name}/tests/db*/*
 %dir %attr(755,root,root) %{_datarootdir}/%{name}/tests/empty_db
@@ -391,8 +397,10 @@ fi
 %files -n cynara-db-migration
 %manifest cynara-db-migration.manifest
 %manifest cynara-db-chsgen.manifest
+%manifest cynara-db-convert.manifest
 %attr(700,root,root) %{_sbindir}/cynara-db-migration
 %attr(700,root,root) %{_sbindir}/cynara-db-chsgen
+%attr(700,root,root) %{_sbindir}/cynara-db-convert
 
 %files -n cyad
 %manifest cyad.manifest
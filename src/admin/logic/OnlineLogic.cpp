@@ -48,6 +48,7 @@
 #include <response/DescriptionListResponse.h>
 #include <response/ListResponse.h>
 #include <response/pointers.h>
+#include <response/ResponseSelector.h>
 #include <sockets/SocketClient.h>
 #include <types/ProtocolFields.h>
 
@@ -84,7 +85,7 @@ int OnlineLogic::getResponse(std::shared_ptr<Res> &retResponse, ReqArgs&&... arg
             return CYNARA_API_SERVICE_NOT_AVAILABLE;
     }
 
-    retResponse = std::dynamic_pointer_cast<Res>(response);
+    retResponse = responseCast<Res>(response);
     if (!retResponse) {
         LOGC("Critical error. Casting Response failed.");
         return CYNARA_API_UNKNOWN_ERROR;
@@ -35,6 +35,7 @@
 #include <response/AgentActionResponse.h>
 #include <response/AgentRegisterResponse.h>
 #include <response/pointers.h>
+#include <response/ResponseSelector.h>
 #include <types/ProtocolFields.h>
 
 #include <cynara-error.h>
@@ -70,7 +71,7 @@ int Logic::registerInCynara(void) {
         return CYNARA_API_SERVICE_NOT_AVAILABLE;
     }
 
-    registerResponsePtr = std::dynamic_pointer_cast<AgentRegisterResponse>(response);
+    registerResponsePtr = responseCast<AgentRegisterResponse>(response);
     if (!registerResponsePtr) {
         LOGC("Casting response to AgentRegisterResponse failed.");
         return CYNARA_API_UNKNOWN_ERROR;
@@ -116,7 +117,7 @@ int Logic::getRequest(AgentActionResponsePtr &resultPtr) {
     }
 
     AgentActionResponsePtr actionResponsePtr =
-        std::dynamic_pointer_cast<AgentActionResponse>(responsePtr);
+        responseCast<AgentActionResponse>(responsePtr);
     if (!actionResponsePtr) {
         LOGC("Casting request to AgentActionResponse failed.");
         return CYNARA_API_UNKNOWN_ERROR;
@@ -20,9 +20,10 @@
  * @brief       A micro-tool for computing checksums for Cynara's database contents
  */
 
-#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <new>
 #include <stdexcept>
@@ -38,18 +39,24 @@ namespace Cynara {
 const char ChecksumGenerator::m_fieldSeparator(';');
 const char ChecksumGenerator::m_recordSeparator('\n');
 const std::string ChecksumGenerator::m_backupFilenameSuffix("~");
-
-ChecksumGenerator::ChecksumGenerator(int argc, char * const *argv) {
-    if (argc > 1) {
-        m_pathname = argv[1];
+const std::string ChecksumGenerator::m_legacyOption("--legacy");
+
+ChecksumGenerator::ChecksumGenerator(int argc, char * const *argv)
+    : m_algorithm(Checksum::DEFAULT_ALGORITHM) {
+    for (int i = 1; i < argc; ++i) {
+        // Legacy checksums are the only ones understood by Cynara older than 0.8.0
+        if (m_legacyOption == argv[i]) {
+            m_algorithm = Checksum::Algorithm::MD5_CRYPT;
+        } else {
+            m_pathname = argv[i];
+        }
     }
 }
 
 int ChecksumGenerator::run(void) {
     try {
         openFileStream();
-        copyFileStream();
-        printRecord();
+        printRecord(generateChecksum());
         return CYNARA_API_SUCCESS;
     } catch (const std::exception &ex) {
         std::cerr << ex.what() << std::endl;
@@ -83,14 +90,22 @@ void ChecksumGenerator::openFileStream(void) {
     }
 }
 
-void ChecksumGenerator::copyFileStream(void) {
-    std::copy(std::istreambuf_iterator<char>(m_inputStream),
-              std::istreambuf_iterator<char>(),
-              std::ostreambuf_iterator<char>(m_copyStream));
-    m_inputStream.seekg(0);
+std::string ChecksumGenerator::generateChecksum(void) {
+    if (m_algorithm == Checksum::Algorithm::MD5_CRYPT) {
+        std::string data((std::istreambuf_iterator<char>(m_inputStream)),
+                         std::istreambuf_iterator<char>());
+        return generate(data);
+    }
+
+    Checksum::Hasher hasher;
+    char buffer[4096];
+    while (m_inputStream.read(buffer, sizeof(buffer)) || m_inputStream.gcount() > 0) {
+        hasher.update(buffer, static_cast<std::size_t>(m_inputStream.gcount()));
+    }
+    return hasher.checksum();
 }
 
-void ChecksumGenerator::printRecord(void) const {
+void ChecksumGenerator::printRecord(const std::string &checksum) const {
     std::unique_ptr<char, decltype(free)*> pathnameDuplicate(strdup(m_pathname.c_str()), free);
     if (pathnameDuplicate == nullptr) {
         std::cerr << "Insufficient memory available to allocate duplicate filename: <"
@@ -101,8 +116,7 @@ void ChecksumGenerator::printRecord(void) const {
     std::string basename(::basename(pathnameDuplicate.get()));
     removeBackupSuffix(basename);
 
-    std::cout << basename << m_fieldSeparator << generate(m_copyStream.str())
-              << m_recordSeparator;
+    std::cout << basename << m_fieldSeparator << checksum << m_recordSeparator;
 }
 
 void ChecksumGenerator::removeBackupSuffix(std::string &filename) const {
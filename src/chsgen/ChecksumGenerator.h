@@ -24,9 +24,10 @@
 #define SRC_CHSGEN_CHECKSUMGENERATOR_H_
 
 #include <fstream>
-#include <sstream>
 #include <string>
 
+#include <storage/Checksum.h>
+
 namespace Cynara {
 
 class ChecksumGenerator {
@@ -40,16 +41,17 @@ private:
     static const std::string generate(const std::string &data);
 
     void openFileStream(void);
-    void copyFileStream(void);
-    void printRecord(void) const;
+    std::string generateChecksum(void);
+    void printRecord(const std::string &checksum) const;
     void removeBackupSuffix(std::string &filename) const;
 
     std::ifstream m_inputStream;
-    std::stringstream m_copyStream;
     std::string m_pathname;
+    Checksum::Algorithm m_algorithm;
     static const char m_fieldSeparator;
     static const char m_recordSeparator;
     static const std::string m_backupFilenameSuffix;
+    static const std::string m_legacyOption;
 };
 
 } /* namespace Cynara */
@@ -28,7 +28,7 @@
 #include <chsgen/ChecksumGenerator.h>
 
 int main(int argc, char **argv) {
-    if (2 != argc) {
+    if (2 != argc && 3 != argc) {
         std::cerr << "Invalid commandline parameters for chsgen" << std::endl;
         return CYNARA_API_INVALID_COMMANDLINE_PARAM;
     }
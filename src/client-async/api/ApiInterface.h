@@ -24,6 +24,7 @@
 #define SRC_CLIENT_ASYNC_API_APIINTERFACE_H_
 
 #include <string>
+#include <vector>
 
 #include <cynara-client-async.h>
 
@@ -44,6 +45,12 @@ public:
                                     const std::string &user, const std::string &privilege,
                                     cynara_check_id &checkId, cynara_response_callback callback,
                                     void *userResponseData) = 0;
+    virtual int createBatchRequest(const std::string &client, const std::string &session,
+                                   const std::string &user,
+                                   const std::vector<std::string> &privileges,
+                                   std::vector<cynara_check_id> &checkIds,
+                                   cynara_response_callback callback,
+                                   void *userResponseData) = 0;
     virtual int process(void) = 0;
     virtual int cancelRequest(cynara_check_id checkId) = 0;
     virtual bool isFinishPermitted(void) = 0;
@@ -22,7 +22,10 @@
  * @brief       Implementation of external libcynara-client-async API
  */
 
+#include <algorithm>
 #include <new>
+#include <string>
+#include <vector>
 
 #include <common.h>
 #include <exceptions/TryCatch.h>
@@ -222,6 +225,49 @@ int cynara_async_create_simple_request(cynara_async *p_cynara, const char *clien
     });
 }
 
+CYNARA_API
+int cynara_async_create_batch_request(cynara_async *p_cynara, const char *client,
+                                      const char *client_session, const char *user,
+                                      const char *const *privileges, size_t count,
+                                      cynara_check_id *p_check_ids,
+                                      cynara_response_callback callback,
+                                      void *user_response_data) {
+    if (!p_cynara || !p_cynara->impl)
+        return CYNARA_API_INVALID_PARAM;
+    if (!isStringValid(client) || !isStringValid(client_session) || !isStringValid(user))
+        return CYNARA_API_INVALID_PARAM;
+    if (!privileges || count == 0 || count > CYNARA_MAX_VECTOR_SIZE)
+        return CYNARA_API_INVALID_PARAM;
+    for (size_t i = 0; i < count; ++i) {
+        if (!isStringValid(privileges[i]))
+            return CYNARA_API_INVALID_PARAM;
+    }
+
+    return Cynara::tryCatch([&]() {
+        std::string clientStr;
+        std::string clientSessionStr;
+        std::string userStr;
+        std::vector<std::string> privilegesStr;
+
+        try {
+            clientStr = client;
+            clientSessionStr = client_session;
+            userStr = user;
+            privilegesStr.assign(privileges, privileges + count);
+        } catch (const std::length_error &e) {
+            LOGE("%s", e.what());
+            return CYNARA_API_INVALID_PARAM;
+        }
+        std::vector<cynara_check_id> checkIds;
+        int ret = p_cynara->impl->createBatchRequest(clientStr, clientSessionStr, userStr,
+                                                     privilegesStr, checkIds, callback,
+                                                     user_response_data);
+        if (p_check_ids && ret == CYNARA_API_SUCCESS)
+            std::copy(checkIds.begin(), checkIds.end(), p_check_ids);
+        return ret;
+    });
+}
+
 CYNARA_API
 int cynara_async_process(cynara_async *p_cynara) {
     if (!p_cynara || !p_cynara->impl)
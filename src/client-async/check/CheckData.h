@@ -37,13 +37,15 @@ class CheckData
 {
 public:
     CheckData(const PolicyKey &key, const std::string &session, const ResponseCallback &callback,
-              bool simple)
-        : m_key(key), m_session(session), m_callback(callback), m_simple(simple), m_cancelled(false)
+              bool simple, unsigned int cacheGeneration, bool batched = false)
+        : m_key(key), m_session(session), m_callback(callback), m_simple(simple),
+          m_cancelled(false), m_cacheGeneration(cacheGeneration), m_batched(batched)
     {}
     CheckData(CheckData &&other)
         : m_key(std::move(other.m_key)), m_session(std::move(other.m_session)),
           m_callback(std::move(other.m_callback)), m_simple(other.m_simple),
-          m_cancelled(other.m_cancelled) {
+          m_cancelled(other.m_cancelled), m_cacheGeneration(other.m_cacheGeneration),
+          m_batched(other.m_batched) {
         other.m_cancelled = false;
     }
     ~CheckData() {}
@@ -72,12 +74,26 @@ public:
         m_cancelled = true;
     }
 
+    unsigned int cacheGeneration(void) const {
+        return m_cacheGeneration;
+    }
+
+    bool isBatched(void) const {
+        return m_batched;
+    }
+
+    void unbatch(void) {
+        m_batched = false;
+    }
+
 private:
     PolicyKey m_key;
     std::string m_session;
     ResponseCallback m_callback;
     bool m_simple;
     bool m_cancelled;
+    unsigned int m_cacheGeneration;
+    bool m_batched;
 };
 
 } // namespace Cynara
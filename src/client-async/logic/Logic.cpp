@@ -23,8 +23,12 @@
  */
 
 #include <cinttypes>
+#include <cstddef>
 #include <memory>
+#include <utility>
+#include <vector>
 
+#include <attributes/attributes.h>
 #include <cache/CapacityCache.h>
 #include <common.h>
 #include <config/PathConfig.h>
@@ -35,20 +39,29 @@
 #include <plugins/NaiveInterpreter.h>
 #include <protocol/ProtocolClient.h>
 #include <request/CancelRequest.h>
+#include <request/CheckBatchRequest.h>
 #include <request/CheckRequest.h>
+#include <request/InvalidationSubscribeRequest.h>
 #include <request/SimpleCheckRequest.h>
 #include <response/CancelResponse.h>
+#include <response/CheckBatchResponse.h>
 #include <response/CheckResponse.h>
+#include <response/InvalidateCacheResponse.h>
 #include <response/SimpleCheckResponse.h>
 #include <sockets/Socket.h>
 
 #include "Logic.h"
 namespace Cynara {
 
+// Consecutive connections closed right after subscription, before it is assumed to be unknown
+static const unsigned int SUBSCRIPTION_ATTEMPTS = 2;
+
 Logic::Logic(cynara_status_callback callback, void *userStatusData, const Configuration &conf)
     : m_statusCallback(callback, userStatusData), m_cache(conf.getCacheSize()),
       m_socketClient(PathConfig::SocketPath::client, std::make_shared<ProtocolClient>()),
-      m_operationPermitted(true), m_inAnswerCancelResponseCallback(false) {
+      m_operationPermitted(true), m_inAnswerCancelResponseCallback(false),
+      m_cacheGeneration(0), m_subscriptionSupported(true), m_subscriptionPending(false),
+      m_subscriptionDrops(0) {
 
     auto naiveInterpreter = std::make_shared<NaiveInterpreter>();
     for (auto &descr : naiveInterpreter->getSupportedPolicyDescr()) {
@@ -109,7 +122,7 @@ int Logic::createRequest(bool simple, const std::string &client, const std::stri
     PolicyKey key(client, user, privilege);
     ResponseCallback responseCallback(callback, userResponseData);
     m_checks.insert(CheckPair(sequenceNumber, CheckData(key, session, responseCallback,
-                                                        simple)));
+                                                        simple, m_cacheGeneration)));
     if (simple)
         m_socketClient.appendRequest(SimpleCheckRequest(key, sequenceNumber));
     else
@@ -121,6 +134,46 @@ int Logic::createRequest(bool simple, const std::string &client, const std::stri
     return CYNARA_API_SUCCESS;
 }
 
+int Logic::createBatchRequest(const std::string &client, const std::string &session,
+                              const std::string &user, const std::vector<std::string> &privileges,
+                              std::vector<cynara_check_id> &checkIds,
+                              cynara_response_callback callback, void *userResponseData) {
+    if (!m_operationPermitted)
+        return CYNARA_API_OPERATION_NOT_ALLOWED;
+
+    if (!ensureConnection())
+        return CYNARA_API_SERVICE_NOT_AVAILABLE;
+
+    // Every key gets its own check id and whole batch is sent with one more sequence number
+    std::vector<ProtocolFrameSequenceNumber> sequenceNumbers(privileges.size() + 1);
+    for (std::size_t i = 0; i < sequenceNumbers.size(); ++i) {
+        if (!m_sequenceContainer.get(sequenceNumbers[i])) {
+            for (std::size_t j = 0; j < i; ++j)
+                m_sequenceContainer.release(sequenceNumbers[j]);
+            return CYNARA_API_MAX_PENDING_REQUESTS;
+        }
+    }
+    ProtocolFrameSequenceNumber batchNumber = sequenceNumbers.back();
+    sequenceNumbers.pop_back();
+
+    std::vector<PolicyKey> keys;
+    keys.reserve(privileges.size());
+    ResponseCallback responseCallback(callback, userResponseData);
+    for (std::size_t i = 0; i < privileges.size(); ++i) {
+        keys.push_back(PolicyKey(client, user, privileges[i]));
+        m_checks.insert(CheckPair(sequenceNumbers[i],
+                                  CheckData(keys.back(), session, responseCallback, false,
+                                            m_cacheGeneration, true)));
+    }
+    m_socketClient.appendRequest(CheckBatchRequest(std::move(keys), batchNumber));
+    checkIds.assign(sequenceNumbers.begin(), sequenceNumbers.end());
+    m_batches.insert(std::make_pair(batchNumber, std::move(sequenceNumbers)));
+
+    onStatusChange(m_socketClient.getSockFd(), cynara_async_status::CYNARA_STATUS_FOR_RW);
+
+    return CYNARA_API_SUCCESS;
+}
+
 int Logic::process(void) {
     if (!m_operationPermitted)
         return CYNARA_API_OPERATION_NOT_ALLOWED;
@@ -132,6 +185,9 @@ int Logic::process(void) {
             return ret;
         if (processOut() && processIn())
             return CYNARA_API_SUCCESS;
+        // Subscription pending here was sent on freshly connected socket
+        if (m_subscriptionPending)
+            onSubscriptionDropped();
         onDisconnected();
         if (!connect())
             return CYNARA_API_SERVICE_NOT_AVAILABLE;
@@ -149,7 +205,9 @@ int Logic::cancelRequest(cynara_check_id checkId) {
     if (it == m_checks.end() || it->second.cancelled())
         return CYNARA_API_INVALID_PARAM;
 
-    m_socketClient.appendRequest(CancelRequest(it->first));
+    // Batched keys are answered by service without agents, so there is nothing to cancel there
+    if (!it->second.isBatched())
+        m_socketClient.appendRequest(CancelRequest(it->first));
 
     it->second.cancel();
 
@@ -172,11 +230,17 @@ bool Logic::checkCacheValid(void) {
 }
 
 void Logic::prepareRequestsToSend(void) {
+    // Batches are not resent, their keys are checked separately instead
+    for (const auto &batch : m_batches)
+        m_sequenceContainer.release(batch.first);
+    m_batches.clear();
+
     for (auto it = m_checks.begin(); it != m_checks.end();) {
         if (it->second.cancelled()) {
             m_sequenceContainer.release(it->first);
             it = m_checks.erase(it);
         } else {
+            it->second.unbatch();
             if (it->second.isSimple())
                 m_socketClient.appendRequest(SimpleCheckRequest(it->second.key(), it->first));
             else
@@ -213,26 +277,29 @@ void Logic::releaseRequest(Logic::CheckMap::iterator reqIt) {
     m_checks.erase(reqIt);
 }
 
-void Logic::processCheckResponse(const CheckResponse &checkResponse) {
-    LOGD("checkResponse: policyType = [%" PRIu16 "], metadata = <%s>",
-         checkResponse.m_resultRef.policyType(),
-         checkResponse.m_resultRef.metadata().c_str());
-
-    auto it = checkResponseValid(checkResponse);
-    int result = m_cache.update(it->second.session(), it->second.key(),
-                                 checkResponse.m_resultRef);
-    CheckData checkData(std::move(it->second));
-    releaseRequest(it);
+void Logic::answerRequest(Logic::CheckMap::iterator reqIt, int result) {
+    cynara_check_id checkId = static_cast<cynara_check_id>(reqIt->first);
+    CheckData checkData(std::move(reqIt->second));
+    releaseRequest(reqIt);
 
     if (!checkData.cancelled()) {
         bool onAnswerCancel = m_inAnswerCancelResponseCallback;
         m_inAnswerCancelResponseCallback = true;
-        checkData.callback().onAnswer(
-            static_cast<cynara_check_id>(checkResponse.sequenceNumber()), result);
+        checkData.callback().onAnswer(checkId, result);
         m_inAnswerCancelResponseCallback = onAnswerCancel;
     }
 }
 
+void Logic::processCheckResponse(const CheckResponse &checkResponse) {
+    LOGD("checkResponse: policyType = [%" PRIu16 "], metadata = <%s>",
+         checkResponse.m_resultRef.policyType(),
+         checkResponse.m_resultRef.metadata().c_str());
+
+    auto it = checkResponseValid(checkResponse);
+    int result = updateCache(it->second, checkResponse.m_resultRef);
+    answerRequest(it, result);
+}
+
 void Logic::processSimpleCheckResponse(const SimpleCheckResponse &response) {
     LOGD("simpleCheckResponse");
     LOGD("checkResponse: policyType = [%" PRIu16 "], metadata = <%s>",
@@ -242,18 +309,65 @@ void Logic::processSimpleCheckResponse(const SimpleCheckResponse &response) {
     auto it = checkResponseValid(response);
     int result = response.getReturnValue();
     if (result == CYNARA_API_SUCCESS)
-        result = m_cache.update(it->second.session(), it->second.key(),
-                                 response.getResult());
-    CheckData checkData(std::move(it->second));
-    releaseRequest(it);
+        result = updateCache(it->second, response.getResult());
+    answerRequest(it, result);
+}
 
-    if (!checkData.cancelled()) {
-        bool onAnswerCancel = m_inAnswerCancelResponseCallback;
-        m_inAnswerCancelResponseCallback = true;
-        checkData.callback().onAnswer(
-            static_cast<cynara_check_id>(response.sequenceNumber()), result);
-        m_inAnswerCancelResponseCallback = onAnswerCancel;
+void Logic::processCheckBatchResponse(const CheckBatchResponse &response) {
+    auto batchIt = m_batches.find(response.sequenceNumber());
+    if (batchIt == m_batches.end()) {
+        LOGC("Critical error. Unknown checkBatchResponse received: sequenceNumber = [%" PRIu16
+             "]", response.sequenceNumber());
+        throw UnexpectedErrorException("Unexpected response from cynara service");
+    }
+
+    std::vector<ProtocolFrameSequenceNumber> checkIds(std::move(batchIt->second));
+    m_sequenceContainer.release(batchIt->first);
+    m_batches.erase(batchIt);
+
+    const auto &answers = response.answers();
+    if (answers.size() != checkIds.size()) {
+        LOGC("Critical error. CheckBatchResponse contains [%zu] answers for [%zu] keys.",
+             answers.size(), checkIds.size());
+        throw UnexpectedErrorException("Unexpected response from cynara service");
+    }
+
+    bool resent = false;
+    for (std::size_t i = 0; i < checkIds.size(); ++i) {
+        // Callback may reconnect, so check could be already released or resent separately
+        auto it = m_checks.find(checkIds[i]);
+        if (it == m_checks.end() || !it->second.isBatched())
+            continue;
+
+        if (it->second.cancelled()) {
+            releaseRequest(it);
+            continue;
+        }
+
+        // Key requires agents, so it is checked again with full check request
+        if (answers[i].m_retValue == CYNARA_API_ACCESS_NOT_RESOLVED) {
+            it->second.unbatch();
+            m_socketClient.appendRequest(CheckRequest(it->second.key(), it->first));
+            resent = true;
+            continue;
+        }
+
+        int result = answers[i].m_retValue;
+        if (result == CYNARA_API_SUCCESS)
+            result = updateCache(it->second, answers[i].m_result);
+        answerRequest(it, result);
     }
+
+    if (resent)
+        onStatusChange(m_socketClient.getSockFd(), cynara_async_status::CYNARA_STATUS_FOR_RW);
+}
+
+int Logic::updateCache(const CheckData &checkData, const PolicyResult &result) {
+    // Result might be evaluated before policies changed, so it cannot be cached
+    if (checkData.cacheGeneration() != m_cacheGeneration)
+        return m_cache.interpret(checkData.session(), result);
+
+    return m_cache.update(checkData.session(), checkData.key(), result);
 }
 
 void Logic::processCancelResponse(const CancelResponse &cancelResponse) {
@@ -267,32 +381,33 @@ void Logic::processCancelResponse(const CancelResponse &cancelResponse) {
     releaseRequest(it);
 }
 
-void Logic::processResponses(void) {
-    ResponsePtr response;
-    CheckResponsePtr checkResponse;
-    CancelResponsePtr cancelResponse;
-    SimpleCheckResponsePtr simpleResponse;
-    while ((response = m_socketClient.getResponse())) {
-        checkResponse = std::dynamic_pointer_cast<CheckResponse>(response);
-        if (checkResponse) {
-            processCheckResponse(*checkResponse);
-            continue;
-        }
+void Logic::execute(const RequestContext &context UNUSED, const CancelResponse &response) {
+    processCancelResponse(response);
+}
 
-        cancelResponse = std::dynamic_pointer_cast<CancelResponse>(response);
-        if (cancelResponse) {
-            processCancelResponse(*cancelResponse);
-            continue;
-        }
+void Logic::execute(const RequestContext &context UNUSED, const CheckBatchResponse &response) {
+    processCheckBatchResponse(response);
+}
 
-        simpleResponse = std::dynamic_pointer_cast<SimpleCheckResponse>(response);
-        if (simpleResponse) {
-            processSimpleCheckResponse(*simpleResponse);
-            continue;
-        }
+void Logic::execute(const RequestContext &context UNUSED, const CheckResponse &response) {
+    processCheckResponse(response);
+}
 
-        LOGC("Critical error. Casting Response to known response failed.");
-        throw UnexpectedErrorException("Unexpected response from cynara service");
+void Logic::execute(const RequestContext &context UNUSED,
+                    const InvalidateCacheResponse &response UNUSED) {
+    onCacheInvalidated();
+}
+
+void Logic::execute(const RequestContext &context UNUSED, const SimpleCheckResponse &response) {
+    processSimpleCheckResponse(response);
+}
+
+void Logic::processResponses(void) {
+    // Responses are built on stack and dispatched to execute() overloads
+    while (m_socketClient.dispatchResponse(*this)) {
+        // Service answers requests in order, so it has accepted subscription sent before
+        m_subscriptionPending = false;
+        m_subscriptionDrops = 0;
     }
 }
 
@@ -319,10 +434,12 @@ bool Logic::ensureConnection(void) {
 bool Logic::connect(void) {
     switch (m_socketClient.connect()) {
         case Socket::ConnectionStatus::CONNECTION_SUCCEEDED:
+            appendSubscription();
             prepareRequestsToSend();
             onStatusChange(m_socketClient.getSockFd(), socketDataStatus());
             return true;
         case Socket::ConnectionStatus::CONNECTION_IN_PROGRESS:
+            appendSubscription();
             prepareRequestsToSend();
             onStatusChange(m_socketClient.getSockFd(), cynara_async_status::CYNARA_STATUS_FOR_RW);
             return true;
@@ -332,6 +449,14 @@ bool Logic::connect(void) {
     }
 }
 
+void Logic::appendSubscription(void) {
+    if (!m_subscriptionSupported)
+        return;
+
+    m_socketClient.appendRequest(InvalidationSubscribeRequest(0));
+    m_subscriptionPending = true;
+}
+
 int Logic::completeConnection(bool &completed) {
     switch (m_socketClient.completeConnection()) {
         case Socket::ConnectionStatus::ALREADY_CONNECTED:
@@ -366,15 +491,33 @@ void Logic::onServiceNotAvailable(void)
             kv.second.callback().onDisconnected(kv.first);
     }
     m_checks.clear();
+    m_batches.clear();
     m_sequenceContainer.clear();
     m_operationPermitted = true;
 }
 
 void Logic::onDisconnected(void) {
+    // Connection might have been closed for any other reason, so subscription is sent again
+    m_subscriptionPending = false;
+
     m_operationPermitted = false;
     m_cache.clear();
     m_statusCallback.onDisconnected();
     m_operationPermitted = true;
 }
 
+void Logic::onSubscriptionDropped(void) {
+    if (++m_subscriptionDrops < SUBSCRIPTION_ATTEMPTS)
+        return;
+
+    LOGW("Cynara service closed [%u] consecutive connections right after subscription. "
+         "Assuming it does not support cache invalidation subscription.", m_subscriptionDrops);
+    m_subscriptionSupported = false;
+}
+
+void Logic::onCacheInvalidated(void) {
+    m_cache.clear();
+    ++m_cacheGeneration;
+}
+
 } // namespace Cynara
@@ -25,10 +25,16 @@
 #ifndef SRC_CLIENT_ASYNC_LOGIC_LOGIC_H_
 #define SRC_CLIENT_ASYNC_LOGIC_LOGIC_H_
 
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <cache/CacheInterface.h>
 #include <configuration/Configuration.h>
+#include <request/pointers.h>
+#include <response/pointers.h>
+#include <response/ResponseTaker.h>
 #include <types/ProtocolFields.h>
 
 #include <api/ApiInterface.h>
@@ -43,7 +49,7 @@ namespace Cynara {
 class Logic;
 typedef std::unique_ptr<Logic> LogicUniquePtr;
 
-class Logic : public ApiInterface {
+class Logic : public ApiInterface, public ResponseTaker {
 public:
     Logic(cynara_status_callback callback, void *userStatusData,
           const Configuration &conf = Configuration());
@@ -59,23 +65,51 @@ public:
                                     const std::string &user, const std::string &privilege,
                                     cynara_check_id &checkId, cynara_response_callback callback,
                                     void *userResponseData);
+    virtual int createBatchRequest(const std::string &client, const std::string &session,
+                                   const std::string &user,
+                                   const std::vector<std::string> &privileges,
+                                   std::vector<cynara_check_id> &checkIds,
+                                   cynara_response_callback callback,
+                                   void *userResponseData);
     virtual int process(void);
     virtual int cancelRequest(cynara_check_id checkId);
     virtual bool isFinishPermitted(void);
 
+    using ResponseTaker::execute;
+
+    virtual void execute(const RequestContext &context, const CancelResponse &response);
+    virtual void execute(const RequestContext &context, const CheckBatchResponse &response);
+    virtual void execute(const RequestContext &context, const CheckResponse &response);
+    virtual void execute(const RequestContext &context, const InvalidateCacheResponse &response);
+    virtual void execute(const RequestContext &context, const SimpleCheckResponse &response);
+
 private:
     typedef std::map<ProtocolFrameSequenceNumber, CheckData> CheckMap;
     typedef std::pair<ProtocolFrameSequenceNumber, CheckData> CheckPair;
+    // Sequence number of batch frame mapped to check ids of its keys
+    typedef std::map<ProtocolFrameSequenceNumber,
+                     std::vector<ProtocolFrameSequenceNumber>> BatchMap;
 
     StatusCallback m_statusCallback;
     CapacityCache m_cache;
     SocketClientAsync m_socketClient;
     CheckMap m_checks;
+    BatchMap m_batches;
     SequenceContainer m_sequenceContainer;
     bool m_operationPermitted;
     bool m_inAnswerCancelResponseCallback;
+    unsigned int m_cacheGeneration;
+    /*
+     * Service, which does not know invalidation subscription, closes connection right after
+     * receiving it. When it happens on consecutive connections, client stops subscribing
+     * and relies on being disconnected on policies change.
+     */
+    bool m_subscriptionSupported;
+    bool m_subscriptionPending;
+    unsigned int m_subscriptionDrops;
 
     bool checkCacheValid(void);
+    void appendSubscription(void);
     int createRequest(bool simple, const std::string &client, const std::string &session,
                       const std::string &user, const std::string &privilege,
                       cynara_check_id &checkId, cynara_response_callback callback,
@@ -85,9 +119,12 @@ private:
     bool processOut(void);
     CheckMap::iterator checkResponseValid(const Response &response);
     void releaseRequest(CheckMap::iterator reqIt);
+    void answerRequest(CheckMap::iterator reqIt, int result);
     void processCheckResponse(const CheckResponse &checkResponse);
     void processCancelResponse(const CancelResponse &cancelResponse);
     void processSimpleCheckResponse(const SimpleCheckResponse &response);
+    void processCheckBatchResponse(const CheckBatchResponse &response);
+    int updateCache(const CheckData &checkData, const PolicyResult &result);
     void processResponses(void);
     bool processIn(void);
     bool ensureConnection(void);
@@ -96,6 +133,8 @@ private:
     void onStatusChange(int sock, cynara_async_status status);
     void onServiceNotAvailable(void);
     void onDisconnected(void);
+    void onSubscriptionDropped(void);
+    void onCacheInvalidated(void);
 };
 
 } // namespace Cynara
@@ -73,8 +73,8 @@ bool SocketClientAsync::receiveFromCynara(void) {
     return m_socket.receiveFromServer(*m_readQueue);
 }
 
-ResponsePtr SocketClientAsync::getResponse(void) {
-    return m_protocol->extractResponseFromBuffer(m_readQueue);
+bool SocketClientAsync::dispatchResponse(ResponseTaker &taker) {
+    return m_protocol->dispatchResponseFromBuffer(m_readQueue, taker);
 }
 
 void SocketClientAsync::clear(void)
@@ -31,6 +31,7 @@
 #include <protocol/Protocol.h>
 #include <request/pointers.h>
 #include <response/pointers.h>
+#include <response/ResponseTaker.h>
 #include <sockets/Socket.h>
 
 namespace Cynara {
@@ -51,7 +52,7 @@ public:
     bool isDataToSend(void);
     Socket::SendStatus sendToCynara(void);
     bool receiveFromCynara(void);
-    ResponsePtr getResponse(void);
+    bool dispatchResponse(ResponseTaker &taker);
 
 private:
     Socket m_socket;
@@ -154,6 +154,17 @@ int CapacityCache::update(const ClientSession &session,
     return plugin->toResult(session, storedResult);
 }
 
+int CapacityCache::interpret(const ClientSession &session, const PolicyResult &result) {
+    ClientPluginInterfacePtr plugin = findPlugin(result.policyType());
+    if (!plugin) {
+        LOGE("No plugin registered for given policyType: [%" PRIu16 "]", result.policyType());
+        return CYNARA_API_ACCESS_DENIED;
+    }
+
+    PolicyResult interpretedResult = result;
+    return plugin->toResult(session, interpretedResult);
+}
+
 ClientPluginInterfacePtr CapacityCache::findPlugin(PolicyType policyType) {
     ClientPluginInterfacePtr plugin;
 
@@ -44,6 +44,7 @@ public:
     int update(const ClientSession& session,
                const PolicyKey &key,
                const PolicyResult &result);
+    int interpret(const ClientSession &session, const PolicyResult &result);
     void clear(void);
 
 private:
@@ -25,6 +25,7 @@
 #define SRC_CLIENT_API_APIINTERFACE_H_
 
 #include <string>
+#include <vector>
 
 #include <cynara-client.h>
 #include <types/ClientSession.h>
@@ -40,6 +41,9 @@ public:
                       const std::string &user, const std::string &privilege) = 0;
     virtual int simpleCheck(const std::string &client, const ClientSession &session,
                             const std::string &user, const std::string &privilege) = 0;
+    virtual int checkBatch(const std::string &client, const ClientSession &session,
+                           const std::string &user, const std::vector<std::string> &privileges,
+                           std::vector<int> &results) = 0;
 };
 
 } // namespace Cynara
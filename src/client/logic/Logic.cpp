@@ -22,7 +22,9 @@
  */
 
 #include <cinttypes>
+#include <cstddef>
 #include <memory>
+#include <vector>
 
 #include <cache/CapacityCache.h>
 #include <common.h>
@@ -34,11 +36,16 @@
 #include <plugins/NaiveInterpreter.h>
 #include <protocol/Protocol.h>
 #include <protocol/ProtocolClient.h>
+#include <request/CheckBatchRequest.h>
 #include <request/CheckRequest.h>
+#include <request/InvalidationSubscribeRequest.h>
 #include <request/pointers.h>
 #include <request/SimpleCheckRequest.h>
+#include <response/CheckBatchResponse.h>
 #include <response/CheckResponse.h>
+#include <response/InvalidateCacheResponse.h>
 #include <response/pointers.h>
+#include <response/ResponseSelector.h>
 #include <response/SimpleCheckResponse.h>
 #include <sockets/SocketClient.h>
 
@@ -46,6 +53,11 @@
 
 namespace Cynara {
 
+// Consecutive connections closed right after subscription, before it is assumed to be unknown
+static const unsigned int SUBSCRIPTION_ATTEMPTS = 2;
+// Service not knowing a request closes connection on it every time
+static const unsigned int UNKNOWN_REQUEST_ATTEMPTS = 2;
+
 static ProtocolFrameSequenceNumber generateSequenceNumber(void) {
     static ProtocolFrameSequenceNumber sequenceNumber = 0;
     return ++sequenceNumber;
@@ -53,7 +65,8 @@ static ProtocolFrameSequenceNumber generateSequenceNumber(void) {
 
 Logic::Logic(const Configuration &conf) :
         m_socketClient(PathConfig::SocketPath::client, std::make_shared<ProtocolClient>()),
-        m_cache(conf.getCacheSize()) {
+        m_cache(conf.getCacheSize()), m_cacheGeneration(0), m_subscriptionSupported(true),
+        m_subscriptionPending(false), m_subscriptionDrops(0), m_batchSupported(true) {
     auto naiveInterpreter = std::make_shared<NaiveInterpreter>();
     for (auto &descr : naiveInterpreter->getSupportedPolicyDescr()) {
         m_cache.registerPlugin(descr, naiveInterpreter);
@@ -71,6 +84,7 @@ int Logic::check(const std::string &client, const ClientSession &session, const
         return ret;
     }
 
+    unsigned int cacheGeneration = m_cacheGeneration;
     PolicyResult result;
     ret = requestResult(key, result);
     if (ret != CYNARA_API_SUCCESS) {
@@ -78,7 +92,7 @@ int Logic::check(const std::string &client, const ClientSession &session, const
         return ret;
     }
 
-    return m_cache.update(session, key, result);
+    return updateCache(cacheGeneration, session, key, result);
 }
 
 int Logic::simpleCheck(const std::string &client, const ClientSession &session,
@@ -92,6 +106,7 @@ int Logic::simpleCheck(const std::string &client, const ClientSession &session,
         return ret;
     }
 
+    unsigned int cacheGeneration = m_cacheGeneration;
     PolicyResult result;
     ret = requestSimpleResult(key, result);
     if (ret != CYNARA_API_SUCCESS) {
@@ -101,35 +116,164 @@ int Logic::simpleCheck(const std::string &client, const ClientSession &session,
         return ret;
     }
 
-    return m_cache.update(session, key, result);
+    return updateCache(cacheGeneration, session, key, result);
+}
+
+int Logic::checkBatch(const std::string &client, const ClientSession &session,
+                      const std::string &user, const std::vector<std::string> &privileges,
+                      std::vector<int> &results) {
+    if (!ensureConnection())
+        return CYNARA_API_SERVICE_NOT_AVAILABLE;
+
+    std::vector<PolicyKey> keys;
+    std::vector<std::size_t> positions;
+    results.resize(privileges.size());
+    for (std::size_t i = 0; i < privileges.size(); ++i) {
+        PolicyKey key(client, user, privileges[i]);
+        results[i] = m_cache.get(session, key);
+        if (results[i] == CYNARA_API_CACHE_MISS) {
+            keys.push_back(std::move(key));
+            positions.push_back(i);
+        }
+    }
+
+    if (keys.empty())
+        return CYNARA_API_SUCCESS;
+
+    if (m_batchSupported) {
+        unsigned int cacheGeneration = m_cacheGeneration;
+        auto batchResponse = requestResponse<CheckBatchRequest, CheckBatchResponse>(keys, true);
+        if (batchResponse) {
+            const auto &answers = batchResponse->answers();
+            if (answers.size() != keys.size()) {
+                LOGC("Critical error. CheckBatchResponse contains [%zu] answers for [%zu] keys.",
+                     answers.size(), keys.size());
+                return CYNARA_API_UNKNOWN_ERROR;
+            }
+
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                int &result = results[positions[i]];
+                if (answers[i].m_retValue == CYNARA_API_SUCCESS) {
+                    result = updateCache(cacheGeneration, session, keys[i], answers[i].m_result);
+                    continue;
+                }
+                if (answers[i].m_retValue != CYNARA_API_ACCESS_NOT_RESOLVED) {
+                    result = answers[i].m_retValue;
+                    continue;
+                }
+
+                // Key requires agents, so it is checked again with full check request
+                int ret = requestCachedResult(session, keys[i], result);
+                if (ret != CYNARA_API_SUCCESS)
+                    return ret;
+            }
+            return CYNARA_API_SUCCESS;
+        }
+
+        // Connection was closed after every attempt, but service still accepts new ones
+        if (!ensureConnection()) {
+            LOGC("Critical error. Requesting CheckBatchResponse failed.");
+            return CYNARA_API_SERVICE_NOT_AVAILABLE;
+        }
+        LOGW("Cynara service closed connection on batch request. "
+             "Assuming it does not support them.");
+        m_batchSupported = false;
+    }
+
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        int ret = requestCachedResult(session, keys[i], results[positions[i]]);
+        if (ret != CYNARA_API_SUCCESS)
+            return ret;
+    }
+
+    return CYNARA_API_SUCCESS;
 }
 
 bool Logic::ensureConnection(void) {
-    if (m_socketClient.isConnected())
+    if (m_socketClient.isConnected() && processPushedResponses())
         return true;
     onDisconnected();
-    if (m_socketClient.connect())
+    if (connect())
         return true;
     LOGW("Cannot connect to cynara. Service not available.");
     return false;
 }
 
-template <typename Req, typename Res>
-std::shared_ptr<Res> Logic::requestResponse(const PolicyKey &key) {
+bool Logic::connect(void) {
+    if (!m_socketClient.connect())
+        return false;
+
+    // Subscription is sent together with first request
+    if (m_subscriptionSupported) {
+        m_socketClient.appendRequest(InvalidationSubscribeRequest(generateSequenceNumber()));
+        m_subscriptionPending = true;
+    }
+    return true;
+}
+
+bool Logic::processPushedResponses(void) {
+    while (m_socketClient.isResponseWaiting()) {
+        ResponsePtr response = m_socketClient.receiveResponse();
+        if (!response)
+            return false;
+        onResponseReceived();
+        if (!processPushedResponse(response)) {
+            LOGW("Unexpected response from cynara service ignored.");
+        }
+    }
+    return true;
+}
+
+bool Logic::processPushedResponse(const ResponsePtr &response) {
+    ResponseSelector<InvalidateCacheResponse> selector;
+    if (!selector.select(*response))
+        return false;
+
+    onCacheInvalidated();
+    return true;
+}
+
+int Logic::updateCache(unsigned int cacheGeneration, const ClientSession &session,
+                       const PolicyKey &key, const PolicyResult &result) {
+    // Result might be evaluated before policies changed, so it cannot be cached
+    if (cacheGeneration != m_cacheGeneration)
+        return m_cache.interpret(session, result);
+
+    return m_cache.update(session, key, result);
+}
+
+template <typename Req, typename Res, typename Content>
+std::shared_ptr<Res> Logic::requestResponse(const Content &content, bool mayBeUnknown) {
     ProtocolFrameSequenceNumber sequenceNumber = generateSequenceNumber();
 
     //Ask cynara service
-    std::shared_ptr<Res> reqResponse;
-    Req request(key, sequenceNumber);
-    ResponsePtr response;
-    while (!(response = m_socketClient.askCynaraServer(request))) {
-        onDisconnected();
-        if (!m_socketClient.connect())
-            return nullptr;
+    Req request(content, sequenceNumber);
+    ResponsePtr response = m_socketClient.askCynaraServer(request);
+    unsigned int unknownAttempts = 0;
+    while (true) {
+        if (!response) {
+            // Subscription pending here was sent with request on freshly connected socket
+            bool subscriptionDropped = m_subscriptionPending;
+            if (subscriptionDropped)
+                onSubscriptionDropped();
+            onDisconnected();
+            if (mayBeUnknown && !subscriptionDropped &&
+                ++unknownAttempts == UNKNOWN_REQUEST_ATTEMPTS)
+                return nullptr;
+            if (!connect())
+                return nullptr;
+            response = m_socketClient.askCynaraServer(request);
+            continue;
+        }
+        onResponseReceived();
+
+        //Cache invalidation might be pushed before response
+        if (!processPushedResponse(response))
+            break;
+        response = m_socketClient.receiveResponse();
     }
 
-    reqResponse = std::dynamic_pointer_cast<Res>(response);
-    return reqResponse;
+    return responseCast<Res>(response);
 }
 
 int Logic::requestResult(const PolicyKey &key, PolicyResult &result) {
@@ -145,6 +289,20 @@ int Logic::requestResult(const PolicyKey &key, PolicyResult &result) {
     return CYNARA_API_SUCCESS;
 }
 
+int Logic::requestCachedResult(const ClientSession &session, const PolicyKey &key,
+                               int &result) {
+    unsigned int cacheGeneration = m_cacheGeneration;
+    PolicyResult policyResult;
+    int ret = requestResult(key, policyResult);
+    if (ret != CYNARA_API_SUCCESS) {
+        LOGE("Error fetching new entry.");
+        return ret;
+    }
+
+    result = updateCache(cacheGeneration, session, key, policyResult);
+    return CYNARA_API_SUCCESS;
+}
+
 int Logic::requestSimpleResult(const PolicyKey &key, PolicyResult &result) {
     auto simpleCheckResponse = requestResponse<SimpleCheckRequest, SimpleCheckResponse>(key);
     if (!simpleCheckResponse) {
@@ -164,7 +322,29 @@ int Logic::requestSimpleResult(const PolicyKey &key, PolicyResult &result) {
 }
 
 void Logic::onDisconnected(void) {
+    // Connection might have been closed for any other reason, so subscription is sent again
+    m_subscriptionPending = false;
+    m_cache.clear();
+}
+
+void Logic::onResponseReceived(void) {
+    // Service answers requests in order, so it has accepted subscription sent before
+    m_subscriptionPending = false;
+    m_subscriptionDrops = 0;
+}
+
+void Logic::onSubscriptionDropped(void) {
+    if (++m_subscriptionDrops < SUBSCRIPTION_ATTEMPTS)
+        return;
+
+    LOGW("Cynara service closed [%u] consecutive connections right after subscription. "
+         "Assuming it does not support cache invalidation subscription.", m_subscriptionDrops);
+    m_subscriptionSupported = false;
+}
+
+void Logic::onCacheInvalidated(void) {
     m_cache.clear();
+    ++m_cacheGeneration;
 }
 
 } // namespace Cynara
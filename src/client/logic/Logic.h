@@ -26,6 +26,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <sockets/SocketClient.h>
 #include <types/PolicyKey.h>
@@ -50,15 +51,40 @@ public:
                       const std::string &user, const std::string &privilege);
     virtual int simpleCheck(const std::string &client, const ClientSession &session,
                             const std::string &user, const std::string &privilege);
+    virtual int checkBatch(const std::string &client, const ClientSession &session,
+                           const std::string &user, const std::vector<std::string> &privileges,
+                           std::vector<int> &results);
 private:
     SocketClient m_socketClient;
     CapacityCache m_cache;
+    unsigned int m_cacheGeneration;
+    /*
+     * Service, which does not know invalidation subscription, closes connection right after
+     * receiving it. When it happens on consecutive connections, client stops subscribing
+     * and relies on being disconnected on policies change.
+     */
+    bool m_subscriptionSupported;
+    bool m_subscriptionPending;
+    unsigned int m_subscriptionDrops;
+    // Service, which does not know batch requests, closes connection on every one of them
+    bool m_batchSupported;
 
     void onDisconnected(void);
+    void onResponseReceived(void);
+    void onSubscriptionDropped(void);
+    void onCacheInvalidated(void);
     bool ensureConnection(void);
-    template <typename Req, typename Res>
-    std::shared_ptr<Res> requestResponse(const PolicyKey &key);
+    bool connect(void);
+    bool processPushedResponses(void);
+    bool processPushedResponse(const ResponsePtr &response);
+    int updateCache(unsigned int cacheGeneration, const ClientSession &session,
+                    const PolicyKey &key, const PolicyResult &result);
+    // Request, which service may not know, is given up when connection is closed on it
+    // repeatedly for other reason than subscription
+    template <typename Req, typename Res, typename Content>
+    std::shared_ptr<Res> requestResponse(const Content &content, bool mayBeUnknown = false);
     int requestResult(const PolicyKey &key, PolicyResult &result);
+    int requestCachedResult(const ClientSession &session, const PolicyKey &key, int &result);
     int requestSimpleResult(const PolicyKey &key, PolicyResult &result);
 };
 
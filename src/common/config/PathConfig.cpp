@@ -79,6 +79,7 @@ const std::string lockFile(statePath);
 const std::string indexFilename("buckets");
 const std::string guardFilename("guard");
 const std::string checksumFilename("checksum");
+const std::string walFilename("wal");
 const std::string backupFilenameSuffix("~");
 const std::string bucketFilenamePrefix("_");
 const char fieldSeparator(';');
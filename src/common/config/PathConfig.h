@@ -47,6 +47,7 @@ extern const std::string lockFile;
 extern const std::string indexFilename;
 extern const std::string guardFilename;
 extern const std::string checksumFilename;
+extern const std::string walFilename;
 extern const std::string backupFilenameSuffix;
 extern const std::string bucketFilenamePrefix;
 extern const char fieldSeparator;
@@ -33,16 +33,50 @@
 #include "BinaryQueue.h"
 
 namespace Cynara {
-BinaryQueue::BinaryQueue() : m_size(0) {
+
+namespace {
+
+const size_t CHUNK_SIZE = 1024;
+const size_t MAX_POOLED_CHUNKS = 256;
+const size_t MIN_RING_SIZE = 8;
+
+// Set, when pool of thread is destroyed, so chunks released later are freed directly
+thread_local bool chunkPoolDestroyed = false;
+
+struct ChunkPool {
+    std::vector<void *> m_free;
+
+    ~ChunkPool() {
+        for (auto chunk : m_free)
+            free(chunk);
+        chunkPoolDestroyed = true;
+    }
+};
+
+thread_local ChunkPool chunkPool;
+
+} // namespace anonymous
+
+struct BinaryQueue::Chunk {
+    size_t refs;
+    size_t used;
+    char data[CHUNK_SIZE];
+};
+
+BinaryQueue::BinaryQueue() : m_head(0), m_count(0), m_size(0), m_tail(nullptr) {
 }
 
-BinaryQueue::BinaryQueue(const BinaryQueue &other) : m_size(0) {
+BinaryQueue::BinaryQueue(const BinaryQueue &other)
+    : m_head(0), m_count(0), m_size(0), m_tail(nullptr) {
     appendCopyFrom(other);
 }
 
 BinaryQueue::~BinaryQueue() {
     // Remove all remaining buckets
     clear();
+    releaseReserved();
+    if (m_tail != nullptr)
+        releaseChunk(m_tail);
 }
 
 const BinaryQueue &BinaryQueue::operator=(const BinaryQueue &other) {
@@ -55,32 +89,31 @@ const BinaryQueue &BinaryQueue::operator=(const BinaryQueue &other) {
 }
 
 void BinaryQueue::appendCopyFrom(const BinaryQueue &other) {
-    // To speed things up, always copy as one bucket
-    void *bufferCopy = malloc(other.m_size);
-
-    if (bufferCopy == nullptr) {
-        throw std::bad_alloc();
-    }
-
-    try {
-        other.flatten(bufferCopy, other.m_size);
-        appendUnmanaged(bufferCopy, other.m_size, &bufferDeleterFree, nullptr);
-    } catch (const std::bad_alloc &) {
-        // Free allocated memory
-        free(bufferCopy);
-        throw;
+    // Copy is kept as contiguous as chunks allow
+    for (size_t i = 0; i < other.m_count; ++i) {
+        const Bucket &otherBucket = other.bucket(i);
+        copyToChunks(otherBucket.ptr, otherBucket.left, i > 0);
     }
 }
 
 void BinaryQueue::appendMoveFrom(BinaryQueue &other) {
-    // Copy all buckets
-    std::copy(other.m_buckets.begin(),
-              other.m_buckets.end(), std::back_inserter(m_buckets));
+    if (this == &other || other.m_count == 0)
+        return;
+
+    ensureRingSpace(other.m_count);
+
+    // Move all buckets, chunk references are moved together with them
+    for (size_t i = 0; i < other.m_count; ++i)
+        pushBucket(other.bucket(i));
+    size_t previousSize = m_size;
     m_size += other.m_size;
 
     // Clear other, but do not free memory
-    other.m_buckets.clear();
+    other.m_head = 0;
+    other.m_count = 0;
     other.m_size = 0;
+
+    notifyNotEmpty(previousSize);
 }
 
 void BinaryQueue::appendCopyTo(BinaryQueue &other) const {
@@ -92,31 +125,18 @@ void BinaryQueue::appendMoveTo(BinaryQueue &other) {
 }
 
 void BinaryQueue::clear() {
-    std::for_each(m_buckets.begin(), m_buckets.end(), &deleteBucket);
-    m_buckets.clear();
+    while (m_count > 0)
+        popBucket();
+    m_head = 0;
     m_size = 0;
 }
 
 void BinaryQueue::appendCopy(const void* buffer, size_t bufferSize) {
-    // Create data copy with malloc/free
-    void *bufferCopy = malloc(bufferSize);
-
-    // Check if allocation succeded
-    if (bufferCopy == nullptr) {
-        throw std::bad_alloc();
-    }
-
-    // Copy user data
-    memcpy(bufferCopy, buffer, bufferSize);
+    copyToChunks(buffer, bufferSize, false);
+}
 
-    try {
-        // Try to append new bucket
-        appendUnmanaged(bufferCopy, bufferSize, &bufferDeleterFree, nullptr);
-    } catch (const std::bad_alloc &) {
-        // Free allocated memory
-        free(bufferCopy);
-        throw;
-    }
+void BinaryQueue::append(const void* buffer, size_t bufferSize) {
+    copyToChunks(buffer, bufferSize, true);
 }
 
 void BinaryQueue::appendUnmanaged(const void* buffer,
@@ -129,17 +149,41 @@ void BinaryQueue::appendUnmanaged(const void* buffer,
         return;
     }
 
+    if (buffer == nullptr)
+        throw NullPointerException("data");
+
+    if (deleter == nullptr)
+        throw NullPointerException("dataDeleter");
+
     // Just add new bucket with selected deleter
-    Bucket *bucket = new Bucket(buffer, bufferSize, deleter, userParam);
-    try {
-        m_buckets.push_back(bucket);
-    } catch (const std::bad_alloc &) {
-        delete bucket;
-        throw;
-    }
+    ensureRingSpace(1);
+    pushBucket({buffer, buffer, bufferSize, bufferSize, deleter, userParam});
 
     // Increase total queue size
+    size_t previousSize = m_size;
     m_size += bufferSize;
+
+    notifyNotEmpty(previousSize);
+}
+
+void *BinaryQueue::reserve(size_t &available) {
+    // Chunk referenced only by queue tail holds no data anymore and can be reused
+    if (m_tail != nullptr && m_tail->refs == 1)
+        m_tail->used = 0;
+
+    if (m_tail == nullptr || m_tail->used == CHUNK_SIZE) {
+        Chunk *chunk = allocateChunk();
+        if (m_tail != nullptr)
+            releaseChunk(m_tail);
+        m_tail = chunk;
+    }
+
+    available = CHUNK_SIZE - m_tail->used;
+    return m_tail->data + m_tail->used;
+}
+
+void BinaryQueue::commit(size_t size) {
+    appendChunkData(size, true);
 }
 
 size_t BinaryQueue::size() const {
@@ -160,19 +204,17 @@ void BinaryQueue::consume(size_t size) {
 
     // Consume data and/or remove buckets
     while (bytesLeft > 0) {
+        Bucket &front = bucket(0);
         // Get consume size
-        size_t count = std::min(bytesLeft, m_buckets.front()->left);
+        size_t count = std::min(bytesLeft, front.left);
 
-        m_buckets.front()->ptr =
-            static_cast<const char *>(m_buckets.front()->ptr) + count;
-        m_buckets.front()->left -= count;
+        front.ptr = static_cast<const char *>(front.ptr) + count;
+        front.left -= count;
         bytesLeft -= count;
         m_size -= count;
 
-        if (m_buckets.front()->left == 0) {
-            deleteBucket(m_buckets.front());
-            m_buckets.pop_front();
-        }
+        if (front.left == 0)
+            popBucket();
     }
 }
 
@@ -187,65 +229,245 @@ void BinaryQueue::flatten(void *buffer, size_t bufferSize) const {
     }
 
     size_t bytesLeft = bufferSize;
-    void *ptr = buffer;
-    BucketList::const_iterator bucketIterator = m_buckets.begin();
+    char *ptr = static_cast<char *>(buffer);
 
     // Flatten data
-    while (bytesLeft > 0) {
-        // Get consume size
-        // todo a check is needed if bucketIterator doesn't point to m_buckets.end()
-        size_t count = std::min(bytesLeft, (*bucketIterator)->left);
+    for (size_t i = 0; bytesLeft > 0; ++i) {
+        const Bucket &current = bucket(i);
+        size_t count = std::min(bytesLeft, current.left);
 
         // Copy data to user pointer
-        memcpy(ptr, (*bucketIterator)->ptr, count);
+        memcpy(ptr, current.ptr, count);
 
         // Update flattened bytes count
         bytesLeft -= count;
-        ptr = static_cast<char *>(ptr) + count;
-
-        // Take next bucket
-        ++bucketIterator;
+        ptr += count;
     }
 }
 
 void BinaryQueue::flattenConsume(void *buffer, size_t bufferSize) {
-    // FIXME: Optimize
-    flatten(buffer, bufferSize);
-    consume(bufferSize);
+    // Check parameters
+    if (bufferSize > m_size) {
+        throw OutOfDataException(m_size, bufferSize);
+    }
+
+    size_t bytesLeft = bufferSize;
+    char *ptr = static_cast<char *>(buffer);
+
+    // Copy and consume data in a single pass over buckets
+    while (bytesLeft > 0) {
+        Bucket &front = bucket(0);
+        size_t count = std::min(bytesLeft, front.left);
+
+        memcpy(ptr, front.ptr, count);
+        ptr += count;
+
+        front.ptr = static_cast<const char *>(front.ptr) + count;
+        front.left -= count;
+        bytesLeft -= count;
+        m_size -= count;
+
+        if (front.left == 0)
+            popBucket();
+    }
 }
 
-void BinaryQueue::deleteBucket(BinaryQueue::Bucket *bucket) {
-    delete bucket;
+size_t BinaryQueue::exportIovec(struct iovec *vector, size_t vectorSize) const {
+    size_t count = std::min(m_count, vectorSize);
+
+    for (size_t i = 0; i < count; ++i) {
+        const Bucket &current = bucket(i);
+        vector[i].iov_base = const_cast<void *>(current.ptr);
+        vector[i].iov_len = current.left;
+    }
+
+    return count;
 }
 
-void BinaryQueue::bufferDeleterFree(const void* data,
-                                    size_t dataSize UNUSED,
-                                    void* userParam UNUSED) {
-    // Default free deleter
-    free(const_cast<void *>(data));
+size_t BinaryQueue::importIovec(struct iovec *vector, size_t vectorSize) {
+    if (vectorSize == 0)
+        return 0;
+
+    releaseReserved();
+    vector[0].iov_base = reserve(vector[0].iov_len);
+
+    // Rest of space is described with fresh chunks, which become tail in turn on commit
+    for (size_t i = 1; i < vectorSize; ++i) {
+        m_reserved.push_back(nullptr);
+        m_reserved.back() = allocateChunk();
+        vector[i].iov_base = m_reserved.back()->data;
+        vector[i].iov_len = CHUNK_SIZE;
+    }
+
+    return vectorSize;
 }
 
-BinaryQueue::Bucket::Bucket(const void* data,
-                            size_t dataSize,
-                            BufferDeleter dataDeleter,
-                            void* userParam) :
-    buffer(data),
-    ptr(data),
-    size(dataSize),
-    left(dataSize),
-    deleter(dataDeleter),
-    param(userParam) {
+void BinaryQueue::commitIovec(size_t size) {
+    size_t reservedSpace = m_reserved.size() * CHUNK_SIZE;
+    if (m_tail != nullptr)
+        reservedSpace += CHUNK_SIZE - m_tail->used;
+    if (size > reservedSpace)
+        throw OutOfDataException(reservedSpace, size);
 
-    if(data == nullptr)
-        throw NullPointerException("data");
+    size_t count = (m_tail != nullptr) ? std::min(size, CHUNK_SIZE - m_tail->used) : 0;
+    appendChunkData(count, true);
+    size -= count;
 
-    if(dataDeleter == nullptr)
-        throw NullPointerException("dataDeleter");
+    for (auto &chunk : m_reserved) {
+        if (size == 0)
+            break;
+
+        releaseChunk(m_tail);
+        m_tail = chunk;
+        chunk = nullptr;
+
+        count = std::min(size, CHUNK_SIZE);
+        appendChunkData(count, true);
+        size -= count;
+    }
+
+    releaseReserved();
+}
+
+void BinaryQueue::setNotEmptyCallback(const NotEmptyCallback &callback) {
+    m_notEmptyCallback = callback;
+}
+
+void BinaryQueue::ensureRingSpace(size_t count) {
+    if (m_count + count <= m_ring.size())
+        return;
+
+    size_t ringSize = std::max(m_ring.size(), MIN_RING_SIZE);
+    while (ringSize < m_count + count)
+        ringSize *= 2;
+
+    // Buckets are laid out again from beginning of new ring
+    std::vector<Bucket> ring(ringSize);
+    for (size_t i = 0; i < m_count; ++i)
+        ring[i] = bucket(i);
+
+    m_ring.swap(ring);
+    m_head = 0;
 }
 
-BinaryQueue::Bucket::~Bucket() {
-    // Invoke deleter on bucket data
-    deleter(buffer, size, param);
+void BinaryQueue::pushBucket(const Bucket &newBucket) {
+    // Ring space must be ensured by caller
+    m_ring[(m_head + m_count) & (m_ring.size() - 1)] = newBucket;
+    ++m_count;
+}
+
+void BinaryQueue::popBucket(void) {
+    Bucket &front = bucket(0);
+    front.deleter(front.buffer, front.size, front.param);
+
+    m_head = (m_head + 1) & (m_ring.size() - 1);
+    --m_count;
+}
+
+void BinaryQueue::appendChunkData(size_t size, bool extendLast) {
+    if (size == 0)
+        return;
+
+    size_t available = (m_tail != nullptr) ? CHUNK_SIZE - m_tail->used : 0;
+    if (size > available)
+        throw OutOfDataException(available, size);
+
+    const char *data = m_tail->data + m_tail->used;
+    size_t previousSize = m_size;
+
+    if (extendLast && m_count > 0) {
+        Bucket &last = bucket(m_count - 1);
+        if (last.deleter == &chunkDeleter && last.param == m_tail
+            && static_cast<const char *>(last.ptr) + last.left == data) {
+            last.size += size;
+            last.left += size;
+            m_tail->used += size;
+            m_size += size;
+            notifyNotEmpty(previousSize);
+            return;
+        }
+    }
+
+    ensureRingSpace(1);
+    pushBucket({data, data, size, size, &chunkDeleter, m_tail});
+    ++m_tail->refs;
+    m_tail->used += size;
+    m_size += size;
+    notifyNotEmpty(previousSize);
+}
+
+void BinaryQueue::copyToChunks(const void *buffer, size_t bufferSize, bool extendLast) {
+    const char *ptr = static_cast<const char *>(buffer);
+
+    while (bufferSize > 0) {
+        size_t available;
+        void *space = reserve(available);
+        size_t count = std::min(bufferSize, available);
+
+        memcpy(space, ptr, count);
+        appendChunkData(count, extendLast);
+
+        // Data not fitting in one chunk still form one logical append
+        extendLast = true;
+        ptr += count;
+        bufferSize -= count;
+    }
+}
+
+void BinaryQueue::releaseReserved(void) {
+    for (auto chunk : m_reserved) {
+        if (chunk != nullptr)
+            releaseChunk(chunk);
+    }
+    m_reserved.clear();
+}
+
+BinaryQueue::Chunk *BinaryQueue::allocateChunk(void) {
+    void *memory;
+    if (!chunkPoolDestroyed && !chunkPool.m_free.empty()) {
+        memory = chunkPool.m_free.back();
+        chunkPool.m_free.pop_back();
+    } else {
+        memory = malloc(sizeof(Chunk));
+        if (memory == nullptr)
+            throw std::bad_alloc();
+    }
+
+    Chunk *chunk = static_cast<Chunk *>(memory);
+    chunk->refs = 1;
+    chunk->used = 0;
+    return chunk;
+}
+
+void BinaryQueue::releaseChunk(Chunk *chunk) {
+    if (--chunk->refs > 0)
+        return;
+
+    if (!chunkPoolDestroyed && chunkPool.m_free.size() < MAX_POOLED_CHUNKS) {
+        try {
+            chunkPool.m_free.push_back(chunk);
+            return;
+        } catch (const std::bad_alloc &) {
+        }
+    }
+    free(chunk);
+}
+
+void BinaryQueue::chunkDeleter(const void *buffer UNUSED, size_t bufferSize UNUSED,
+                               void *userParam) {
+    releaseChunk(static_cast<Chunk *>(userParam));
+}
+
+void BinaryQueue::notifyNotEmpty(size_t previousSize) {
+    if (previousSize == 0 && m_size > 0 && m_notEmptyCallback)
+        m_notEmptyCallback();
+}
+
+void BinaryQueue::bufferDeleterFree(const void* data,
+                                    size_t dataSize UNUSED,
+                                    void* userParam UNUSED) {
+    // Default free deleter
+    free(const_cast<void *>(data));
 }
 
 } // namespace Cynara
@@ -24,8 +24,11 @@
 #ifndef SRC_COMMON_CONTAINERS_BINARYQUEUE_H_
 #define SRC_COMMON_CONTAINERS_BINARYQUEUE_H_
 
+#include <cstddef>
+#include <functional>
 #include <memory>
-#include <list>
+#include <sys/uio.h>
+#include <vector>
 
 namespace Cynara {
 /**
@@ -36,9 +39,10 @@ typedef std::shared_ptr<BinaryQueue> BinaryQueuePtr;
 typedef std::weak_ptr<BinaryQueue> BinaryQueueWeakPtr;
 
 /**
- * Binary stream implemented as constant size bucket list
- *
- * @todo Add optimized implementation for FlattenConsume
+ * Binary stream implemented as ring of buckets. Copied data are kept in constant size
+ * chunks taken from per-thread pool, so appending and consuming data does not allocate
+ * memory in steady state. Chunks are shared by buckets pointing into them and are not
+ * meant to be passed between threads.
  */
 class BinaryQueue {
 public:
@@ -47,6 +51,7 @@ public:
     static void bufferDeleterFree(const void *buffer,
                                   size_t bufferSize,
                                   void *userParam);
+    typedef std::function<void(void)> NotEmptyCallback;
     /**
      * Construct empty binary queue
      */
@@ -85,6 +90,41 @@ public:
      */
     void appendCopy(const void *buffer, size_t bufferSize);
 
+    /**
+     * Append copy of @a bufferSize bytes from memory pointed by @a buffer
+     * to the end of binary queue. Unlike appendCopy, no new bucket is started,
+     * if data fit in chunk of last bucket, so consecutive small appends are
+     * kept contiguous.
+     *
+     * @return none
+     * @param[in] buffer Pointer to buffer to copy data from
+     * @param[in] bufferSize Number of bytes to copy
+     * @exception std::bad_alloc Cannot allocate memory to hold additional data
+     */
+    void append(const void *buffer, size_t bufferSize);
+
+    /**
+     * Get contiguous free space at the end of binary queue, so data can be
+     * written there directly and then appended with commit().
+     *
+     * @return Pointer to free space
+     * @param[out] available Number of bytes available at returned pointer
+     * @exception std::bad_alloc Cannot allocate memory for free space
+     * @warning Binary queue must not be modified until commit() is called
+     */
+    void *reserve(size_t &available);
+
+    /**
+     * Append @a size bytes written to space got with reserve()
+     *
+     * @return none
+     * @param[in] size Number of written bytes
+     * @exception std::bad_alloc Cannot allocate memory to hold additional data
+     * @exception Cynara::OutOfDataException Number of bytes is larger
+     *            than reserved space
+     */
+    void commit(size_t size);
+
     /**
      * Append @a bufferSize bytes from memory pointed by @a buffer
      * to the end of binary queue. Uses custom provided deleter.
@@ -208,34 +248,95 @@ public:
      */
     void flattenConsume(void *buffer, size_t bufferSize);
 
+    /**
+     * Describe data from beginning of binary queue as an array of iovec
+     * structures pointing directly into buckets, without copying any bytes.
+     * Described data stay in binary queue until they are consumed.
+     *
+     * @return Number of filled iovec structures
+     * @param[in] vector Pointer to user array of iovec structures
+     * @param[in] vectorSize Number of structures available in @a vector
+     * @warning Pointers are valid only until binary queue is modified
+     */
+    size_t exportIovec(struct iovec *vector, size_t vectorSize) const;
+
+    /**
+     * Describe free space at the end of binary queue as an array of iovec
+     * structures, so data can be received directly into binary queue
+     * (e.g. with readv). Received data are appended with commitIovec(),
+     * which must be called also if nothing was received.
+     *
+     * @return Number of filled iovec structures
+     * @param[in] vector Pointer to user array of iovec structures
+     * @param[in] vectorSize Number of structures available in @a vector
+     * @exception std::bad_alloc Cannot allocate memory for free space
+     * @warning Binary queue must not be modified until commitIovec() is called
+     */
+    size_t importIovec(struct iovec *vector, size_t vectorSize);
+
+    /**
+     * Append @a size bytes received into space described by importIovec()
+     * and release space left unused
+     *
+     * @return none
+     * @param[in] size Number of received bytes
+     * @exception std::bad_alloc Cannot allocate memory to hold additional data
+     * @exception Cynara::OutOfDataException Number of bytes is larger
+     *            than imported space
+     */
+    void commitIovec(size_t size);
+
+    /**
+     * Set callback invoked every time data is appended to an empty binary queue.
+     * Callback is not copied together with binary queue contents.
+     *
+     * @return none
+     * @param[in] callback Function called when binary queue becomes non-empty
+     */
+    void setNotEmptyCallback(const NotEmptyCallback &callback);
+
 private:
-      struct Bucket {
-          const void *buffer;
-          const void *ptr;
-          size_t size;
-          size_t left;
-
-          BufferDeleter deleter;
-          void *param;
-
-          Bucket(const void *buffer,
-                 size_t bufferSize,
-                 BufferDeleter deleter,
-                 void *userParam);
-          ~Bucket();
-          // make it noncopyable
-          Bucket(const Bucket &) = delete;
-          const Bucket &operator=(const Bucket &) = delete;
-          // make it nonmoveable
-          Bucket(Bucket &&) = delete;
-          Bucket &operator=(Bucket &&) = delete;
-      };
-
-      typedef std::list<Bucket *> BucketList;
-      BucketList m_buckets;
-      size_t m_size;
-
-      static void deleteBucket(Bucket *bucket);
+    struct Chunk;
+
+    struct Bucket {
+        const void *buffer;
+        const void *ptr;
+        size_t size;
+        size_t left;
+
+        BufferDeleter deleter;
+        void *param;
+    };
+
+    // Ring of buckets, capacity is always a power of 2
+    std::vector<Bucket> m_ring;
+    size_t m_head;
+    size_t m_count;
+    size_t m_size;
+    // Chunk, which new data are written to, and chunks described by importIovec()
+    Chunk *m_tail;
+    std::vector<Chunk *> m_reserved;
+    NotEmptyCallback m_notEmptyCallback;
+
+    Bucket &bucket(size_t index) {
+        return m_ring[(m_head + index) & (m_ring.size() - 1)];
+    }
+
+    const Bucket &bucket(size_t index) const {
+        return m_ring[(m_head + index) & (m_ring.size() - 1)];
+    }
+
+    void ensureRingSpace(size_t count);
+    void pushBucket(const Bucket &bucket);
+    void popBucket(void);
+    void appendChunkData(size_t size, bool extendLast);
+    void copyToChunks(const void *buffer, size_t bufferSize, bool extendLast);
+    void releaseReserved(void);
+
+    static Chunk *allocateChunk(void);
+    static void releaseChunk(Chunk *chunk);
+    static void chunkDeleter(const void *buffer, size_t bufferSize, void *userParam);
+    void notifyNotEmpty(size_t previousSize);
 };
 
 } // namespace Cynara
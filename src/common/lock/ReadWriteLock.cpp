@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/common/lock/ReadWriteLock.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Classes for acquiring and holding shared (reader) and exclusive (writer) locks
+ */
+
+#include <string.h>
+
+#include <exceptions/UnexpectedErrorException.h>
+
+#include "ReadWriteLock.h"
+
+namespace Cynara {
+
+ReadWriteLock::ReadWriteLock() {
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+    // Writers (admin mutations) must not starve behind continuous stream of checks
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+
+    int ret = pthread_rwlock_init(&m_lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+    if (ret != 0)
+        throw UnexpectedErrorException(ret, strerror(ret));
+}
+
+ReadWriteLock::~ReadWriteLock() {
+    pthread_rwlock_destroy(&m_lock);
+}
+
+void ReadWriteLock::readLock(void) {
+    int ret = pthread_rwlock_rdlock(&m_lock);
+    if (ret != 0)
+        throw UnexpectedErrorException(ret, strerror(ret));
+}
+
+void ReadWriteLock::writeLock(void) {
+    int ret = pthread_rwlock_wrlock(&m_lock);
+    if (ret != 0)
+        throw UnexpectedErrorException(ret, strerror(ret));
+}
+
+void ReadWriteLock::unlock(void) {
+    pthread_rwlock_unlock(&m_lock);
+}
+
+} /* namespace Cynara */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/common/lock/ReadWriteLock.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Classes for acquiring and holding shared (reader) and exclusive (writer) locks
+ */
+
+#ifndef SRC_COMMON_LOCK_READWRITELOCK_H_
+#define SRC_COMMON_LOCK_READWRITELOCK_H_
+
+#include <pthread.h>
+
+namespace Cynara {
+
+class ReadWriteLock {
+public:
+    ReadWriteLock();
+    ~ReadWriteLock();
+
+    ReadWriteLock(const ReadWriteLock &) = delete;
+    ReadWriteLock &operator=(const ReadWriteLock &) = delete;
+
+    void readLock(void);
+    void writeLock(void);
+    void unlock(void);
+
+private:
+    pthread_rwlock_t m_lock;
+};
+
+class ReadLockGuard {
+public:
+    explicit ReadLockGuard(ReadWriteLock &lock) : m_lock(lock) {
+        m_lock.readLock();
+    }
+
+    ~ReadLockGuard() {
+        m_lock.unlock();
+    }
+
+private:
+    ReadWriteLock &m_lock;
+};
+
+class WriteLockGuard {
+public:
+    explicit WriteLockGuard(ReadWriteLock &lock) : m_lock(lock) {
+        m_lock.writeLock();
+    }
+
+    ~WriteLockGuard() {
+        m_lock.unlock();
+    }
+
+private:
+    ReadWriteLock &m_lock;
+};
+
+} /* namespace Cynara */
+
+#endif /* SRC_COMMON_LOCK_READWRITELOCK_H_ */
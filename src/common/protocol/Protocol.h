@@ -28,8 +28,11 @@
 #include <containers/BinaryQueue.h>
 #include <protocol/ProtocolFrameHeader.h>
 #include <request/pointers.h>
+#include <request/Request.h>
+#include <request/RequestContext.h>
 #include <request/RequestTaker.h>
 #include <response/pointers.h>
+#include <response/Response.h>
 #include <response/ResponseTaker.h>
 
 namespace Cynara {
@@ -47,6 +50,33 @@ public:
     virtual RequestPtr extractRequestFromBuffer(BinaryQueuePtr bufferQueue) = 0;
     virtual ResponsePtr extractResponseFromBuffer(BinaryQueuePtr bufferQueue) = 0;
 
+    /*
+     * Passes response extracted from buffer to taker. Returns false, if no complete response
+     * was available. Protocols can override it to build response on stack instead of heap.
+     */
+    virtual bool dispatchResponseFromBuffer(BinaryQueuePtr bufferQueue, ResponseTaker &taker) {
+        ResponsePtr response = extractResponseFromBuffer(bufferQueue);
+        if (!response)
+            return false;
+
+        response->execute(taker, RequestContext(ResponseTakerPtr(), BinaryQueuePtr()));
+        return true;
+    }
+
+    /*
+     * Passes request extracted from buffer to taker. Returns false, if no complete request
+     * was available. Protocols can override it to build request on stack instead of heap.
+     */
+    virtual bool dispatchRequestFromBuffer(BinaryQueuePtr bufferQueue, RequestTaker &taker,
+                                           const RequestContext &context) {
+        RequestPtr request = extractRequestFromBuffer(bufferQueue);
+        if (!request)
+            return false;
+
+        request->execute(taker, context);
+        return true;
+    }
+
     using RequestTaker::execute;
     using ResponseTaker::execute;
 
@@ -148,7 +148,6 @@ RequestPtr ProtocolAdmin::deserializeRemoveBucketRequest(void) {
 RequestPtr ProtocolAdmin::deserializeSetPoliciesRequest(void) {
     ProtocolFrameFieldsCount toBeInsertedOrUpdatedCount, toBeRemovedCount;
     ProtocolFrameFieldsCount policyCount;
-    PolicyKeyFeature::ValueType clientId, user, privilege;
     PolicyType policyType;
     PolicyResult::PolicyMetadata metadata;
     std::map<PolicyBucketId, std::vector<Policy>> toBeInsertedOrUpdatedPolicies;
@@ -160,17 +159,13 @@ RequestPtr ProtocolAdmin::deserializeSetPoliciesRequest(void) {
         ProtocolDeserialization::deserialize(m_frameHeader, policyBucketId);
         ProtocolDeserialization::deserialize(m_frameHeader, policyCount);
         for (ProtocolFrameFieldsCount p = 0; p < policyCount; ++p) {
-            // PolicyKey
-            ProtocolDeserialization::deserialize(m_frameHeader, clientId);
-            ProtocolDeserialization::deserialize(m_frameHeader, user);
-            ProtocolDeserialization::deserialize(m_frameHeader, privilege);
+            PolicyKey key = ProtocolDeserialization::deserializePolicyKey(m_frameHeader);
             // PolicyResult
             ProtocolDeserialization::deserialize(m_frameHeader, policyType);
             ProtocolDeserialization::deserialize(m_frameHeader, metadata);
 
             toBeInsertedOrUpdatedPolicies[policyBucketId].push_back(
-                    Policy(PolicyKey(clientId, user, privilege),
-                    PolicyResult(policyType, metadata)));
+                    Policy(key, PolicyResult(policyType, metadata)));
         }
     }
 
@@ -180,12 +175,8 @@ RequestPtr ProtocolAdmin::deserializeSetPoliciesRequest(void) {
         ProtocolDeserialization::deserialize(m_frameHeader, policyBucketId);
         ProtocolDeserialization::deserialize(m_frameHeader, policyCount);
         for (ProtocolFrameFieldsCount p = 0; p < policyCount; ++p) {
-            // PolicyKey
-            ProtocolDeserialization::deserialize(m_frameHeader, clientId);
-            ProtocolDeserialization::deserialize(m_frameHeader, user);
-            ProtocolDeserialization::deserialize(m_frameHeader, privilege);
-
-            toBeRemovedPolicies[policyBucketId].push_back(PolicyKey(clientId, user, privilege));
+            toBeRemovedPolicies[policyBucketId].push_back(
+                    ProtocolDeserialization::deserializePolicyKey(m_frameHeader));
         }
     }
 
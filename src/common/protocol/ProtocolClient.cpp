@@ -24,8 +24,11 @@
 
 #include <cinttypes>
 #include <memory>
+#include <vector>
 
+#include <attributes/attributes.h>
 #include <common.h>
+#include <cynara-limits.h>
 #include <exceptions/InvalidProtocolException.h>
 #include <exceptions/OutOfDataException.h>
 #include <log/log.h>
@@ -33,20 +36,107 @@
 #include <protocol/ProtocolOpCode.h>
 #include <protocol/ProtocolSerialization.h>
 #include <request/CancelRequest.h>
+#include <request/CheckBatchRequest.h>
 #include <request/CheckRequest.h>
+#include <request/InvalidationSubscribeRequest.h>
 #include <request/RequestContext.h>
 #include <request/SimpleCheckRequest.h>
 #include <response/CancelResponse.h>
+#include <response/CheckBatchResponse.h>
 #include <response/CheckResponse.h>
+#include <response/InvalidateCacheResponse.h>
 #include <response/SimpleCheckResponse.h>
 #include <types/PolicyKey.h>
 #include <types/PolicyResult.h>
 #include <types/PolicyType.h>
+#include <types/ProtocolFields.h>
 
 #include "ProtocolClient.h"
 
 namespace Cynara {
 
+namespace {
+
+// Responses dispatched on client side and requests kept by holder are not answered,
+// so they need no context
+RequestContext emptyContext(void) {
+    return RequestContext(ResponseTakerPtr(), BinaryQueuePtr());
+}
+
+// Keeps copy of dispatched response for callers expecting it on heap
+class ResponseHolder : public ResponseTaker {
+public:
+    using ResponseTaker::execute;
+
+    virtual void execute(const RequestContext &context UNUSED, const CancelResponse &response) {
+        m_response = std::make_shared<CancelResponse>(response);
+    }
+
+    virtual void execute(const RequestContext &context UNUSED,
+                         const CheckBatchResponse &response) {
+        m_response = std::make_shared<CheckBatchResponse>(response);
+    }
+
+    virtual void execute(const RequestContext &context UNUSED, const CheckResponse &response) {
+        m_response = std::make_shared<CheckResponse>(response);
+    }
+
+    virtual void execute(const RequestContext &context UNUSED,
+                         const InvalidateCacheResponse &response) {
+        m_response = std::make_shared<InvalidateCacheResponse>(response);
+    }
+
+    virtual void execute(const RequestContext &context UNUSED,
+                         const SimpleCheckResponse &response) {
+        m_response = std::make_shared<SimpleCheckResponse>(response);
+    }
+
+    ResponsePtr response(void) const {
+        return m_response;
+    }
+
+private:
+    ResponsePtr m_response;
+};
+
+// Keeps copy of dispatched request for callers expecting it on heap
+class RequestHolder : public RequestTaker {
+public:
+    using RequestTaker::execute;
+
+    virtual void execute(const RequestContext &context UNUSED, const CancelRequest &request) {
+        m_request = std::make_shared<CancelRequest>(request);
+    }
+
+    virtual void execute(const RequestContext &context UNUSED,
+                         const CheckBatchRequest &request) {
+        m_request = std::make_shared<CheckBatchRequest>(request);
+    }
+
+    virtual void execute(const RequestContext &context UNUSED, const CheckRequest &request) {
+        m_request = std::make_shared<CheckRequest>(request);
+    }
+
+    virtual void execute(const RequestContext &context UNUSED,
+                         const InvalidationSubscribeRequest &request) {
+        m_request = std::make_shared<InvalidationSubscribeRequest>(request);
+    }
+
+    virtual void execute(const RequestContext &context UNUSED,
+                         const SimpleCheckRequest &request) {
+        m_request = std::make_shared<SimpleCheckRequest>(request);
+    }
+
+    RequestPtr request(void) const {
+        return m_request;
+    }
+
+private:
+    RequestPtr m_request;
+};
+
+} // namespace anonymous
+
 ProtocolClient::ProtocolClient() {
 }
 
@@ -57,40 +147,68 @@ ProtocolPtr ProtocolClient::clone(void) {
     return std::make_shared<ProtocolClient>();
 }
 
-RequestPtr ProtocolClient::deserializeCancelRequest(void) {
+void ProtocolClient::deserializeCancelRequest(RequestTaker &taker,
+                                              const RequestContext &context) {
     LOGD("Deserialized CancelRequest");
-    return std::make_shared<CancelRequest>(m_frameHeader.sequenceNumber());
+    taker.execute(context, CancelRequest(m_frameHeader.sequenceNumber()));
 }
 
-RequestPtr ProtocolClient::deserializeCheckRequest(void) {
-    std::string clientId, userId, privilegeId;
+void ProtocolClient::deserializeCheckBatchRequest(RequestTaker &taker,
+                                                  const RequestContext &context) {
+    ProtocolFrameFieldsCount keysCount;
+    std::vector<PolicyKey> keys;
+
+    ProtocolDeserialization::deserialize(m_frameHeader, keysCount);
+    if (keysCount > CYNARA_MAX_VECTOR_SIZE)
+        throw InvalidProtocolException(InvalidProtocolException::IdentifierTooLong);
+    keys.reserve(keysCount);
+
+    for (ProtocolFrameFieldsCount k = 0; k < keysCount; ++k) {
+        keys.push_back(ProtocolDeserialization::deserializeTransientPolicyKey(m_frameHeader));
+    }
+
+    LOGD("Deserialized CheckBatchRequest: number of keys [%" PRIu16 "]", keysCount);
+
+    taker.execute(context, CheckBatchRequest(std::move(keys), m_frameHeader.sequenceNumber()));
+}
 
-    ProtocolDeserialization::deserialize(m_frameHeader, clientId);
-    ProtocolDeserialization::deserialize(m_frameHeader, userId);
-    ProtocolDeserialization::deserialize(m_frameHeader, privilegeId);
+void ProtocolClient::deserializeCheckRequest(RequestTaker &taker,
+                                             const RequestContext &context) {
+    PolicyKey key = ProtocolDeserialization::deserializeTransientPolicyKey(m_frameHeader);
 
     LOGD("Deserialized CheckRequest: client <%s>, user <%s>, privilege <%s>",
-         clientId.c_str(), userId.c_str(), privilegeId.c_str());
+         key.client().toString().c_str(), key.user().toString().c_str(),
+         key.privilege().toString().c_str());
 
-    return std::make_shared<CheckRequest>(PolicyKey(clientId, userId, privilegeId),
-                                          m_frameHeader.sequenceNumber());
+    taker.execute(context, CheckRequest(key, m_frameHeader.sequenceNumber()));
 }
 
-RequestPtr ProtocolClient::deserializeSimpleCheckRequest(void) {
-    std::string clientId, userId, privilegeId;
+void ProtocolClient::deserializeInvalidationSubscribeRequest(RequestTaker &taker,
+                                                             const RequestContext &context) {
+    LOGD("Deserialized InvalidationSubscribeRequest");
+    taker.execute(context, InvalidationSubscribeRequest(m_frameHeader.sequenceNumber()));
+}
 
-    ProtocolDeserialization::deserialize(m_frameHeader, clientId);
-    ProtocolDeserialization::deserialize(m_frameHeader, userId);
-    ProtocolDeserialization::deserialize(m_frameHeader, privilegeId);
+void ProtocolClient::deserializeSimpleCheckRequest(RequestTaker &taker,
+                                                   const RequestContext &context) {
+    PolicyKey key = ProtocolDeserialization::deserializeTransientPolicyKey(m_frameHeader);
 
     LOGD("Deserialized SimpleCheckRequest: client <%s>, user <%s>, privilege <%s>",
-         clientId.c_str(), userId.c_str(), privilegeId.c_str());
+         key.client().toString().c_str(), key.user().toString().c_str(),
+         key.privilege().toString().c_str());
 
-    return std::make_shared<SimpleCheckRequest>(PolicyKey(clientId, userId, privilegeId),
-                                                m_frameHeader.sequenceNumber());
+    taker.execute(context, SimpleCheckRequest(key, m_frameHeader.sequenceNumber()));
 }
 
 RequestPtr ProtocolClient::extractRequestFromBuffer(BinaryQueuePtr bufferQueue) {
+    RequestHolder holder;
+    if (!dispatchRequestFromBuffer(bufferQueue, holder, emptyContext()))
+        return nullptr;
+    return holder.request();
+}
+
+bool ProtocolClient::dispatchRequestFromBuffer(BinaryQueuePtr bufferQueue, RequestTaker &taker,
+                                               const RequestContext &context) {
     ProtocolFrameSerializer::deserializeHeader(m_frameHeader, bufferQueue);
 
     if (m_frameHeader.isFrameComplete()) {
@@ -102,26 +220,61 @@ RequestPtr ProtocolClient::extractRequestFromBuffer(BinaryQueuePtr bufferQueue)
         LOGD("Deserialized opCode [%" PRIu8 "]", opCode);
         switch (opCode) {
         case OpCheckPolicyRequest:
-            return deserializeCheckRequest();
+            deserializeCheckRequest(taker, context);
+            return true;
         case OpCancelRequest:
-            return deserializeCancelRequest();
+            deserializeCancelRequest(taker, context);
+            return true;
         case OpSimpleCheckPolicyRequest:
-            return deserializeSimpleCheckRequest();
+            deserializeSimpleCheckRequest(taker, context);
+            return true;
+        case OpCheckPolicyBatchRequest:
+            deserializeCheckBatchRequest(taker, context);
+            return true;
+        case OpInvalidationSubscribeRequest:
+            deserializeInvalidationSubscribeRequest(taker, context);
+            return true;
         default:
             throw InvalidProtocolException(InvalidProtocolException::WrongOpCode);
             break;
         }
     }
 
-    return nullptr;
+    return false;
 }
 
-ResponsePtr ProtocolClient::deserializeCancelResponse(void) {
+void ProtocolClient::deserializeCancelResponse(ResponseTaker &taker) {
     LOGD("Deserialized CancelResponse");
-    return std::make_shared<CancelResponse>(m_frameHeader.sequenceNumber());
+    taker.execute(emptyContext(), CancelResponse(m_frameHeader.sequenceNumber()));
 }
 
-ResponsePtr ProtocolClient::deserializeCheckResponse(void) {
+void ProtocolClient::deserializeCheckBatchResponse(ResponseTaker &taker) {
+    ProtocolFrameFieldsCount answersCount;
+    int32_t retValue;
+    PolicyType result;
+    PolicyResult::PolicyMetadata additionalInfo;
+    CheckBatchResponse::Answers answers;
+
+    ProtocolDeserialization::deserialize(m_frameHeader, answersCount);
+    if (answersCount > CYNARA_MAX_VECTOR_SIZE)
+        throw InvalidProtocolException(InvalidProtocolException::IdentifierTooLong);
+    answers.reserve(answersCount);
+
+    for (ProtocolFrameFieldsCount a = 0; a < answersCount; ++a) {
+        ProtocolDeserialization::deserialize(m_frameHeader, retValue);
+        ProtocolDeserialization::deserialize(m_frameHeader, result);
+        ProtocolDeserialization::deserialize(m_frameHeader, additionalInfo);
+        answers.push_back(CheckBatchResponse::Answer(retValue,
+                                                     PolicyResult(result, additionalInfo)));
+    }
+
+    LOGD("Deserialized CheckBatchResponse: number of answers [%" PRIu16 "]", answersCount);
+
+    taker.execute(emptyContext(),
+                  CheckBatchResponse(std::move(answers), m_frameHeader.sequenceNumber()));
+}
+
+void ProtocolClient::deserializeCheckResponse(ResponseTaker &taker) {
     PolicyType result;
     PolicyResult::PolicyMetadata additionalInfo;
 
@@ -133,10 +286,15 @@ ResponsePtr ProtocolClient::deserializeCheckResponse(void) {
     LOGD("Deserialized CheckResponse: result [%" PRIu16 "], metadata <%s>",
          policyResult.policyType(), policyResult.metadata().c_str());
 
-    return std::make_shared<CheckResponse>(policyResult, m_frameHeader.sequenceNumber());
+    taker.execute(emptyContext(), CheckResponse(policyResult, m_frameHeader.sequenceNumber()));
+}
+
+void ProtocolClient::deserializeInvalidateCacheResponse(ResponseTaker &taker) {
+    LOGD("Deserialized InvalidateCacheResponse");
+    taker.execute(emptyContext(), InvalidateCacheResponse(m_frameHeader.sequenceNumber()));
 }
 
-ResponsePtr ProtocolClient::deserializeSimpleCheckResponse() {
+void ProtocolClient::deserializeSimpleCheckResponse(ResponseTaker &taker) {
     int32_t retValue;
     PolicyType result;
     PolicyResult::PolicyMetadata additionalInfo;
@@ -150,11 +308,19 @@ ResponsePtr ProtocolClient::deserializeSimpleCheckResponse() {
     LOGD("Deserialized SimpleCheckResponse: retVal [%" PRIi32 "%] result [%" PRIu16 "],"
          " metadata <%s>", retValue, policyResult.policyType(), policyResult.metadata().c_str());
 
-    return std::make_shared<SimpleCheckResponse>(retValue, policyResult,
-                                                 m_frameHeader.sequenceNumber());
+    taker.execute(emptyContext(),
+                  SimpleCheckResponse(retValue, policyResult, m_frameHeader.sequenceNumber()));
 }
 
 ResponsePtr ProtocolClient::extractResponseFromBuffer(BinaryQueuePtr bufferQueue) {
+    ResponseHolder holder;
+    if (!dispatchResponseFromBuffer(bufferQueue, holder))
+        return nullptr;
+    return holder.response();
+}
+
+bool ProtocolClient::dispatchResponseFromBuffer(BinaryQueuePtr bufferQueue,
+                                                ResponseTaker &taker) {
     ProtocolFrameSerializer::deserializeHeader(m_frameHeader, bufferQueue);
 
     if (m_frameHeader.isFrameComplete()) {
@@ -165,18 +331,27 @@ ResponsePtr ProtocolClient::extractResponseFromBuffer(BinaryQueuePtr bufferQueue
         LOGD("Deserialized opCode [%" PRIu8 "]", opCode);
         switch (opCode) {
         case OpCheckPolicyResponse:
-            return deserializeCheckResponse();
+            deserializeCheckResponse(taker);
+            return true;
         case OpCancelResponse:
-            return deserializeCancelResponse();
+            deserializeCancelResponse(taker);
+            return true;
         case OpSimpleCheckPolicyResponse:
-            return deserializeSimpleCheckResponse();
+            deserializeSimpleCheckResponse(taker);
+            return true;
+        case OpCheckPolicyBatchResponse:
+            deserializeCheckBatchResponse(taker);
+            return true;
+        case OpInvalidateCacheResponse:
+            deserializeInvalidateCacheResponse(taker);
+            return true;
         default:
             throw InvalidProtocolException(InvalidProtocolException::WrongOpCode);
             break;
         }
     }
 
-    return nullptr;
+    return false;
 }
 
 void ProtocolClient::execute(const RequestContext &context, const CancelRequest &request) {
@@ -189,6 +364,29 @@ void ProtocolClient::execute(const RequestContext &context, const CancelRequest
     ProtocolFrameSerializer::finishSerialization(frame, *(context.responseQueue()));
 }
 
+void ProtocolClient::execute(const RequestContext &context, const CheckBatchRequest &request) {
+    if (request.keys().size() > CYNARA_MAX_VECTOR_SIZE)
+        throw InvalidProtocolException(InvalidProtocolException::IdentifierTooLong);
+
+    ProtocolFrameFieldsCount keysCount
+        = static_cast<ProtocolFrameFieldsCount>(request.keys().size());
+
+    LOGD("Serializing CheckBatchRequest: op [%" PRIu8 "], number of keys [%" PRIu16 "]",
+         OpCheckPolicyBatchRequest, keysCount);
+
+    ProtocolFrame frame = ProtocolFrameSerializer::startSerialization(request.sequenceNumber());
+
+    ProtocolSerialization::serialize(frame, OpCheckPolicyBatchRequest);
+    ProtocolSerialization::serialize(frame, keysCount);
+    for (const auto &key : request.keys()) {
+        ProtocolSerialization::serialize(frame, key.client().value());
+        ProtocolSerialization::serialize(frame, key.user().value());
+        ProtocolSerialization::serialize(frame, key.privilege().value());
+    }
+
+    ProtocolFrameSerializer::finishSerialization(frame, *(context.responseQueue()));
+}
+
 void ProtocolClient::execute(const RequestContext &context, const CheckRequest &request) {
     ProtocolFrame frame = ProtocolFrameSerializer::startSerialization(request.sequenceNumber());
 
@@ -204,6 +402,18 @@ void ProtocolClient::execute(const RequestContext &context, const CheckRequest &
     ProtocolFrameSerializer::finishSerialization(frame, *(context.responseQueue()));
 }
 
+void ProtocolClient::execute(const RequestContext &context,
+                             const InvalidationSubscribeRequest &request) {
+    ProtocolFrame frame = ProtocolFrameSerializer::startSerialization(request.sequenceNumber());
+
+    LOGD("Serializing InvalidationSubscribeRequest op [%" PRIu8 "]",
+         OpInvalidationSubscribeRequest);
+
+    ProtocolSerialization::serialize(frame, OpInvalidationSubscribeRequest);
+
+    ProtocolFrameSerializer::finishSerialization(frame, *(context.responseQueue()));
+}
+
 void ProtocolClient::execute(const RequestContext &context, const SimpleCheckRequest &request) {
     ProtocolFrame frame = ProtocolFrameSerializer::startSerialization(request.sequenceNumber());
 
@@ -230,6 +440,30 @@ void ProtocolClient::execute(const RequestContext &context, const CancelResponse
     ProtocolFrameSerializer::finishSerialization(frame, *(context.responseQueue()));
 }
 
+void ProtocolClient::execute(const RequestContext &context, const CheckBatchResponse &response) {
+    if (response.answers().size() > CYNARA_MAX_VECTOR_SIZE)
+        throw InvalidProtocolException(InvalidProtocolException::IdentifierTooLong);
+
+    ProtocolFrameFieldsCount answersCount
+        = static_cast<ProtocolFrameFieldsCount>(response.answers().size());
+
+    LOGD("Serializing CheckBatchResponse: op [%" PRIu8 "], number of answers [%" PRIu16 "]",
+         OpCheckPolicyBatchResponse, answersCount);
+
+    ProtocolFrame frame = ProtocolFrameSerializer::startSerialization(
+            response.sequenceNumber());
+
+    ProtocolSerialization::serialize(frame, OpCheckPolicyBatchResponse);
+    ProtocolSerialization::serialize(frame, answersCount);
+    for (const auto &answer : response.answers()) {
+        ProtocolSerialization::serialize(frame, answer.m_retValue);
+        ProtocolSerialization::serialize(frame, answer.m_result.policyType());
+        ProtocolSerialization::serialize(frame, answer.m_result.metadata());
+    }
+
+    ProtocolFrameSerializer::finishSerialization(frame, *(context.responseQueue()));
+}
+
 void ProtocolClient::execute(const RequestContext &context, const CheckResponse &response) {
     ProtocolFrame frame = ProtocolFrameSerializer::startSerialization(
             response.sequenceNumber());
@@ -245,6 +479,18 @@ void ProtocolClient::execute(const RequestContext &context, const CheckResponse
     ProtocolFrameSerializer::finishSerialization(frame, *(context.responseQueue()));
 }
 
+void ProtocolClient::execute(const RequestContext &context,
+                             const InvalidateCacheResponse &response) {
+    ProtocolFrame frame = ProtocolFrameSerializer::startSerialization(
+            response.sequenceNumber());
+
+    LOGD("Serializing InvalidateCacheResponse: op [%" PRIu8 "]", OpInvalidateCacheResponse);
+
+    ProtocolSerialization::serialize(frame, OpInvalidateCacheResponse);
+
+    ProtocolFrameSerializer::finishSerialization(frame, *(context.responseQueue()));
+}
+
 void ProtocolClient::execute(const RequestContext &context, const SimpleCheckResponse &response) {
     ProtocolFrame frame = ProtocolFrameSerializer::startSerialization(
             response.sequenceNumber());
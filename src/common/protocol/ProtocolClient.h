@@ -39,26 +39,39 @@ public:
     virtual ProtocolPtr clone(void);
 
     virtual RequestPtr extractRequestFromBuffer(BinaryQueuePtr bufferQueue);
+    virtual bool dispatchRequestFromBuffer(BinaryQueuePtr bufferQueue, RequestTaker &taker,
+                                           const RequestContext &context);
     virtual ResponsePtr extractResponseFromBuffer(BinaryQueuePtr bufferQueue);
+    virtual bool dispatchResponseFromBuffer(BinaryQueuePtr bufferQueue, ResponseTaker &taker);
 
     using Protocol::execute;
 
     virtual void execute(const RequestContext &context, const CancelRequest &request);
+    virtual void execute(const RequestContext &context, const CheckBatchRequest &request);
     virtual void execute(const RequestContext &context, const CheckRequest &request);
+    virtual void execute(const RequestContext &context,
+                         const InvalidationSubscribeRequest &request);
     virtual void execute(const RequestContext &context, const SimpleCheckRequest &request);
 
     virtual void execute(const RequestContext &context, const CancelResponse &response);
+    virtual void execute(const RequestContext &context, const CheckBatchResponse &response);
     virtual void execute(const RequestContext &context, const CheckResponse &response);
+    virtual void execute(const RequestContext &context, const InvalidateCacheResponse &response);
     virtual void execute(const RequestContext &context, const SimpleCheckResponse &request);
 
 private:
-    RequestPtr deserializeCancelRequest(void);
-    RequestPtr deserializeCheckRequest(void);
-    RequestPtr deserializeSimpleCheckRequest(void);
+    void deserializeCancelRequest(RequestTaker &taker, const RequestContext &context);
+    void deserializeCheckBatchRequest(RequestTaker &taker, const RequestContext &context);
+    void deserializeCheckRequest(RequestTaker &taker, const RequestContext &context);
+    void deserializeInvalidationSubscribeRequest(RequestTaker &taker,
+                                                 const RequestContext &context);
+    void deserializeSimpleCheckRequest(RequestTaker &taker, const RequestContext &context);
 
-    ResponsePtr deserializeCancelResponse(void);
-    ResponsePtr deserializeCheckResponse(void);
-    ResponsePtr deserializeSimpleCheckResponse(void);
+    void deserializeCancelResponse(ResponseTaker &taker);
+    void deserializeCheckBatchResponse(ResponseTaker &taker);
+    void deserializeCheckResponse(ResponseTaker &taker);
+    void deserializeInvalidateCacheResponse(ResponseTaker &taker);
+    void deserializeSimpleCheckResponse(ResponseTaker &taker);
 };
 
 } // namespace Cynara
@@ -37,7 +37,7 @@ void ProtocolFrame::read(size_t num, void *bytes) {
 }
 
 void ProtocolFrame::write(size_t num, const void *bytes) {
-    m_frameBodyContent->appendCopy(bytes, num);
+    m_frameBodyContent->append(bytes, num);
     m_frameHeader.increaseFrameLength(num);
 }
 
@@ -25,6 +25,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <exceptions/OutOfDataException.h>
+
 #include "ProtocolFrameHeader.h"
 
 namespace Cynara {
@@ -32,16 +34,35 @@ namespace Cynara {
 const ProtocolFrameSignature ProtocolFrameHeader::m_signature = "CPv1";
 
 ProtocolFrameHeader::ProtocolFrameHeader(BinaryQueuePtr headerContent) :
-        m_frameHeaderContent(headerContent), m_frameLength(0), m_sequenceNumber(0),
-        m_headerComplete(false), m_bodyComplete(false) {
+        m_frameHeaderContent(headerContent), m_frameCursor(0), m_frameLength(0),
+        m_sequenceNumber(0), m_headerComplete(false), m_bodyComplete(false) {
 }
 
 void ProtocolFrameHeader::read(size_t num, void *bytes) {
-    m_frameHeaderContent->flattenConsume(bytes, num);
+    memcpy(bytes, view(num), num);
+}
+
+const char *ProtocolFrameHeader::view(size_t num) {
+    size_t left = m_frameData.size() - m_frameCursor;
+    if (num > left)
+        throw OutOfDataException(left, num);
+
+    // Pointer must not be null, even for empty view of empty data
+    static const char empty = '\0';
+    const char *bytes = m_frameData.empty() ? &empty : m_frameData.data() + m_frameCursor;
+    m_frameCursor += num;
+    return bytes;
+}
+
+void ProtocolFrameHeader::loadFrameData(BinaryQueue &data, size_t size) {
+    // Buffer keeps its capacity, so after first frames no allocation is needed
+    m_frameData.resize(size);
+    data.flattenConsume(m_frameData.data(), size);
+    m_frameCursor = 0;
 }
 
 void ProtocolFrameHeader::write(size_t num, const void *bytes) {
-    m_frameHeaderContent->appendCopy(bytes, num);
+    m_frameHeaderContent->append(bytes, num);
 }
 
 } /* namespace Cynara */
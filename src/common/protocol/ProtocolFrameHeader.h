@@ -26,6 +26,7 @@
 #define SRC_COMMON_PROTOCOL_PROTOCOLFRAMEHEADER_H_
 
 #include <cstddef>
+#include <vector>
 
 #include <containers/BinaryQueue.h>
 #include <protocol/ProtocolSerialization.h>
@@ -49,6 +50,7 @@ public:
     virtual ~ProtocolFrameHeader() {};
 
     virtual void read(size_t num, void *bytes);
+    virtual const char *view(size_t num);
     virtual void write(size_t num, const void *bytes);
 
     ProtocolFrameSequenceNumber sequenceNumber(void) {
@@ -74,6 +76,9 @@ public:
 
 private:
     BinaryQueuePtr m_frameHeaderContent;
+    // Received frame header or body, taken out of queue at once and decoded in place
+    std::vector<char> m_frameData;
+    size_t m_frameCursor;
     ProtocolFrameLength m_frameLength;
     ProtocolFrameSequenceNumber m_sequenceNumber;
     bool m_headerComplete;
@@ -87,13 +92,7 @@ private:
         m_frameLength += size;
     }
 
-    BinaryQueue &headerContent(void) {
-        return *m_frameHeaderContent;
-    }
-
-    void setHeaderContent(BinaryQueuePtr headerContent) {
-        m_frameHeaderContent = headerContent;
-    }
+    void loadFrameData(BinaryQueue &data, size_t size);
 
     void setHeaderComplete(void) {
         m_headerComplete = true;
@@ -22,14 +22,48 @@
  * @brief       Implementation of protocol frame (de)serializer class.
  */
 
+#include <memory>
+
+#include <containers/BinaryQueue.h>
 #include <exceptions/InvalidProtocolException.h>
 #include <exceptions/OutOfDataException.h>
 #include <log/log.h>
+#include <protocol/ProtocolSerialization.h>
 
 #include "ProtocolFrameSerializer.h"
 
 namespace Cynara {
 
+namespace {
+
+// Stream writing serialized data straight to the end of queue
+class QueueStream : public IStream {
+public:
+    explicit QueueStream(BinaryQueue &queue) : m_queue(queue) {}
+
+    virtual void read(size_t num, void *bytes) {
+        m_queue.flattenConsume(bytes, num);
+    }
+
+    virtual void write(size_t num, const void *bytes) {
+        m_queue.append(bytes, num);
+    }
+
+private:
+    BinaryQueue &m_queue;
+};
+
+// Frame body is serialized before its header is known, so it is kept aside in a queue
+// reused by all frames serialized in a thread. Its buckets are moved out on finish.
+BinaryQueuePtr frameBodyQueue(void) {
+    thread_local BinaryQueuePtr bodyQueue = std::make_shared<BinaryQueue>();
+    // Leftovers of frame, which serialization failed, are dropped
+    bodyQueue->clear();
+    return bodyQueue;
+}
+
+} // namespace anonymous
+
 void ProtocolFrameSerializer::deserializeHeader(ProtocolFrameHeader &frameHeader,
                                                 BinaryQueuePtr data) {
     if (!frameHeader.isHeaderComplete()) {
@@ -39,7 +73,7 @@ void ProtocolFrameSerializer::deserializeHeader(ProtocolFrameHeader &frameHeader
 
         LOGD("Deserializing frameHeader");
 
-        frameHeader.setHeaderContent(data);
+        frameHeader.loadFrameData(*data, ProtocolFrameHeader::frameHeaderLength());
 
         ProtocolFrameSignature signature;
         ProtocolDeserialization::deserialize(frameHeader, frameHeader.m_signature.length(),
@@ -60,7 +94,10 @@ void ProtocolFrameSerializer::deserializeHeader(ProtocolFrameHeader &frameHeader
         frameHeader.setHeaderComplete();
     }
 
-    if (data->size() >= (frameHeader.frameLength() - ProtocolFrameHeader::frameHeaderLength())) {
+    size_t bodyLength = frameHeader.frameLength() - ProtocolFrameHeader::frameHeaderLength();
+    if (!frameHeader.m_bodyComplete && data->size() >= bodyLength) {
+        // Whole body is taken out of queue at once and its fields are decoded in place
+        frameHeader.loadFrameData(*data, bodyLength);
         frameHeader.setBodyComplete();
     }
 }
@@ -68,25 +105,25 @@ void ProtocolFrameSerializer::deserializeHeader(ProtocolFrameHeader &frameHeader
 ProtocolFrame ProtocolFrameSerializer::startSerialization(ProtocolFrameSequenceNumber sequenceNumber) {
     LOGD("Serialization started");
 
-    BinaryQueuePtr headerQueue = std::make_shared<BinaryQueue>();
-    BinaryQueuePtr bodyQueue = std::make_shared<BinaryQueue>();
-    ProtocolFrameHeader header(headerQueue);
+    ProtocolFrameHeader header;
     header.setSequenceNumber(sequenceNumber);
     header.increaseFrameLength(ProtocolFrameHeader::frameHeaderLength());
-    return ProtocolFrame(header, bodyQueue);
+    return ProtocolFrame(header, frameBodyQueue());
 }
 
 void ProtocolFrameSerializer::finishSerialization(ProtocolFrame &frame, BinaryQueue &data) {
     ProtocolFrameHeader &frameHeader = frame.frameHeader();
-    ProtocolSerialization::serializeNoSize(frameHeader, ProtocolFrameHeader::m_signature);
-    ProtocolSerialization::serialize(frameHeader, frameHeader.m_frameLength);
-    ProtocolSerialization::serialize(frameHeader, frameHeader.m_sequenceNumber);
+
+    // Header is written straight to output queue and body buckets are moved after it
+    QueueStream stream(data);
+    ProtocolSerialization::serializeNoSize(stream, ProtocolFrameHeader::m_signature);
+    ProtocolSerialization::serialize(stream, frameHeader.m_frameLength);
+    ProtocolSerialization::serialize(stream, frameHeader.m_sequenceNumber);
 
     LOGD("Serialize frameHeader: signature = %s, frameLength = %d, sequenceNumber = %d",
          ProtocolFrameHeader::m_signature.c_str(), (int)frameHeader.m_frameLength,
          (int)frameHeader.m_sequenceNumber);
 
-    data.appendMoveFrom(frameHeader.headerContent());
     data.appendMoveFrom(frame.bodyContent());
 }
 
@@ -39,8 +39,12 @@ enum ProtocolOpCode : uint8_t {
     OpCancelResponse,
     OpSimpleCheckPolicyRequest,
     OpSimpleCheckPolicyResponse,
+    OpInvalidationSubscribeRequest,
+    OpInvalidateCacheResponse,
+    OpCheckPolicyBatchRequest,
+    OpCheckPolicyBatchResponse,
 
-    /** Opcodes 6 - 19 are reserved for future use */
+    /** Opcodes 10 - 19 are reserved for future use */
 
     /** Admin operations */
     OpInsertOrUpdateBucket = 20,
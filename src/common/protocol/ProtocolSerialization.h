@@ -31,9 +31,11 @@
 #include <string>
 #include <vector>
 
+#include <attributes/attributes.h>
 #include <cynara-limits.h>
 #include <exceptions/InvalidProtocolException.h>
 #include <protocol/ProtocolOpCode.h>
+#include <types/PolicyKey.h>
 
 namespace Cynara {
 // Abstract data stream buffer
@@ -42,6 +44,11 @@ public:
     virtual void read(size_t num, void *bytes) = 0;
     virtual void write(size_t num, const void *bytes) = 0;
     virtual ~IStream() {};
+
+    // Reads num bytes in place, or returns nullptr without reading, if stream cannot do it
+    virtual const char *view(size_t num UNUSED) {
+        return nullptr;
+    }
 };
 
 struct ProtocolSerialization {
@@ -181,6 +188,42 @@ struct ProtocolDeserialization {
         stream.read(length, &str[0]);
     }
 
+    // PolicyKeyFeature serialized as std::string, interned straight from stream if possible
+    static PolicyKeyFeature deserializePolicyKeyFeature(IStream &stream,
+                                                        bool transient = false) {
+        uint32_t length;
+        stream.read(sizeof(length), &length);
+        length = le32toh(length);
+        if (length > CYNARA_MAX_ID_LENGTH)
+            throw InvalidProtocolException(InvalidProtocolException::IdentifierTooLong);
+
+        const char *data = stream.view(length);
+        std::string str;
+        if (!data) {
+            str.resize(length);
+            stream.read(length, &str[0]);
+            data = str.data();
+        }
+        return transient ? PolicyKeyFeature::createTransient(data, length)
+                         : PolicyKeyFeature::create(data, length);
+    }
+
+    // PolicyKey serialized as client, user and privilege strings
+    static PolicyKey deserializePolicyKey(IStream &stream) {
+        PolicyKeyFeature client = deserializePolicyKeyFeature(stream);
+        PolicyKeyFeature user = deserializePolicyKeyFeature(stream);
+        PolicyKeyFeature privilege = deserializePolicyKeyFeature(stream);
+        return PolicyKey(client, user, privilege);
+    }
+
+    // PolicyKey of a check request; its values not known to any policy are not interned
+    static PolicyKey deserializeTransientPolicyKey(IStream &stream) {
+        PolicyKeyFeature client = deserializePolicyKeyFeature(stream, true);
+        PolicyKeyFeature user = deserializePolicyKeyFeature(stream, true);
+        PolicyKeyFeature privilege = deserializePolicyKeyFeature(stream, true);
+        return PolicyKey(client, user, privilege);
+    }
+
     // std::vector
     template<typename T>
     static void deserialize(IStream &stream, std::vector<T> &vec) {
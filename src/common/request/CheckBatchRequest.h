@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/common/request/CheckBatchRequest.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines batch check request class
+ */
+
+#ifndef SRC_COMMON_REQUEST_CHECKBATCHREQUEST_H_
+#define SRC_COMMON_REQUEST_CHECKBATCHREQUEST_H_
+
+#include <utility>
+#include <vector>
+
+#include <types/PolicyKey.h>
+
+#include <request/pointers.h>
+#include <request/Request.h>
+
+namespace Cynara {
+
+/*
+ * Carries many policy keys in a single frame. Every key is evaluated like in SimpleCheckRequest
+ * and all answers are returned together in a single CheckBatchResponse.
+ */
+class CheckBatchRequest : public Request {
+private:
+    std::vector<PolicyKey> m_keys;
+
+public:
+    CheckBatchRequest(const std::vector<PolicyKey> &keys,
+                      ProtocolFrameSequenceNumber sequenceNumber) :
+        Request(sequenceNumber), m_keys(keys) {
+    }
+
+    CheckBatchRequest(std::vector<PolicyKey> &&keys, ProtocolFrameSequenceNumber sequenceNumber) :
+        Request(sequenceNumber), m_keys(std::move(keys)) {
+    }
+
+    virtual ~CheckBatchRequest() {};
+
+    const std::vector<PolicyKey> &keys(void) const {
+        return m_keys;
+    }
+
+    virtual void execute(RequestTaker &taker, const RequestContext &context) const;
+};
+
+} // namespace Cynara
+
+#endif /* SRC_COMMON_REQUEST_CHECKBATCHREQUEST_H_ */
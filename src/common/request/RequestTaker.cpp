@@ -49,6 +49,11 @@ void RequestTaker::execute(const RequestContext &context UNUSED,
     throw NotImplementedException();
 }
 
+void RequestTaker::execute(const RequestContext &context UNUSED,
+                           const CheckBatchRequest &request UNUSED) {
+    throw NotImplementedException();
+}
+
 void RequestTaker::execute(const RequestContext &context UNUSED,
                            const CheckRequest &request UNUSED) {
     throw NotImplementedException();
@@ -69,6 +74,11 @@ void RequestTaker::execute(const RequestContext &context UNUSED,
     throw NotImplementedException();
 }
 
+void RequestTaker::execute(const RequestContext &context UNUSED,
+                           const InvalidationSubscribeRequest &request UNUSED) {
+    throw NotImplementedException();
+}
+
 void RequestTaker::execute(const RequestContext &context UNUSED,
                            const ListRequest &request UNUSED) {
     throw NotImplementedException();
@@ -37,10 +37,13 @@ public:
     virtual void execute(const RequestContext &context, const AgentActionRequest &request);
     virtual void execute(const RequestContext &context, const AgentRegisterRequest &request);
     virtual void execute(const RequestContext &context, const CancelRequest &request);
+    virtual void execute(const RequestContext &context, const CheckBatchRequest &request);
     virtual void execute(const RequestContext &context, const CheckRequest &request);
     virtual void execute(const RequestContext &context, const DescriptionListRequest &request);
     virtual void execute(const RequestContext &context, const EraseRequest &request);
     virtual void execute(const RequestContext &context, const InsertOrUpdateBucketRequest &request);
+    virtual void execute(const RequestContext &context,
+                         const InvalidationSubscribeRequest &request);
     virtual void execute(const RequestContext &context, const ListRequest &request);
     virtual void execute(const RequestContext &context, const RemoveBucketRequest &request);
     virtual void execute(const RequestContext &context, const SetPoliciesRequest &request);
@@ -40,6 +40,9 @@ typedef std::shared_ptr<AgentRegisterRequest> AgentRegisterRequestPtr;
 class CancelRequest;
 typedef std::shared_ptr<CancelRequest> CancelRequestPtr;
 
+class CheckBatchRequest;
+typedef std::shared_ptr<CheckBatchRequest> CheckBatchRequestPtr;
+
 class CheckRequest;
 typedef std::shared_ptr<CheckRequest> CheckRequestPtr;
 
@@ -52,6 +55,9 @@ typedef std::shared_ptr<EraseRequest> EraseRequestPtr;
 class InsertOrUpdateBucketRequest;
 typedef std::shared_ptr<InsertOrUpdateBucketRequest> InsertOrUpdateBucketRequestPtr;
 
+class InvalidationSubscribeRequest;
+typedef std::shared_ptr<InvalidationSubscribeRequest> InvalidationSubscribeRequestPtr;
+
 class ListRequest;
 typedef std::shared_ptr<ListRequest> ListRequestPtr;
 
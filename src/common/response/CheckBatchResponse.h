@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/common/response/CheckBatchResponse.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines response class for batch check request
+ */
+
+#ifndef SRC_COMMON_RESPONSE_CHECKBATCHRESPONSE_H_
+#define SRC_COMMON_RESPONSE_CHECKBATCHRESPONSE_H_
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+#include <types/PolicyResult.h>
+
+#include <request/pointers.h>
+#include <response/pointers.h>
+#include <response/Response.h>
+
+namespace Cynara {
+
+class CheckBatchResponse : public Response {
+public:
+    /*
+     * Answer for a single key of batch. retValue is CYNARA_API_SUCCESS, when result is final
+     * or CYNARA_API_ACCESS_NOT_RESOLVED, when key needs a full check with agents.
+     */
+    struct Answer {
+        Answer(int32_t retValue, const PolicyResult &result)
+            : m_retValue(retValue), m_result(result) {
+        }
+
+        bool operator==(const Answer &other) const {
+            return m_retValue == other.m_retValue && m_result == other.m_result;
+        }
+
+        int32_t m_retValue;
+        PolicyResult m_result;
+    };
+    typedef std::vector<Answer> Answers;
+
+    CheckBatchResponse(const Answers &answers, ProtocolFrameSequenceNumber sequenceNumber) :
+        Response(sequenceNumber), m_answers(answers) {
+    }
+
+    CheckBatchResponse(Answers &&answers, ProtocolFrameSequenceNumber sequenceNumber) :
+        Response(sequenceNumber), m_answers(std::move(answers)) {
+    }
+
+    virtual ~CheckBatchResponse() {};
+
+    const Answers &answers(void) const {
+        return m_answers;
+    }
+
+    virtual void execute(ResponseTaker &taker, const RequestContext &context) const;
+
+private:
+    const Answers m_answers;
+};
+
+} // namespace Cynara
+
+#endif /* SRC_COMMON_RESPONSE_CHECKBATCHRESPONSE_H_ */
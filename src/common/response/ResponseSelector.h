@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/common/response/ResponseSelector.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines ResponseSelector class giving typed access to responses
+ */
+
+#ifndef SRC_COMMON_RESPONSE_RESPONSESELECTOR_H_
+#define SRC_COMMON_RESPONSE_RESPONSESELECTOR_H_
+
+#include <memory>
+
+#include <attributes/attributes.h>
+#include <request/RequestContext.h>
+#include <response/pointers.h>
+#include <response/Response.h>
+#include <response/ResponseTaker.h>
+
+namespace Cynara {
+
+/*
+ * Response taker ignoring all responses. Base for takers interested in some responses only.
+ */
+class IgnoringResponseTaker : public ResponseTaker {
+public:
+    IgnoringResponseTaker() = default;
+    virtual ~IgnoringResponseTaker() {};
+
+    virtual void execute(const RequestContext &context, const AdminCheckResponse &response);
+    virtual void execute(const RequestContext &context, const AgentActionResponse &response);
+    virtual void execute(const RequestContext &context, const AgentRegisterResponse &response);
+    virtual void execute(const RequestContext &context, const CancelResponse &response);
+    virtual void execute(const RequestContext &context, const CheckBatchResponse &response);
+    virtual void execute(const RequestContext &context, const CheckResponse &response);
+    virtual void execute(const RequestContext &context, const CodeResponse &response);
+    virtual void execute(const RequestContext &context, const DescriptionListResponse &response);
+    virtual void execute(const RequestContext &context, const InvalidateCacheResponse &response);
+    virtual void execute(const RequestContext &context, const ListResponse &response);
+    virtual void execute(const RequestContext &context, const SimpleCheckResponse &response);
+};
+
+/*
+ * Selects responses of type Res with double dispatch, so no RTTI is needed
+ */
+template <typename Res>
+class ResponseSelector : public IgnoringResponseTaker {
+public:
+    ResponseSelector() : m_selected(nullptr) {}
+    virtual ~ResponseSelector() {};
+
+    using IgnoringResponseTaker::execute;
+
+    virtual void execute(const RequestContext &context UNUSED, const Res &response) {
+        m_selected = &response;
+    }
+
+    const Res *select(const Response &response) {
+        m_selected = nullptr;
+        response.execute(*this, RequestContext(ResponseTakerPtr(), BinaryQueuePtr()));
+        return m_selected;
+    }
+
+private:
+    const Res *m_selected;
+};
+
+/*
+ * Returns pointer sharing ownership with response, if it is of type Res, or nullptr
+ */
+template <typename Res>
+std::shared_ptr<Res> responseCast(const ResponsePtr &response) {
+    if (!response)
+        return nullptr;
+
+    ResponseSelector<Res> selector;
+    const Res *selected = selector.select(*response);
+    if (!selected)
+        return nullptr;
+
+    return std::shared_ptr<Res>(response, const_cast<Res *>(selected));
+}
+
+} // namespace Cynara
+
+#endif /* SRC_COMMON_RESPONSE_RESPONSESELECTOR_H_ */
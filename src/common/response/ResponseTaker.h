@@ -38,9 +38,11 @@ public:
     virtual void execute(const RequestContext &context, const AgentActionResponse &response);
     virtual void execute(const RequestContext &context, const AgentRegisterResponse &response);
     virtual void execute(const RequestContext &context, const CancelResponse &response);
+    virtual void execute(const RequestContext &context, const CheckBatchResponse &response);
     virtual void execute(const RequestContext &context, const CheckResponse &response);
     virtual void execute(const RequestContext &context, const CodeResponse &response);
     virtual void execute(const RequestContext &context, const DescriptionListResponse &response);
+    virtual void execute(const RequestContext &context, const InvalidateCacheResponse &response);
     virtual void execute(const RequestContext &context, const ListResponse &response);
     virtual void execute(const RequestContext &context, const SimpleCheckResponse &response);
 };
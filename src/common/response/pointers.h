@@ -40,6 +40,9 @@ typedef std::shared_ptr<AgentRegisterResponse> AgentRegisterResponsePtr;
 class CancelResponse;
 typedef std::shared_ptr<CancelResponse> CancelResponsePtr;
 
+class CheckBatchResponse;
+typedef std::shared_ptr<CheckBatchResponse> CheckBatchResponsePtr;
+
 class CheckResponse;
 typedef std::shared_ptr<CheckResponse> CheckResponsePtr;
 
@@ -49,6 +52,9 @@ typedef std::shared_ptr<CodeResponse> CodeResponsePtr;
 class DescriptionListResponse;
 typedef std::shared_ptr<DescriptionListResponse> DescriptionListResponsePtr;
 
+class InvalidateCacheResponse;
+typedef std::shared_ptr<InvalidateCacheResponse> InvalidateCacheResponsePtr;
+
 class ListResponse;
 typedef std::shared_ptr<ListResponse> ListResponsePtr;
 
@@ -28,6 +28,7 @@
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
 
@@ -40,6 +41,13 @@
 
 namespace Cynara {
 
+namespace {
+
+// Number of queue chunks filled by one readv
+const size_t RECEIVE_VECTOR_SIZE = 8;
+
+} // namespace anonymous
+
 Socket::Socket(const std::string &socketPath, int timeoutMiliseconds)
     : m_sock(-1), m_connectionInProgress(false), m_socketPath(socketPath),
       m_pollTimeout(timeoutMiliseconds), m_sendBufferPos(0), m_sendBufferEnd(0) {
@@ -59,15 +67,15 @@ void Socket::close(void) {
 }
 
 bool Socket::waitForSocket(int event) {
-    int ret;
+    return waitForSocket(event, event != POLLHUP ? m_pollTimeout : 0);
+}
+
+bool Socket::waitForSocket(int event, int timeoutMiliseconds) {
     pollfd desc[1];
     desc[0].fd = m_sock;
     desc[0].events = event;
 
-    if (event != POLLHUP)
-        ret = TEMP_FAILURE_RETRY(poll(desc, 1, m_pollTimeout));
-    else
-        ret = TEMP_FAILURE_RETRY(poll(desc, 1, 0));
+    int ret = TEMP_FAILURE_RETRY(poll(desc, 1, timeoutMiliseconds));
 
     if (ret == -1) {
         int err = errno;
@@ -228,6 +236,13 @@ bool Socket::isDataToSend(void) {
     return !m_sendQueue.empty() || m_sendBufferEnd != 0;
 }
 
+bool Socket::isDataToReceive(void) {
+    if (m_sock < 0 || m_connectionInProgress)
+        return false;
+
+    return waitForSocket(POLLIN, 0);
+}
+
 Socket::SendStatus Socket::sendToServer(BinaryQueue &queue) {
     m_sendQueue.appendMoveFrom(queue);
 
@@ -252,17 +267,21 @@ bool Socket::receiveFromServer(BinaryQueue &queue) {
         return true;
     }
 
-    RawBuffer buffer(BUFSIZ);
+    struct iovec vector[RECEIVE_VECTOR_SIZE];
     ssize_t size = 0;
     while (true) {
-        size = TEMP_FAILURE_RETRY(read(m_sock, buffer.data(), BUFSIZ));
+        // Data are received straight into queue chunks
+        size_t count = queue.importIovec(vector, RECEIVE_VECTOR_SIZE);
+        size = TEMP_FAILURE_RETRY(readv(m_sock, vector, static_cast<int>(count)));
+        int err = errno;
+        queue.commitIovec(size > 0 ? static_cast<size_t>(size) : 0);
+
         if (size == 0) {
-            LOGW("read return 0 / Connection closed by server.");
+            LOGW("readv return 0 / Connection closed by server.");
             return false;
         }
 
         if (size == -1) {
-            int err = errno;
             switch (err) {
                 case EAGAIN:
 #if EWOULDBLOCK != EAGAIN
@@ -270,15 +289,13 @@ bool Socket::receiveFromServer(BinaryQueue &queue) {
 #endif
                     return true;
                 case ECONNRESET:
-                    LOGW("read returned -1 with ECONNRESET / Connection closed by server.");
+                    LOGW("readv returned -1 with ECONNRESET / Connection closed by server.");
                     return false;
                 default:
-                    LOGE("'read' function error [%d] : <%s>", err, strerror(err));
+                    LOGE("'readv' function error [%d] : <%s>", err, strerror(err));
                     throw UnexpectedErrorException(err, strerror(err));
             }
         }
-
-        queue.appendCopy(buffer.data(), static_cast<size_t>(size));
     }
 }
 
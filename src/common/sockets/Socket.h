@@ -65,6 +65,7 @@ private:
     //returns false     in case of timeout
     //throws            in critical situations
     bool waitForSocket(int event);
+    bool waitForSocket(int event, int timeoutMiliseconds);
 
     //returns int       errorcode read from socket
     //throws            in critical situations
@@ -114,6 +115,11 @@ public:
     //returns false         No data to send
     bool isDataToSend(void);
 
+    //returns true          There are data waiting to be received (or connection is closed)
+    //returns false         No data to receive
+    //throws                in critical situations
+    bool isDataToReceive(void);
+
     //returns SendStatus::PARTIAL_DATA_SENT         if no all data sent
     //returns SendStatus::ALL_DATA_SENT             if all data was sent
     //returns SendStatus::CONNECTION_LOST           if connection was lost
@@ -54,10 +54,14 @@ bool SocketClient::isConnected(void) {
     return m_socket.isConnected();
 }
 
-ResponsePtr SocketClient::askCynaraServer(const Request &request) {
+void SocketClient::appendRequest(const Request &request) {
     //pass request to protocol
     RequestContext context(ResponseTakerPtr(), m_writeQueue);
     request.execute(*m_protocol, context);
+}
+
+ResponsePtr SocketClient::askCynaraServer(const Request &request) {
+    appendRequest(request);
 
     //send request to cynara
     if (m_socket.sendToServer(*m_writeQueue) == Socket::SendStatus::CONNECTION_LOST) {
@@ -65,16 +69,24 @@ ResponsePtr SocketClient::askCynaraServer(const Request &request) {
         return nullptr;
     }
 
-    // receive response from cynara
+    return receiveResponse();
+}
+
+bool SocketClient::isResponseWaiting(void) {
+    return !m_readQueue->empty() || m_socket.isDataToReceive();
+}
+
+ResponsePtr SocketClient::receiveResponse(void) {
+    // receive response from cynara, it might be already waiting in read queue
     while (true) {
-        if (!m_socket.receiveFromServer(*m_readQueue)) {
-            LOGW("Disconnected while receiving response from Cynara.");
-            return nullptr;
-        }
         ResponsePtr response = m_protocol->extractResponseFromBuffer(m_readQueue);
         if (response) {
             return response;
         }
+        if (!m_socket.receiveFromServer(*m_readQueue)) {
+            LOGW("Disconnected while receiving response from Cynara.");
+            return nullptr;
+        }
     }
 }
 
@@ -51,9 +51,19 @@ public:
     bool connect(void);
     bool isConnected(void);
 
+    //queues request, which will be sent together with next asked request
+    void appendRequest(const Request &request);
+
     //returns pointer to response
     //        or nullptr when connection to cynara service is lost
     ResponsePtr askCynaraServer(const Request &request);
+
+    //returns true if response sent by cynara service (possibly incomplete) is waiting
+    bool isResponseWaiting(void);
+
+    //returns pointer to response
+    //        or nullptr when connection to cynara service is lost
+    ResponsePtr receiveResponse(void);
 };
 
 } // namespace Cynara
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/common/types/InternedString.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file implements InternedString and its global pool
+ */
+
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <lock/ReadWriteLock.h>
+
+#include "InternedString.h"
+
+namespace Cynara {
+
+const InternedString::Id InternedString::NOT_INTERNED_ID;
+
+namespace {
+
+// Keys point to values kept in entries, so values are stored once. Lookups point
+// to bytes of a caller, so no string has to be built to find an interned value.
+struct StringRef {
+    const char *data;
+    std::size_t size;
+};
+
+struct ValueHash {
+    std::size_t operator()(const StringRef &value) const {
+        // FNV-1a
+        std::size_t hash = 2166136261u;
+        for (std::size_t i = 0; i < value.size; ++i) {
+            hash ^= static_cast<unsigned char>(value.data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+};
+
+struct ValueEqual {
+    bool operator()(const StringRef &value1, const StringRef &value2) const {
+        return value1.size == value2.size
+               && memcmp(value1.data, value2.data, value1.size) == 0;
+    }
+};
+
+/*
+ * Part of pool holding values of single hash range. Interned values are found under
+ * read lock, so concurrent lookups do not wait for each other. Write lock is taken
+ * only to add or remove an entry. Ids of shard are its index in lowest bits.
+ */
+class StringPoolShard {
+public:
+    typedef InternedString::Entry Entry;
+    typedef InternedString::Id Id;
+
+    static const unsigned ID_SHIFT = 4;
+    static const std::size_t COUNT = 1 << ID_SHIFT;
+
+    StringPoolShard() : m_index(0), m_nextId(0) {}
+
+    void setIndex(Id index) {
+        m_index = index;
+    }
+
+    std::shared_ptr<const Entry> find(const StringRef &value) {
+        ReadLockGuard lock(m_lock);
+        auto it = m_entries.find(value);
+        return it != m_entries.end() ? it->second.lock() : nullptr;
+    }
+
+    std::shared_ptr<const Entry> intern(const StringRef &value) {
+        auto entry = find(value);
+        if (entry)
+            return entry;
+
+        WriteLockGuard lock(m_lock);
+        auto it = m_entries.find(value);
+        if (it != m_entries.end()) {
+            entry = it->second.lock();
+            if (entry)
+                return entry;
+            // Entry is just being released; it will not remove its replacement from pool
+            m_entries.erase(it);
+        }
+
+        entry.reset(new Entry(std::string(value.data, value.size), allocateId()),
+                    std::bind(&StringPoolShard::release, this, std::placeholders::_1));
+        m_entries.emplace(StringRef{entry->value.data(), entry->value.size()}, entry);
+        return entry;
+    }
+
+    std::size_t size(void) {
+        ReadLockGuard lock(m_lock);
+        return m_entries.size();
+    }
+
+private:
+    typedef std::unordered_map<StringRef, std::weak_ptr<const Entry>,
+                               ValueHash, ValueEqual> Entries;
+
+    Id allocateId(void) {
+        if (m_freeIds.empty())
+            return (m_nextId++ << ID_SHIFT) | m_index;
+
+        Id id = m_freeIds.back();
+        m_freeIds.pop_back();
+        return id;
+    }
+
+    void release(const Entry *entry) {
+        {
+            WriteLockGuard lock(m_lock);
+            auto it = m_entries.find(StringRef{entry->value.data(), entry->value.size()});
+            if (it != m_entries.end() && it->first.data == entry->value.data())
+                m_entries.erase(it);
+            m_freeIds.push_back(entry->id);
+        }
+        delete entry;
+    }
+
+    ReadWriteLock m_lock;
+    Entries m_entries;
+    std::vector<Id> m_freeIds;
+    Id m_index;
+    Id m_nextId;
+};
+
+class StringPool {
+public:
+    typedef InternedString::Entry Entry;
+
+    StringPool() {
+        for (std::size_t i = 0; i < StringPoolShard::COUNT; ++i)
+            m_shards[i].setIndex(i);
+    }
+
+    std::shared_ptr<const Entry> intern(const char *data, std::size_t size) {
+        StringRef value{data, size};
+        return shard(value).intern(value);
+    }
+
+    std::shared_ptr<const Entry> find(const char *data, std::size_t size) {
+        StringRef value{data, size};
+        return shard(value).find(value);
+    }
+
+    std::size_t size(void) {
+        std::size_t total = 0;
+        for (auto &shard : m_shards)
+            total += shard.size();
+        return total;
+    }
+
+private:
+    StringPoolShard &shard(const StringRef &value) {
+        // Highest bits are used, as lowest ones select bucket of shard's map
+        auto hash = ValueHash()(value);
+        return m_shards[(hash >> 24) % StringPoolShard::COUNT];
+    }
+
+    StringPoolShard m_shards[StringPoolShard::COUNT];
+};
+
+// Pool is never destroyed, so static InternedStrings may outlive any other static object
+StringPool &pool(void) {
+    static StringPool *pool = new StringPool();
+    return *pool;
+}
+
+} /* namespace anonymous */
+
+InternedString::InternedString(const std::string &value)
+    : m_entry(pool().intern(value.data(), value.size())) {
+}
+
+InternedString::InternedString(const char *data, std::size_t size)
+    : m_entry(pool().intern(data, size)) {
+}
+
+InternedString InternedString::lookup(const char *data, std::size_t size) {
+    auto entry = pool().find(data, size);
+    if (!entry)
+        entry = std::make_shared<const Entry>(std::string(data, size), NOT_INTERNED_ID);
+    return InternedString(std::move(entry));
+}
+
+std::size_t InternedString::poolSize(void) {
+    return pool().size();
+}
+
+} /* namespace Cynara */
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/common/types/InternedString.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines InternedString - a string kept once in global pool
+ */
+
+#ifndef SRC_COMMON_TYPES_INTERNEDSTRING_H_
+#define SRC_COMMON_TYPES_INTERNEDSTRING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace Cynara {
+
+/**
+ * All InternedStrings with equal values share single entry of global pool.
+ * Entry has a compact id, unique among living entries, so equality is a comparison of ids.
+ * Entry is removed from pool, when last InternedString referring to it is destroyed,
+ * and its id may be then reused.
+ * Transient strings made by lookup() refer to pooled entry, when value is already interned.
+ * Otherwise they keep value outside of pool with NOT_INTERNED_ID, which matches no interned id.
+ */
+class InternedString {
+public:
+    typedef uint32_t Id;
+
+    static const Id NOT_INTERNED_ID = UINT32_MAX;
+
+    struct Entry {
+        Entry(const std::string &entryValue, Id entryId) : value(entryValue), id(entryId) {}
+
+        const std::string value;
+        const Id id;
+    };
+
+    explicit InternedString(const std::string &value);
+
+    /*
+     * Looks up pool directly with given bytes, so value is copied only when it is not
+     * interned yet
+     */
+    InternedString(const char *data, std::size_t size);
+
+    /*
+     * Never adds value to pool, so values of short living objects (e.g. keys of requests)
+     * do not lock pool for writing, when they are created and destroyed
+     */
+    static InternedString lookup(const char *data, std::size_t size);
+
+    InternedString(const InternedString &) = default;
+    InternedString &operator=(const InternedString &) = default;
+
+    const std::string &value(void) const {
+        return m_entry->value;
+    }
+
+    Id id(void) const {
+        return m_entry->id;
+    }
+
+    bool isInterned(void) const {
+        return m_entry->id != NOT_INTERNED_ID;
+    }
+
+    bool operator==(const InternedString &other) const {
+        if (m_entry == other.m_entry)
+            return true;
+        return (!isInterned() || !other.isInterned()) && value() == other.value();
+    }
+
+    bool operator!=(const InternedString &other) const {
+        return !(*this == other);
+    }
+
+    static std::size_t poolSize(void);
+
+private:
+    explicit InternedString(std::shared_ptr<const Entry> &&entry) : m_entry(std::move(entry)) {}
+
+    std::shared_ptr<const Entry> m_entry;
+};
+
+} /* namespace Cynara */
+
+#endif /* SRC_COMMON_TYPES_INTERNEDSTRING_H_ */
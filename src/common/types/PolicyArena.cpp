@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/common/types/PolicyArena.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file contains implementation of allocator creating policies in shared blocks
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "PolicyArena.h"
+
+namespace Cynara {
+
+class PolicyArena::Block {
+public:
+    explicit Block(std::size_t size)
+        : m_storage(new char[size]), m_size(size), m_used(0) {}
+
+    // Returns nullptr, when there is no room left
+    void *allocate(std::size_t size) {
+        const std::size_t alignment = alignof(std::max_align_t);
+        std::size_t begin = (m_used + alignment - 1) / alignment * alignment;
+        if (begin + size > m_size)
+            return nullptr;
+
+        m_used = begin + size;
+        return m_storage.get() + begin;
+    }
+
+    bool owns(const void *pointer) const {
+        const char *begin = m_storage.get();
+        return pointer >= begin && pointer < begin + m_size;
+    }
+
+    std::size_t room(void) const {
+        return m_size - m_used;
+    }
+
+    std::size_t used(void) const {
+        return m_used;
+    }
+
+private:
+    std::unique_ptr<char[]> m_storage;
+    std::size_t m_size;
+    std::size_t m_used;
+};
+
+/**
+ * Every node keeps a copy of allocator, so its block lives as long as the node does.
+ * Nodes not fitting into block are allocated separately.
+ */
+template <typename T>
+class PolicyArena::Allocator {
+public:
+    typedef T value_type;
+
+    explicit Allocator(const std::shared_ptr<Block> &block) : m_block(block) {}
+
+    template <typename U>
+    Allocator(const Allocator<U> &other) : m_block(other.m_block) {}
+
+    T *allocate(std::size_t count) {
+        void *node = m_block->allocate(count * sizeof(T));
+        return static_cast<T *>(node ? node : ::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T *node, std::size_t) {
+        // Block memory is freed with the block, once no node uses it
+        if (!m_block->owns(node))
+            ::operator delete(node);
+    }
+
+    template <typename U>
+    bool operator==(const Allocator<U> &other) const {
+        return m_block == other.m_block;
+    }
+
+    template <typename U>
+    bool operator!=(const Allocator<U> &other) const {
+        return m_block != other.m_block;
+    }
+
+private:
+    template <typename U>
+    friend class Allocator;
+
+    std::shared_ptr<Block> m_block;
+};
+
+const std::size_t PolicyArena::MIN_BLOCK_CAPACITY;
+const std::size_t PolicyArena::MAX_BLOCK_CAPACITY;
+
+PolicyArena::PolicyArena(std::size_t capacity)
+    : m_nextCapacity(std::max(capacity, static_cast<std::size_t>(1))),
+      // Generous estimate of node size, until size of real one is known
+      m_nodeSize(sizeof(Policy) + 8 * sizeof(void *)) {
+}
+
+PolicyPtr PolicyArena::create(const PolicyKey &key, const PolicyResult &result) {
+    if (!m_block || m_block->room() < m_nodeSize) {
+        m_block = std::make_shared<Block>(m_nextCapacity * m_nodeSize);
+        m_nextCapacity = std::min(m_nextCapacity * 2,
+                                  std::max(m_nextCapacity, MAX_BLOCK_CAPACITY));
+    }
+
+    auto used = m_block->used();
+    auto policy = std::allocate_shared<Policy>(Allocator<Policy>(m_block), key, result);
+    if (m_block->used() != used)
+        m_nodeSize = m_block->used() - used;
+    return policy;
+}
+
+} // namespace Cynara
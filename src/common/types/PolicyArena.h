@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/common/types/PolicyArena.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines allocator creating policies in shared blocks
+ */
+
+#ifndef SRC_COMMON_TYPES_POLICYARENA_H_
+#define SRC_COMMON_TYPES_POLICYARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <types/pointers.h>
+#include <types/Policy.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+
+namespace Cynara {
+
+/**
+ * Creates policies in contiguous blocks instead of allocating each of them separately.
+ * Every policy is created together with its own reference count in a node taken from
+ * current block, so it is destroyed as soon as it is released, regardless of other
+ * policies. Nodes are not reused, as arenas live only while a batch of policies is
+ * created; a block is freed when last node taken from it is released. First block
+ * has room for given number of policies, next ones grow geometrically, so loading
+ * n policies needs O(log n) allocations or just one, when number is known upfront.
+ */
+class PolicyArena {
+public:
+    static const std::size_t MIN_BLOCK_CAPACITY = 64;
+    static const std::size_t MAX_BLOCK_CAPACITY = 1 << 16;
+
+    explicit PolicyArena(std::size_t capacity = MIN_BLOCK_CAPACITY);
+
+    PolicyPtr create(const PolicyKey &key, const PolicyResult &result);
+
+private:
+    class Block;
+    template <typename T>
+    class Allocator;
+
+    std::shared_ptr<Block> m_block;
+    std::size_t m_nextCapacity;
+    // Size of node holding policy with its reference count, learned from first created one
+    std::size_t m_nodeSize;
+};
+
+} // namespace Cynara
+
+#endif /* SRC_COMMON_TYPES_POLICYARENA_H_ */
@@ -20,8 +20,8 @@
  * @brief       Implementation of Cynara::PolicyBucket methods
  */
 
+#include <atomic>
 #include <cstring>
-#include <sstream>
 
 #include <exceptions/InvalidBucketIdException.h>
 #include <types/PolicyCollection.h>
@@ -31,36 +31,75 @@
 
 namespace Cynara {
 
+namespace {
+
+// Buckets are modified concurrently, when database is loaded
+std::atomic<std::size_t> lastRevision(0);
+
+template <typename Index, typename Postings>
+void addPosting(Index &index, const typename Index::key_type &key, std::size_t list,
+                std::uint32_t position, Postings &postings) {
+    auto &positions = index[key];
+    postings[position][list] = static_cast<std::uint32_t>(positions.size());
+    positions.push_back(position);
+}
+
+// Last position on list takes place of the removed one, so list stays compact
+template <typename Index, typename Postings>
+void removePosting(Index &index, const typename Index::key_type &key, std::size_t list,
+                   std::uint32_t position, Postings &postings) {
+    auto indexIt = index.find(key);
+    auto &positions = indexIt->second;
+    auto at = postings[position][list];
+    auto moved = positions.back();
+    positions[at] = moved;
+    postings[moved][list] = at;
+    positions.pop_back();
+    if (positions.empty())
+        index.erase(indexIt);
+}
+
+template <typename Index, typename Postings>
+void relocatePosting(Index &index, const typename Index::key_type &key, std::size_t list,
+                     std::uint32_t from, std::uint32_t to, const Postings &postings) {
+    index.find(key)->second[postings[from][list]] = to;
+}
+
+} // namespace anonymous
+
 const char PolicyBucket::m_idSeparators[] = "-_";
+const std::size_t PolicyBucket::MAX_MATCHES;
+const std::size_t PolicyBucket::FEATURES_COUNT;
+const std::size_t PolicyBucket::LINKS_LIST;
 
 PolicyBucket::PolicyBucket(const PolicyBucketId &id, const PolicyResult &defaultPolicy)
-    : m_defaultPolicy(defaultPolicy), m_id(id) {
+    : m_contents(std::make_shared<Contents>()), m_defaultPolicy(defaultPolicy), m_id(id), m_dirty(true) {
     idValidator(id);
+    touch();
 }
 
 PolicyBucket::PolicyBucket(const PolicyBucketId &id, const PolicyCollection &policies)
-    : m_policyCollection(makePolicyMap(policies)), m_defaultPolicy(PredefinedPolicyType::DENY),
-      m_id(id) {
+    : m_contents(std::make_shared<Contents>()), m_defaultPolicy(PredefinedPolicyType::DENY), m_id(id), m_dirty(true) {
     idValidator(id);
+    insertPolicies(policies);
+    touch();
 }
 
 PolicyBucket::PolicyBucket(const PolicyBucketId &id, const PolicyResult &defaultPolicy,
                            const PolicyCollection &policies)
-    : m_policyCollection(makePolicyMap(policies)), m_defaultPolicy(defaultPolicy), m_id(id) {
+    : m_contents(std::make_shared<Contents>()), m_defaultPolicy(defaultPolicy), m_id(id), m_dirty(true) {
     idValidator(id);
+    insertPolicies(policies);
+    touch();
 }
 
 PolicyBucket PolicyBucket::filtered(const PolicyKey &key) const {
     PolicyBucket result(m_id + "_filtered");
 
-    const auto &policies = m_policyCollection;
-    const auto variants = PolicyKeyHelpers::keyVariants(key);
-
-    for (const auto &variant : variants) {
-        const auto policyIter = policies.find(variant);
-        if (policyIter != policies.end()) {
-            result.m_policyCollection[policyIter->first] = policyIter->second;
-        }
+    Matches matches;
+    auto count = match(key, PolicyKeyHashes(key), matches);
+    for (std::size_t i = 0; i < count; ++i) {
+        result.insertPolicy(matches[i]);
     }
 
     // Inherit original policy
@@ -68,55 +107,125 @@ PolicyBucket PolicyBucket::filtered(const PolicyKey &key) const {
     return result;
 }
 
+std::size_t PolicyBucket::match(const PolicyKey &key, const PolicyKeyHashes &hashes,
+                                Matches &matches) const {
+    std::size_t count = 0;
+    for (unsigned variant = 0; variant < PolicyKeyHelpers::VARIANTS_COUNT; ++variant) {
+        if (PolicyKeyHelpers::isVariantRedundant(key, variant))
+            continue;
+
+        auto policy = m_contents->policies.find(PolicyKeyHelpers::variantIds(key, variant),
+                                                PolicyKeyHelpers::variantHash(hashes, variant));
+        if (policy)
+            matches[count++] = *policy;
+    }
+
+    return count;
+}
+
 void PolicyBucket::insertPolicy(PolicyPtr policy) {
-    const auto gluedKey = PolicyKeyHelpers::glueKey(policy->key());
-    m_policyCollection[gluedKey] = policy;
+    insertIntoCollection(policy);
+    m_dirty = true;
+    touch();
+}
+
+void PolicyBucket::insertPolicies(const PolicyCollection &policies) {
+    if (policies.empty())
+        return;
+
+    auto &contents = detach();
+    contents.policies.reserve(contents.policies.size() + policies.size());
+    for (const auto &policy : policies) {
+        insertIntoCollection(policy);
+    }
+    m_dirty = true;
+    touch();
 }
 
 void PolicyBucket::deletePolicy(const PolicyKey &key) {
-    const auto gluedKey = PolicyKeyHelpers::glueKey(key);
-    m_policyCollection.erase(gluedKey);
+    if (eraseFromCollection(key)) {
+        m_dirty = true;
+        touch();
+    }
 }
 
 void PolicyBucket::deletePolicy(std::function<bool(PolicyPtr)> predicate) {
-    auto &policies = m_policyCollection;
+    std::vector<PolicyPtr> policies;
+    for (const auto &policy : m_contents->policies) {
+        if (predicate(policy))
+            policies.push_back(policy);
+    }
 
-    for (auto iter = policies.begin(); iter != policies.end(); ) {
-        if (predicate(iter->second)) {
-            policies.erase(iter++);
-        } else {
-            ++iter;
-        }
+    for (const auto &policy : policies) {
+        eraseFromCollection(policy->key());
+    }
+
+    if (!policies.empty()) {
+        m_dirty = true;
+        touch();
     }
 }
 
 PolicyBucket::Policies PolicyBucket::listPolicies(const PolicyKey &filter) const {
     PolicyBucket::Policies policies;
-    for (auto iter = m_policyCollection.begin(); iter != m_policyCollection.end(); ++iter) {
-        auto &policyPtr = iter->second;
-        if (policyPtr->key().matchFilter(filter))
-            policies.push_back(*policyPtr);
+    for (auto policy : matchingPolicies(filter)) {
+        policies.push_back(*policy);
     }
     return policies;
 }
 
+std::size_t PolicyBucket::erasePolicies(const PolicyKey &filter) {
+    auto policies = matchingPolicies(filter);
+    for (auto policy : policies) {
+        eraseFromCollection(policy->key());
+    }
+
+    if (!policies.empty()) {
+        m_dirty = true;
+        touch();
+    }
+    return policies.size();
+}
+
+std::size_t PolicyBucket::deleteLinking(const PolicyBucketId &bucketId) {
+    const auto &links = m_contents->links;
+    auto linksIt = links.find(bucketId);
+    if (linksIt == links.end())
+        return 0;
+
+    // Erasing policies modifies the list, so policies are collected first
+    std::vector<PolicyPtr> policies;
+    policies.reserve(linksIt->second.size());
+    for (auto position : linksIt->second) {
+        policies.push_back(m_contents->policies.at(position));
+    }
+    for (auto policy : policies) {
+        eraseFromCollection(policy->key());
+    }
+
+    m_dirty = true;
+    touch();
+    return policies.size();
+}
+
 PolicyBucket::BucketIds PolicyBucket::getSubBuckets(void) const {
     PolicyBucket::BucketIds buckets;
-    for (auto iter = m_policyCollection.begin(); iter != m_policyCollection.end(); ++iter) {
-        auto &policyPtr = iter->second;
-        if (policyPtr->result().policyType() == PredefinedPolicyType::BUCKET)
-            buckets.insert(policyPtr->result().metadata());
+    for (const auto &links : m_contents->links) {
+        buckets.insert(links.first);
     }
     return buckets;
 }
 
-PolicyMap PolicyBucket::makePolicyMap(const PolicyCollection &policies) {
-    PolicyMap result;
-    for (const auto &policy : policies) {
-        const auto gluedKey = PolicyKeyHelpers::glueKey(policy->key());
-        result[gluedKey] = policy;
-    }
-    return result;
+PolicyBucket::Contents &PolicyBucket::detach(void) {
+    // Copies sharing contents are not created concurrently with modifications of this one,
+    // so the count can only drop meanwhile, which at worst causes a needless copy
+    if (m_contents.use_count() > 1)
+        m_contents = std::make_shared<Contents>(*m_contents);
+    return *m_contents;
+}
+
+void PolicyBucket::touch(void) {
+    m_revision = ++lastRevision;
 }
 
 void PolicyBucket::idValidator(const PolicyBucketId &id) {
@@ -133,4 +242,121 @@ bool PolicyBucket::isIdSeparator(char c) {
     return strchr(m_idSeparators, c) != nullptr;
 }
 
+const PolicyKeyFeature &PolicyBucket::feature(const PolicyKey &key, std::size_t index) {
+    switch (index) {
+        case 0:
+            return key.client();
+        case 1:
+            return key.user();
+        default:
+            return key.privilege();
+    }
+}
+
+void PolicyBucket::insertIntoCollection(PolicyPtr policy) {
+    auto &contents = detach();
+    auto position = contents.policies.position(policy->key());
+    if (position != PolicyMap::npos) {
+        unindexPolicy(static_cast<std::uint32_t>(position));
+        contents.policies.insert(policy);
+        indexPolicy(static_cast<std::uint32_t>(position));
+        return;
+    }
+
+    contents.policies.insert(policy);
+    contents.postings.emplace_back();
+    indexPolicy(static_cast<std::uint32_t>(contents.policies.size() - 1));
+}
+
+bool PolicyBucket::eraseFromCollection(const PolicyKey &key) {
+    auto position = m_contents->policies.position(key);
+    if (position == PolicyMap::npos)
+        return false;
+
+    auto &contents = detach();
+    unindexPolicy(static_cast<std::uint32_t>(position));
+    // Erased policy is held, as key may belong to it
+    auto last = contents.policies.size() - 1;
+    auto erased = contents.policies.erase(key);
+    if (position != last)
+        relocatePolicy(static_cast<std::uint32_t>(last), static_cast<std::uint32_t>(position));
+    contents.postings.pop_back();
+    return true;
+}
+
+void PolicyBucket::indexPolicy(std::uint32_t position) {
+    auto &contents = *m_contents;
+    const auto &policy = *contents.policies.at(position);
+    for (std::size_t i = 0; i < FEATURES_COUNT; ++i) {
+        addPosting(contents.featureIndexes[i], feature(policy.key(), i).id(), i, position,
+                   contents.postings);
+    }
+    if (policy.result().policyType() == PredefinedPolicyType::BUCKET) {
+        addPosting(contents.links, policy.result().metadata(), LINKS_LIST, position,
+                   contents.postings);
+    }
+}
+
+void PolicyBucket::unindexPolicy(std::uint32_t position) {
+    auto &contents = *m_contents;
+    const auto &policy = *contents.policies.at(position);
+    for (std::size_t i = 0; i < FEATURES_COUNT; ++i) {
+        removePosting(contents.featureIndexes[i], feature(policy.key(), i).id(), i, position,
+                      contents.postings);
+    }
+    if (policy.result().policyType() == PredefinedPolicyType::BUCKET) {
+        removePosting(contents.links, policy.result().metadata(), LINKS_LIST, position,
+                      contents.postings);
+    }
+}
+
+void PolicyBucket::relocatePolicy(std::uint32_t from, std::uint32_t to) {
+    auto &contents = *m_contents;
+    const auto &policy = *contents.policies.at(to);
+    for (std::size_t i = 0; i < FEATURES_COUNT; ++i) {
+        relocatePosting(contents.featureIndexes[i], feature(policy.key(), i).id(), i, from, to,
+                        contents.postings);
+    }
+    if (policy.result().policyType() == PredefinedPolicyType::BUCKET) {
+        relocatePosting(contents.links, policy.result().metadata(), LINKS_LIST, from, to,
+                        contents.postings);
+    }
+    contents.postings[to] = contents.postings[from];
+}
+
+std::vector<const Policy *> PolicyBucket::matchingPolicies(const PolicyKey &filter) const {
+    std::vector<const Policy *> policies;
+
+    // Only policies having all not-any features of filter can match, so the smallest
+    // set of policies having one of them is enough to look through
+    const FeatureIndex::mapped_type *candidates = nullptr;
+    for (std::size_t i = 0; i < FEATURES_COUNT; ++i) {
+        const auto &filterFeature = feature(filter, i);
+        if (filterFeature.isAny())
+            continue;
+
+        const auto &index = m_contents->featureIndexes[i];
+        auto indexIt = index.find(filterFeature.id());
+        if (indexIt == index.end())
+            return policies;
+        if (!candidates || indexIt->second.size() < candidates->size())
+            candidates = &indexIt->second;
+    }
+
+    if (!candidates) {
+        policies.reserve(m_contents->policies.size());
+        for (const auto &policy : m_contents->policies) {
+            policies.push_back(policy.get());
+        }
+        return policies;
+    }
+
+    for (auto position : *candidates) {
+        const auto *policy = m_contents->policies.at(position).get();
+        if (policy->key().matchFilter(filter))
+            policies.push_back(policy);
+    }
+    return policies;
+}
+
 }  // namespace Cynara
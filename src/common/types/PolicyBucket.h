@@ -26,17 +26,23 @@
 #define SRC_COMMON_TYPES_POLICYBUCKET_H_
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <exceptions/NotImplementedException.h>
+#include <types/InternedString.h>
 #include <types/pointers.h>
 #include <types/Policy.h>
 #include <types/PolicyBucketId.h>
 #include <types/PolicyCollection.h>
 #include <types/PolicyKey.h>
+#include <types/PolicyKeyHelpers.h>
 #include <types/PolicyType.h>
 
 namespace Cynara {
@@ -52,6 +58,10 @@ public:
     typedef std::vector<Policy> Policies;
     typedef std::set<PolicyBucketId> BucketIds;
 
+    // At most one policy matches each variant of a checked key
+    static const std::size_t MAX_MATCHES = PolicyKeyHelpers::VARIANTS_COUNT;
+    typedef std::array<PolicyPtr, MAX_MATCHES> Matches;
+
     // TODO: Review usefulness of ctors
     //delete default constructor in order to prevent creation of buckets with no id
     PolicyBucket() = delete;
@@ -62,32 +72,41 @@ public:
     PolicyBucket(const PolicyBucketId &id,
                  const PolicyResult &defaultPolicy,
                  const PolicyCollection &policies);
+    // Copies share contents; moves are not declared, so a moved-from bucket stays valid
+    PolicyBucket(const PolicyBucket &) = default;
+    PolicyBucket &operator=(const PolicyBucket &) = default;
 
     PolicyBucket filtered(const PolicyKey &key) const;
+    std::size_t match(const PolicyKey &key, const PolicyKeyHashes &hashes,
+                      Matches &matches) const;
     void insertPolicy(PolicyPtr policy);
+    // Reserves room for all policies upfront, so it is cheaper than inserting them one by one
+    void insertPolicies(const PolicyCollection &policies);
     void deletePolicy(const PolicyKey &key);
     Policies listPolicies(const PolicyKey &filter) const;
+    // Deletes all policies matching filter, returns number of deleted policies
+    std::size_t erasePolicies(const PolicyKey &filter);
+    // Deletes all policies linking to given bucket, returns number of deleted policies
+    std::size_t deleteLinking(const PolicyBucketId &bucketId);
     BucketIds getSubBuckets(void) const;
 
     // TODO: Try to change interface, so this method is not needed
     void deletePolicy(std::function<bool(PolicyPtr)> predicate);
 
-    static PolicyMap makePolicyMap(const PolicyCollection &policies);
-
     const_policy_iterator begin(void) const {
-        return const_policy_iterator(m_policyCollection.begin());
+        return const_policy_iterator(m_contents->policies.begin());
     }
 
     const_policy_iterator end(void) const {
-        return const_policy_iterator(m_policyCollection.end());
+        return const_policy_iterator(m_contents->policies.end());
     }
 
     PolicyMap::size_type size(void) const {
-        return m_policyCollection.size();
+        return m_contents->policies.size();
     }
 
     bool empty(void) const {
-        return m_policyCollection.empty();
+        return m_contents->policies.empty();
     }
 
     const PolicyResult &defaultPolicy(void) const {
@@ -101,15 +120,73 @@ public:
     // TODO: Consider StorageBackend to be only one to alter this property
     void setDefaultPolicy(const PolicyResult &defaultPolicy) {
         m_defaultPolicy = defaultPolicy;
+        touch();
+    }
+
+    // Bucket is dirty when its policies differ from ones last persisted
+    // Default policy is kept in database index, so it does not affect this flag
+    bool dirty(void) const {
+        return m_dirty;
+    }
+
+    void setDirty(bool dirty) {
+        m_dirty = dirty;
+    }
+
+    // Revision changes with every modification of policies or default policy.
+    // Revisions are unique among all buckets, so copies with equal revision are equal.
+    std::size_t revision(void) const {
+        return m_revision;
+    }
+
+    // Tells whether policies are still shared with another copy of this bucket
+    bool sharesPolicies(const PolicyBucket &other) const {
+        return m_contents == other.m_contents;
     }
 
 private:
+    // Positions of policies in policy map, kept compact when policies are erased
+    typedef std::vector<std::uint32_t> PostingList;
+    // Posting lists of policies with given value of one key feature
+    typedef std::unordered_map<InternedString::Id, PostingList> FeatureIndex;
+    // Posting lists of BUCKET policies by id of bucket they link to
+    typedef std::unordered_map<PolicyBucketId, PostingList> LinkIndex;
+    static const std::size_t FEATURES_COUNT = 3;
+    static const std::size_t LINKS_LIST = FEATURES_COUNT;
+    // Position of a policy in every posting list it is on
+    typedef std::array<std::uint32_t, FEATURES_COUNT + 1> Postings;
+
+    // Copies of a bucket share policies and indexes until one of them is modified,
+    // so copying a bucket (e.g. into a storage snapshot) does not depend on its size
+    struct Contents {
+        PolicyMap policies;
+        // Postings of policies, kept at positions of policies in map
+        std::vector<Postings> postings;
+        // Secondary indexes for filtered listing and erasing, one per key feature
+        std::array<FeatureIndex, FEATURES_COUNT> featureIndexes;
+        LinkIndex links;
+    };
+
     static void idValidator(const PolicyBucketId &id);
     static bool isIdSeparator(char c);
-
-    PolicyMap m_policyCollection;
+    static const PolicyKeyFeature &feature(const PolicyKey &key, std::size_t index);
+
+    void insertIntoCollection(PolicyPtr policy);
+    bool eraseFromCollection(const PolicyKey &key);
+    void indexPolicy(std::uint32_t position);
+    void unindexPolicy(std::uint32_t position);
+    // Updates posting lists after policy was moved in map
+    void relocatePolicy(std::uint32_t from, std::uint32_t to);
+    std::vector<const Policy *> matchingPolicies(const PolicyKey &filter) const;
+    // Returns contents owned by this copy only, copying them if they are shared
+    Contents &detach(void);
+    void touch(void);
+
+    std::shared_ptr<Contents> m_contents;
     PolicyResult m_defaultPolicy;
     PolicyBucketId m_id;
+    bool m_dirty;
+    std::size_t m_revision;
     static const char m_idSeparators[];
 };
 
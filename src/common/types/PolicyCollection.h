@@ -24,15 +24,14 @@
 #ifndef SRC_COMMON_TYPES_POLICYCOLLECTION_H_
 #define SRC_COMMON_TYPES_POLICYCOLLECTION_H_
 
-#include <unordered_map>
 #include <vector>
 
 #include "types/pointers.h"
+#include "types/PolicyMap.h"
 
 namespace Cynara {
 
 typedef std::vector<PolicyPtr> PolicyCollection;
-typedef std::unordered_map<std::string, PolicyPtr> PolicyMap;
 
 class const_policy_iterator : public PolicyMap::const_iterator
 {
@@ -42,7 +41,7 @@ class const_policy_iterator : public PolicyMap::const_iterator
         : PolicyMap::const_iterator(other) {};
 
     PolicyPtr operator*(void) {
-        return PolicyMap::const_iterator::operator*().second;
+        return PolicyMap::const_iterator::operator*();
     }
 };
 
@@ -25,9 +25,12 @@
 #ifndef CYNARA_COMMON_TYPES_POLICYKEY_H_
 #define CYNARA_COMMON_TYPES_POLICYKEY_H_
 
+#include <cstddef>
 #include <tuple>
 #include <string>
 
+#include <types/InternedString.h>
+
 namespace Cynara {
 
 class PolicyKey;
@@ -48,6 +51,15 @@ public:
         return PolicyKeyFeature(value);
     }
 
+    static PolicyKeyFeature create(const char *data, std::size_t size) {
+        return PolicyKeyFeature(InternedString(data, size));
+    }
+
+    // Value is interned only if it is already pooled, see InternedString::lookup()
+    static PolicyKeyFeature createTransient(const char *data, std::size_t size) {
+        return PolicyKeyFeature(InternedString::lookup(data, size));
+    }
+
     static PolicyKeyFeature createWildcard(void) {
         return PolicyKeyFeature(wildcardValue());
     }
@@ -63,13 +75,26 @@ public:
     }
 
     bool operator==(const PolicyKeyFeature::ValueType &other) const {
-        return valuesMatch(*this, PolicyKeyFeature(other));
+        return value() == other;
     }
 
     const std::string &toString(void) const;
 
     const ValueType &value(void) const {
-        return m_value;
+        return m_value.value();
+    }
+
+    InternedString::Id id(void) const {
+        return m_value.id();
+    }
+
+    bool isInterned(void) const {
+        return m_value.isInterned();
+    }
+
+    // Transient feature looked up again, as its value might have been interned meanwhile
+    PolicyKeyFeature resolved(void) const {
+        return isInterned() ? *this : createTransient(value().data(), value().size());
     }
 
     bool isWildcard(void) const {
@@ -89,6 +114,10 @@ protected:
         m_isWildcard(value == wildcardValue()),
         m_isAny(value == anyValue()) {}
 
+    explicit PolicyKeyFeature(const InternedString &value) : m_value(value),
+        m_isWildcard(value.value() == wildcardValue()),
+        m_isAny(value.value() == anyValue()) {}
+
     static bool anyAny(const PolicyKeyFeature &pkf1, const PolicyKeyFeature &pkf2) {
         return pkf1.isAny() || pkf2.isAny();
     }
@@ -98,11 +127,11 @@ protected:
     }
 
     static bool valuesMatch(const PolicyKeyFeature &pkf1, const PolicyKeyFeature &pkf2) {
-        return pkf1.value() == pkf2.value();
+        return pkf1.m_value == pkf2.m_value;
     }
 
 private:
-    ValueType m_value;
+    InternedString m_value;
     bool m_isWildcard;
     bool m_isAny;
 
@@ -148,6 +177,14 @@ public:
         return m_privilege;
     }
 
+    bool isInterned(void) const {
+        return m_client.isInterned() && m_user.isInterned() && m_privilege.isInterned();
+    }
+
+    PolicyKey resolved(void) const {
+        return PolicyKey(m_client.resolved(), m_user.resolved(), m_privilege.resolved());
+    }
+
     bool matchFilter(const PolicyKey &filter) const {
         return m_client.matchFilter(filter.m_client) && m_user.matchFilter(filter.m_user)
                && m_privilege.matchFilter(filter.m_privilege);
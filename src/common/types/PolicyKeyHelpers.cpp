@@ -20,45 +20,92 @@
  * @brief       Helper functions to manage Cynara::PolicyKey
  */
 
-#include <sstream>
+#include <functional>
+#include <string>
 
 #include "PolicyKeyHelpers.h"
 
 namespace Cynara {
 
-std::string PolicyKeyHelpers::glueKey(const PolicyKey &key) {
-    return glueKey(key.client(), key.user(), key.privilege());
+PolicyKeyHashes::PolicyKeyHashes(const PolicyKey &key)
+    : m_client(PolicyKeyHelpers::hashFeature(key.client())),
+      m_user(PolicyKeyHelpers::hashFeature(key.user())),
+      m_privilege(PolicyKeyHelpers::hashFeature(key.privilege())) {
 }
 
-std::string PolicyKeyHelpers::glueKey(const PolicyKeyFeature &client,
-                                      const PolicyKeyFeature &user,
-                                      const PolicyKeyFeature &privilege) {
-    const std::string sep = ";";
-    const std::string c = client.toString();
-    const std::string u = user.toString();
-    const std::string p = privilege.toString();
-
-    std::ostringstream glued;
-    glued << c << sep << u << sep << p << sep << c.size() << sep << u.size() << sep << p.size();
-    return glued.str();
+std::size_t PolicyKeyHelpers::hashFeature(const PolicyKeyFeature &feature) {
+    if (!feature.isInterned())
+        return std::hash<std::string>()(feature.value());
+    return std::hash<InternedString::Id>()(feature.id());
+}
+
+std::size_t PolicyKeyHelpers::hashKey(const PolicyKey &key) {
+    return combineHashes(hashFeature(key.client()), hashFeature(key.user()),
+                         hashFeature(key.privilege()));
+}
+
+std::size_t PolicyKeyHelpers::combineHashes(std::size_t client, std::size_t user,
+                                            std::size_t privilege) {
+    std::size_t seed = client;
+    for (auto hash : { user, privilege }) {
+        seed ^= hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+}
+
+std::size_t PolicyKeyHelpers::wildcardHash(void) {
+    static const std::size_t hash = std::hash<InternedString::Id>()(wildcardId());
+    return hash;
+}
+
+InternedString::Id PolicyKeyHelpers::wildcardId(void) {
+    // Kept alive, so id of wildcard value is never released and reused
+    static const PolicyKeyFeature wildcard = PolicyKeyFeature::createWildcard();
+    return wildcard.id();
+}
+
+namespace {
+
+enum VariantBit : unsigned {
+    WildcardClient = 1,
+    WildcardUser = 2,
+    WildcardPrivilege = 4,
 };
 
-std::vector<std::string> PolicyKeyHelpers::keyVariants(const PolicyKey &key) {
-    const auto &client = key.client();
-    const auto &user = key.user();
-    const auto &privilege = key.privilege();
-    const auto w = PolicyKeyFeature::createWildcard();
-
-    return {
-        glueKey(client, user, privilege),
-        glueKey(w, user, privilege),
-        glueKey(client, w, privilege),
-        glueKey(client, user, w),
-        glueKey(w, w, privilege),
-        glueKey(w, user, w),
-        glueKey(client, w, w),
-        glueKey(w, w, w),
-    };
+bool featureMatches(const PolicyKeyFeature &policyFeature, const PolicyKeyFeature &keyFeature,
+                    bool wildcard) {
+    return wildcard ? policyFeature.isWildcard() : policyFeature == keyFeature;
+}
+
+} /* namespace anonymous */
+
+const unsigned PolicyKeyHelpers::VARIANTS_COUNT;
+
+bool PolicyKeyHelpers::isVariantRedundant(const PolicyKey &key, unsigned variant) {
+    return ((variant & WildcardClient) && key.client().isWildcard())
+        || ((variant & WildcardUser) && key.user().isWildcard())
+        || ((variant & WildcardPrivilege) && key.privilege().isWildcard());
+}
+
+std::size_t PolicyKeyHelpers::variantHash(const PolicyKeyHashes &hashes, unsigned variant) {
+    const auto w = wildcardHash();
+    return combineHashes((variant & WildcardClient) ? w : hashes.client(),
+                         (variant & WildcardUser) ? w : hashes.user(),
+                         (variant & WildcardPrivilege) ? w : hashes.privilege());
+}
+
+PolicyKeyIds PolicyKeyHelpers::variantIds(const PolicyKey &key, unsigned variant) {
+    const auto w = wildcardId();
+    return PolicyKeyIds((variant & WildcardClient) ? w : key.client().id(),
+                        (variant & WildcardUser) ? w : key.user().id(),
+                        (variant & WildcardPrivilege) ? w : key.privilege().id());
+}
+
+bool PolicyKeyHelpers::matchesVariant(const PolicyKey &policyKey, const PolicyKey &key,
+                                      unsigned variant) {
+    return featureMatches(policyKey.client(), key.client(), variant & WildcardClient)
+        && featureMatches(policyKey.user(), key.user(), variant & WildcardUser)
+        && featureMatches(policyKey.privilege(), key.privilege(), variant & WildcardPrivilege);
 }
 
 } /* namespace Cynara */
@@ -22,19 +22,81 @@
 #ifndef SRC_COMMON_TYPES_POLICYKEYHELPERS_H_
 #define SRC_COMMON_TYPES_POLICYKEYHELPERS_H_
 
-#include <string>
-#include <vector>
+#include <cstddef>
 
+#include <types/InternedString.h>
 #include <types/PolicyKey.h>
 
 namespace Cynara {
 
+/**
+ * Hashes of particular features of a key. They are computed once per check
+ * and reused for every key variant looked up in every visited bucket.
+ * Features are hashed by their interned ids, which stay the same as long as
+ * any policy or key refers to the feature value. Transient features, not known
+ * to any policy, are hashed by value.
+ */
+class PolicyKeyHashes {
+public:
+    explicit PolicyKeyHashes(const PolicyKey &key);
+
+    std::size_t client(void) const {
+        return m_client;
+    }
+
+    std::size_t user(void) const {
+        return m_user;
+    }
+
+    std::size_t privilege(void) const {
+        return m_privilege;
+    }
+
+private:
+    std::size_t m_client;
+    std::size_t m_user;
+    std::size_t m_privilege;
+};
+
+/**
+ * Interned ids of all features of a key. Keys with equal ids have equal values,
+ * unless some of their features are transient (see InternedString::NOT_INTERNED_ID).
+ */
+struct PolicyKeyIds {
+    PolicyKeyIds(InternedString::Id clientId, InternedString::Id userId,
+                 InternedString::Id privilegeId)
+        : client(clientId), user(userId), privilege(privilegeId) {}
+    explicit PolicyKeyIds(const PolicyKey &key)
+        : client(key.client().id()), user(key.user().id()), privilege(key.privilege().id()) {}
+
+    bool operator==(const PolicyKeyIds &other) const {
+        return client == other.client && user == other.user && privilege == other.privilege;
+    }
+
+    InternedString::Id client;
+    InternedString::Id user;
+    InternedString::Id privilege;
+};
+
 class PolicyKeyHelpers {
 public:
-    static std::string glueKey(const PolicyKey &client);
-    static std::string glueKey(const PolicyKeyFeature &client, const PolicyKeyFeature &user,
-                               const PolicyKeyFeature &privilege);
-    static std::vector<std::string> keyVariants(const PolicyKey &key);
+    static std::size_t hashFeature(const PolicyKeyFeature &feature);
+    static std::size_t hashKey(const PolicyKey &key);
+    static std::size_t combineHashes(std::size_t client, std::size_t user, std::size_t privilege);
+    static std::size_t wildcardHash(void);
+    static InternedString::Id wildcardId(void);
+
+    /*
+     * Policies matching a key are looked up by variants of the key. Bits of variant number
+     * select features replaced by wildcard: 1 - client, 2 - user, 4 - privilege.
+     */
+    static const unsigned VARIANTS_COUNT = 8;
+    // Variant replacing a feature, which is already a wildcard, duplicates another variant
+    static bool isVariantRedundant(const PolicyKey &key, unsigned variant);
+    static std::size_t variantHash(const PolicyKeyHashes &hashes, unsigned variant);
+    static PolicyKeyIds variantIds(const PolicyKey &key, unsigned variant);
+    static bool matchesVariant(const PolicyKey &policyKey, const PolicyKey &key,
+                               unsigned variant);
 };
 
 } /* namespace Cynara */
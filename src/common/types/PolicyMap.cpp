@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/common/types/PolicyMap.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file contains implementation of open addressing hash table of policies
+ */
+
+#include <utility>
+
+#include <types/Policy.h>
+
+#include "PolicyMap.h"
+
+namespace Cynara {
+
+const PolicyMap::size_type PolicyMap::npos;
+const PolicyMap::Slot PolicyMap::EMPTY;
+const PolicyMap::Slot PolicyMap::TOMBSTONE;
+const PolicyMap::size_type PolicyMap::MIN_CAPACITY;
+
+const PolicyPtr *PolicyMap::find(const PolicyKeyIds &ids, std::size_t hash) const {
+    if (m_entries.empty())
+        return nullptr;
+
+    auto slot = m_slots[probe(ids, hash)];
+    return used(slot) ? &m_entries[slot].policy : nullptr;
+}
+
+const PolicyPtr *PolicyMap::find(const PolicyKey &key) const {
+    return find(PolicyKeyIds(key), PolicyKeyHelpers::hashKey(key));
+}
+
+PolicyMap::size_type PolicyMap::position(const PolicyKey &key) const {
+    if (m_entries.empty())
+        return npos;
+
+    auto slot = m_slots[probe(PolicyKeyIds(key), PolicyKeyHelpers::hashKey(key))];
+    return used(slot) ? slot : npos;
+}
+
+PolicyPtr PolicyMap::insert(PolicyPtr policy) {
+    reserveForInsert();
+
+    PolicyKeyIds ids(policy->key());
+    std::size_t hash = PolicyKeyHelpers::hashKey(policy->key());
+    auto slot = m_slots[probe(ids, hash)];
+    if (used(slot)) {
+        std::swap(m_entries[slot].policy, policy);
+        return policy;
+    }
+
+    // Key is not present, so policy may take first tombstone on probe sequence instead
+    const size_type mask = m_slots.size() - 1;
+    size_type index = hash & mask;
+    while (used(m_slots[index]))
+        index = (index + 1) & mask;
+
+    if (m_slots[index] == TOMBSTONE)
+        --m_tombstones;
+    m_slots[index] = static_cast<Slot>(m_entries.size());
+    m_entries.emplace_back(hash, ids, std::move(policy));
+    return nullptr;
+}
+
+PolicyPtr PolicyMap::erase(const PolicyKey &key) {
+    if (m_entries.empty())
+        return nullptr;
+
+    auto index = probe(PolicyKeyIds(key), PolicyKeyHelpers::hashKey(key));
+    auto position = m_slots[index];
+    if (!used(position))
+        return nullptr;
+
+    m_slots[index] = TOMBSTONE;
+    ++m_tombstones;
+    PolicyPtr erased = std::move(m_entries[position].policy);
+
+    // Last policy fills the hole, so its slot is redirected
+    const Slot last = static_cast<Slot>(m_entries.size() - 1);
+    if (position != last) {
+        const size_type mask = m_slots.size() - 1;
+        index = m_entries[last].hash & mask;
+        while (m_slots[index] != last)
+            index = (index + 1) & mask;
+        m_slots[index] = position;
+        m_entries[position] = std::move(m_entries[last]);
+    }
+    m_entries.pop_back();
+    return erased;
+}
+
+PolicyMap::size_type PolicyMap::probe(const PolicyKeyIds &ids, std::size_t hash) const {
+    // Capacity is a power of 2 and at least one slot is always empty
+    const size_type mask = m_slots.size() - 1;
+    for (size_type index = hash & mask; ; index = (index + 1) & mask) {
+        auto slot = m_slots[index];
+        if (used(slot)) {
+            const auto &entry = m_entries[slot];
+            if (entry.hash == hash && entry.ids == ids)
+                return index;
+        } else if (slot == EMPTY) {
+            return index;
+        }
+    }
+}
+
+void PolicyMap::reserve(size_type count) {
+    m_entries.reserve(count);
+    auto capacity = capacityFor(count);
+    if (capacity > m_slots.size())
+        rehash(capacity);
+}
+
+PolicyMap::size_type PolicyMap::capacityFor(size_type count) {
+    size_type capacity = MIN_CAPACITY;
+    while ((count + 1) * 2 > capacity)
+        capacity *= 2;
+    return capacity;
+}
+
+void PolicyMap::reserveForInsert(void) {
+    // Load factor, including tombstones, is kept below 3/4
+    const size_type capacity = m_slots.size();
+    if ((m_entries.size() + m_tombstones + 1) * 4 <= capacity * 3)
+        return;
+
+    rehash(capacityFor(m_entries.size() + 1));
+}
+
+void PolicyMap::rehash(size_type capacity) {
+    m_slots.assign(capacity, EMPTY);
+    const size_type mask = capacity - 1;
+    for (size_type position = 0; position < m_entries.size(); ++position) {
+        size_type index = m_entries[position].hash & mask;
+        while (m_slots[index] != EMPTY)
+            index = (index + 1) & mask;
+        m_slots[index] = static_cast<Slot>(position);
+    }
+    m_tombstones = 0;
+}
+
+} // namespace Cynara
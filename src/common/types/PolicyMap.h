@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/common/types/PolicyMap.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines open addressing hash table of policies
+ */
+
+#ifndef SRC_COMMON_TYPES_POLICYMAP_H_
+#define SRC_COMMON_TYPES_POLICYMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <types/pointers.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyKeyHelpers.h>
+
+namespace Cynara {
+
+/**
+ * Policies keyed by interned ids of their key features. Policies are kept in one
+ * contiguous array, which has no holes: erased policy is replaced by the last one.
+ * Open addressing table of positions in that array is probed linearly. Every entry
+ * caches hash and ids of key of its policy, so lookups do not touch policies other
+ * than the found one. Erased positions leave tombstones, dropped when table is rehashed.
+ */
+class PolicyMap {
+public:
+    typedef std::size_t size_type;
+
+    class const_iterator;
+
+    static const size_type npos = static_cast<size_type>(-1);
+
+    PolicyMap() : m_tombstones(0) {}
+
+    // Returns nullptr if there is no policy with key of given ids
+    const PolicyPtr *find(const PolicyKeyIds &ids, std::size_t hash) const;
+    const PolicyPtr *find(const PolicyKey &key) const;
+    // Returns position of policy with given key or npos
+    size_type position(const PolicyKey &key) const;
+
+    const PolicyPtr &at(size_type position) const {
+        return m_entries[position].policy;
+    }
+
+    // Inserts policy or replaces policy with the same key; returns replaced policy or nullptr.
+    // Inserted policy takes position size() - 1, replacing one keeps position of replaced.
+    PolicyPtr insert(PolicyPtr policy);
+    // Returns erased policy or nullptr. Last policy takes position of erased one.
+    PolicyPtr erase(const PolicyKey &key);
+    // Makes room for count policies, so inserting them does not rehash table
+    void reserve(size_type count);
+
+    const_iterator begin(void) const;
+    const_iterator end(void) const;
+
+    size_type size(void) const {
+        return m_entries.size();
+    }
+
+    bool empty(void) const {
+        return m_entries.empty();
+    }
+
+private:
+    struct Entry {
+        Entry(std::size_t hash, const PolicyKeyIds &ids, PolicyPtr policy)
+            : hash(hash), ids(ids), policy(std::move(policy)) {}
+
+        std::size_t hash;
+        PolicyKeyIds ids;
+        PolicyPtr policy;
+    };
+
+    typedef std::uint32_t Slot;
+    static const Slot EMPTY = UINT32_MAX;
+    static const Slot TOMBSTONE = UINT32_MAX - 1;
+    static const size_type MIN_CAPACITY = 8;
+
+    static bool used(Slot slot) {
+        return slot < TOMBSTONE;
+    }
+
+    // Index of slot holding key or of empty slot ending the probe sequence
+    size_type probe(const PolicyKeyIds &ids, std::size_t hash) const;
+    static size_type capacityFor(size_type count);
+    void reserveForInsert(void);
+    void rehash(size_type capacity);
+
+    std::vector<Entry> m_entries;
+    std::vector<Slot> m_slots;
+    size_type m_tombstones;
+
+public:
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef PolicyPtr value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const PolicyPtr *pointer;
+        typedef const PolicyPtr &reference;
+
+        const_iterator() : m_entry(nullptr) {}
+        explicit const_iterator(const Entry *entry) : m_entry(entry) {}
+
+        reference operator*(void) const {
+            return m_entry->policy;
+        }
+
+        pointer operator->(void) const {
+            return &m_entry->policy;
+        }
+
+        const_iterator &operator++(void) {
+            ++m_entry;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous(*this);
+            ++(*this);
+            return previous;
+        }
+
+        bool operator==(const const_iterator &other) const {
+            return m_entry == other.m_entry;
+        }
+
+        bool operator!=(const const_iterator &other) const {
+            return m_entry != other.m_entry;
+        }
+
+    private:
+        const Entry *m_entry;
+    };
+};
+
+inline PolicyMap::const_iterator PolicyMap::begin(void) const {
+    return const_iterator(m_entries.data());
+}
+
+inline PolicyMap::const_iterator PolicyMap::end(void) const {
+    return const_iterator(m_entries.data() + m_entries.size());
+}
+
+} // namespace Cynara
+
+#endif /* SRC_COMMON_TYPES_POLICYMAP_H_ */
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/db-convert/main.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       A micro-tool converting Cynara's database between text and binary format
+ */
+
+#include <exception>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include <cynara-error.h>
+
+#include <exceptions/Exception.h>
+#include <storage/InMemoryStorageBackend.h>
+
+int main(int argc, char **argv) {
+    using Cynara::InMemoryStorageBackend;
+
+    if (3 != argc) {
+        std::cerr << "Usage: " << argv[0] << " {text|binary} DATABASE_DIR/" << std::endl;
+        return CYNARA_API_INVALID_COMMANDLINE_PARAM;
+    }
+
+    const std::string formatName(argv[1]);
+    InMemoryStorageBackend::DatabaseFormat format;
+    if (formatName == "text") {
+        format = InMemoryStorageBackend::DatabaseFormat::TEXT;
+    } else if (formatName == "binary") {
+        format = InMemoryStorageBackend::DatabaseFormat::BINARY;
+    } else {
+        std::cerr << "Unknown database format: " << formatName << std::endl;
+        return CYNARA_API_INVALID_COMMANDLINE_PARAM;
+    }
+
+    std::string dbPath(argv[2]);
+    if (dbPath.empty() || dbPath.back() != '/')
+        dbPath += '/';
+
+    try {
+        InMemoryStorageBackend backend(dbPath);
+        backend.load();
+        if (backend.format() != format) {
+            backend.setFormat(format);
+            backend.save();
+        }
+    } catch (const std::bad_alloc &) {
+        std::cerr << "Database conversion could not allocate memory" << std::endl;
+        return CYNARA_API_OUT_OF_MEMORY;
+    } catch (const Cynara::Exception &ex) {
+        std::cerr << "Database conversion failed: " << ex.message() << std::endl;
+        return CYNARA_API_UNKNOWN_ERROR;
+    } catch (const std::exception &ex) {
+        std::cerr << "Database conversion failed: " << ex.what() << std::endl;
+        return CYNARA_API_UNKNOWN_ERROR;
+    }
+
+    return CYNARA_API_SUCCESS;
+}
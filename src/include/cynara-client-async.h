@@ -516,6 +516,68 @@ int cynara_async_create_simple_request(cynara_async *p_cynara, const char *clien
                                        const char *privilege, cynara_check_id *p_check_id,
                                        cynara_response_callback callback, void *user_response_data);
 
+/**
+ * \par Description:
+ * Creates access check requests to cynara service for client, user accessing many privileges.
+ * Set callback and user_response_data to be called and passed when processing of each request
+ * is finished.
+ *
+ * \par Purpose:
+ * This API should be used instead of many calls to cynara_async_create_request(), when
+ * many privileges of the same client and user have to be checked together.
+ * Responses can be received with cynara_async_process().
+ * Check ids are returned to pair requests with responses for canceling purposes.
+ *
+ * \par Typical use case:
+ * A launcher checking all privileges of an application before starting it.
+ *
+ * \par Method of function operation:
+ * For every privilege a separate request with its own check id is created, exactly like with
+ * cynara_async_create_request(), but all of them are sent to cynara service in a single frame
+ * and answered with a single response. Only requests, which cannot be resolved without
+ * consulting an external application, are sent again separately.
+ * One additional check id is reserved for the whole batch until its response is received, so
+ * count + 1 pending requests must be available.
+ *
+ * \par Sync (or) Async:
+ * This is an asynchronous API.
+ *
+ * \par Thread-safety:
+ * This function is NOT thread-safe. If functions from described API are called by multithreaded
+ * application from different threads, they must be put into protected critical section.
+ *
+ * \par Important notes:
+ * All notes of cynara_async_create_request() apply to every created request.
+ * It is guaranteed that if cynara_async_create_batch_request() function succeeds
+ * (CYNARA_API_SUCCESS) a callback will be called exactly once for every check id.
+ * If function fails, no request is generated and p_check_ids values should be ignored.
+ * String length cannot exceed CYNARA_MAX_ID_LENGTH and count cannot exceed
+ * CYNARA_MAX_VECTOR_SIZE, otherwise CYNARA_API_INVALID_PARAM will be returned.
+ *
+ * \param[in] p_cynara cynara_async structure.
+ * \param[in] client Application or process identifier.
+ * \param[in] client_session Client defined session.
+ * \param[in] user User of running client.
+ * \param[in] privileges Array of privileges that are a subject of a check.
+ * \param[in] count Number of privileges, must be greater than 0.
+ * \param[out] p_check_ids Placeholder for count check ids. If NULL, then no check ids are returned.
+ * \param[in] callback Function called when matching response is received.
+ *            If NULL then no callback will be called when response, cancel, finish
+ *            or service not availble error happens.
+ * \param[in] user_response_data User specific data, passed to callback for every request.
+ *            Can be NULL.
+ *
+ * \return CYNARA_API_SUCCESS on success,
+ *         CYNARA_API_MAX_PENDING_REQUESTS on too much pending requests,
+ *         or other negative error code on error.
+ */
+int cynara_async_create_batch_request(cynara_async *p_cynara, const char *client,
+                                      const char *client_session, const char *user,
+                                      const char *const *privileges, size_t count,
+                                      cynara_check_id *p_check_ids,
+                                      cynara_response_callback callback,
+                                      void *user_response_data);
+
 /**
  * \par Description:
  * Process events that appeared on cynara socket.
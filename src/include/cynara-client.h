@@ -289,6 +289,53 @@ int cynara_check(cynara *p_cynara, const char *client, const char *client_sessio
 int cynara_simple_check(cynara *p_cynara, const char *client, const char *client_session,
                         const char *user, const char *privilege);
 
+/**
+ * \par Description:
+ * Check client, user access for many privileges at once.
+ *
+ * \par Purpose:
+ * This API should be used to check if a user running application identified as client
+ * has access to each of given privileges, when many privileges have to be checked together.
+ *
+ * \par Typical use case:
+ * A launcher checking all privileges of an application before starting it.
+ *
+ * \par Method of function operation:
+ * Result of every privilege is the same as result of cynara_check() called for it. Privileges
+ * not found in cache are sent to cynara in a single request and are answered with a single
+ * response. Only privileges, which cannot be resolved without consulting an external
+ * application, are checked again one by one, like in cynara_check().
+ *
+ * \par Sync (or) Async:
+ * This is a Synchronous API.
+ *
+ * \par Thread-safeness:
+ * This function is NOT thread-safe. If functions from described API are called by multithreaded
+ * application from different threads, they must be put into mutex protected critical section.
+ *
+ * \par Important notes:
+ * An external application may be launched to allow user interaction in granting or denying access.
+ * Call to cynara_check_batch needs cynara structure to be created first with call to
+ * cynara_initialize().
+ * String length cannot exceed CYNARA_MAX_ID_LENGTH and count cannot exceed
+ * CYNARA_MAX_VECTOR_SIZE, otherwise CYNARA_API_INVALID_PARAM will be returned.
+ * Values of results are defined only, when CYNARA_API_SUCCESS is returned.
+ *
+ * \param[in] p_cynara Cynara structure.
+ * \param[in] client Application or process identifier.
+ * \param[in] client_session Session of client (connection, launch).
+ * \param[in] user User running client.
+ * \param[in] privileges Array of privileges that are a subject of a check.
+ * \param[in] count Number of privileges.
+ * \param[out] results Array of count elements for results. CYNARA_API_ACCESS_ALLOWED,
+ *              CYNARA_API_ACCESS_DENIED or other error code is set for every privilege.
+ *
+ * \return CYNARA_API_SUCCESS when all privileges were checked, or other error code on error.
+ */
+int cynara_check_batch(cynara *p_cynara, const char *client, const char *client_session,
+                       const char *user, const char *const *privileges, size_t count,
+                       int *results);
+
 #ifdef __cplusplus
 }
 #endif
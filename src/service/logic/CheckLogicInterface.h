@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/service/logic/CheckLogicInterface.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines interface of logic used by check workers
+ */
+
+#ifndef SRC_SERVICE_LOGIC_CHECKLOGICINTERFACE_H_
+#define SRC_SERVICE_LOGIC_CHECKLOGICINTERFACE_H_
+
+#include <memory>
+#include <vector>
+
+#include <request/CheckBatchRequest.h>
+#include <request/CheckRequest.h>
+#include <request/RequestContext.h>
+#include <request/RequestTaker.h>
+#include <request/SimpleCheckRequest.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+
+namespace Cynara {
+
+/*
+ * Check is split into two phases. checkStorage() evaluates the key against storage only
+ * and is safe to be called from many threads concurrently. finishCheck(),
+ * finishSimpleCheck() and finishCheckBatch() complete request (plugins, agents, response)
+ * and must be called from the main thread.
+ */
+class CheckLogicInterface : public RequestTaker {
+public:
+    virtual ~CheckLogicInterface() {};
+
+    virtual PolicyResult checkStorage(const PolicyKey &key) = 0;
+    virtual void finishCheck(const RequestContext &context, const CheckRequest &request,
+                             const PolicyResult &storageResult) = 0;
+    virtual void finishSimpleCheck(const RequestContext &context,
+                                   const SimpleCheckRequest &request,
+                                   const PolicyResult &storageResult) = 0;
+    virtual void finishCheckBatch(const RequestContext &context, const CheckBatchRequest &request,
+                                  const std::vector<PolicyResult> &storageResults) = 0;
+};
+
+typedef std::shared_ptr<CheckLogicInterface> CheckLogicInterfacePtr;
+
+} // namespace Cynara
+
+#endif /* SRC_SERVICE_LOGIC_CHECKLOGICINTERFACE_H_ */
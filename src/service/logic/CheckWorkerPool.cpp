@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/service/logic/CheckWorkerPool.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file implements pool of threads evaluating check requests against storage
+ */
+
+#include <cinttypes>
+#include <errno.h>
+#include <exception>
+#include <signal.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <attributes/attributes.h>
+#include <exceptions/Exception.h>
+#include <exceptions/InitException.h>
+#include <log/log.h>
+#include <request/AdminCheckRequest.h>
+#include <request/AgentActionRequest.h>
+#include <request/AgentRegisterRequest.h>
+#include <request/CancelRequest.h>
+#include <request/CheckBatchRequest.h>
+#include <request/CheckRequest.h>
+#include <request/DescriptionListRequest.h>
+#include <request/EraseRequest.h>
+#include <request/InsertOrUpdateBucketRequest.h>
+#include <request/InvalidationSubscribeRequest.h>
+#include <request/ListRequest.h>
+#include <request/RemoveBucketRequest.h>
+#include <request/SetPoliciesRequest.h>
+#include <request/SignalRequest.h>
+#include <request/SimpleCheckRequest.h>
+#include <types/PolicyType.h>
+
+#include "CheckWorkerPool.h"
+
+namespace Cynara {
+
+CheckWorkerPool::CheckWorkerPool(unsigned int workersCount)
+    : m_workersCount(workersCount), m_stopping(false) {
+    m_notificationFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_notificationFd == -1) {
+        UNUSED int err = errno;
+        LOGE("Error during eventfd creation: <%s>", strerror(err));
+        throw InitException();
+    }
+}
+
+CheckWorkerPool::~CheckWorkerPool() {
+    stop();
+    close(m_notificationFd);
+}
+
+void CheckWorkerPool::start(void) {
+    LOGI("Starting [%u] check workers", m_workersCount);
+
+    // Workers inherit signal mask of creating thread. Block all signals,
+    // so they are always delivered to main thread through its signalfd.
+    sigset_t allSignals, oldMask;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_BLOCK, &allSignals, &oldMask);
+
+    for (unsigned int i = 0; i < m_workersCount; ++i)
+        m_workers.push_back(std::thread(&CheckWorkerPool::workerLoop, this));
+
+    pthread_sigmask(SIG_SETMASK, &oldMask, nullptr);
+}
+
+void CheckWorkerPool::stop(void) {
+    {
+        std::lock_guard<std::mutex> lock(m_jobsMutex);
+        m_stopping = true;
+    }
+    m_jobsCondition.notify_all();
+
+    for (auto &worker : m_workers)
+        worker.join();
+    m_workers.clear();
+}
+
+void CheckWorkerPool::workerLoop(void) {
+    while (true) {
+        std::unique_lock<std::mutex> jobsLock(m_jobsMutex);
+        m_jobsCondition.wait(jobsLock, [this] (void) -> bool {
+            return m_stopping || !m_jobs.empty();
+        });
+        if (m_stopping)
+            return;
+        PendingRequestPtr pending(std::move(m_jobs.front()));
+        m_jobs.pop_front();
+        jobsLock.unlock();
+
+        // Results are written before pending request is handed back to main thread
+        evaluate(*pending);
+
+        {
+            std::lock_guard<std::mutex> resultsLock(m_resultsMutex);
+            m_results.push_back(std::move(pending));
+        }
+
+        uint64_t one = 1;
+        if (TEMP_FAILURE_RETRY(write(m_notificationFd, &one, sizeof(one))) == -1) {
+            UNUSED int err = errno;
+            LOGE("Error during notifying main thread about check result: <%s>", strerror(err));
+        }
+    }
+}
+
+PolicyResult CheckWorkerPool::checkStorage(const PolicyKey &key) {
+    try {
+        return m_logic->checkStorage(key);
+    } catch (const std::exception &ex) {
+        LOGE("Checking policy key <%s> in worker failed: <%s>",
+             key.toString().c_str(), ex.what());
+    }
+    return PolicyResult(PredefinedPolicyType::DENY);
+}
+
+void CheckWorkerPool::evaluate(PendingRequest &pending) {
+    switch (pending.m_type) {
+    case PendingType::CHECK:
+        pending.m_result = checkStorage(
+                static_cast<const CheckRequest &>(*pending.m_request).key());
+        break;
+    case PendingType::SIMPLE_CHECK:
+        pending.m_result = checkStorage(
+                static_cast<const SimpleCheckRequest &>(*pending.m_request).key());
+        break;
+    case PendingType::CHECK_BATCH: {
+            const auto &keys = static_cast<const CheckBatchRequest &>(*pending.m_request).keys();
+            pending.m_batchResults.reserve(keys.size());
+            for (const auto &key : keys)
+                pending.m_batchResults.push_back(checkStorage(key));
+        }
+        break;
+    case PendingType::OTHER:
+        break;
+    }
+}
+
+void CheckWorkerPool::dispatch(const RequestPtr &request, const RequestContext &context) {
+    m_dispatchedRequest = request;
+    request->execute(*this, context);
+    m_dispatchedRequest.reset();
+}
+
+void CheckWorkerPool::processResults(void) {
+    uint64_t counter;
+    if (TEMP_FAILURE_RETRY(read(m_notificationFd, &counter, sizeof(counter))) == -1) {
+        if (errno == EAGAIN)
+            return;
+        UNUSED int err = errno;
+        LOGE("Error during reading check workers notification: <%s>", strerror(err));
+    }
+
+    std::vector<PendingRequestPtr> results;
+    {
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        results.swap(m_results);
+    }
+
+    for (auto &pending : results) {
+        pending->m_ready = true;
+        flush(pending->m_linkId);
+    }
+}
+
+void CheckWorkerPool::enqueueCheck(PendingType type, const RequestContext &context) {
+    LinkId linkId = context.responseQueue();
+    auto pending = std::make_shared<PendingRequest>(type, m_dispatchedRequest, context, linkId);
+    m_pending[linkId].push_back(pending);
+
+    {
+        std::lock_guard<std::mutex> lock(m_jobsMutex);
+        m_jobs.push_back(pending);
+    }
+    m_jobsCondition.notify_one();
+}
+
+void CheckWorkerPool::enqueueOther(const RequestContext &context) {
+    LinkId linkId = context.responseQueue();
+    auto pending = std::make_shared<PendingRequest>(PendingType::OTHER, m_dispatchedRequest,
+                                                    context, linkId);
+    pending->m_ready = true;
+    m_pending[linkId].push_back(pending);
+}
+
+bool CheckWorkerPool::isBusy(const LinkId &linkId) const {
+    return m_pending.find(linkId) != m_pending.end();
+}
+
+void CheckWorkerPool::flush(const LinkId &linkId) {
+    // Finishing a request may close links, so queue is looked up in every iteration
+    while (true) {
+        auto it = m_pending.find(linkId);
+        if (it == m_pending.end())
+            return;
+
+        auto &queue = it->second;
+        if (queue.empty()) {
+            m_pending.erase(it);
+            return;
+        }
+        if (!queue.front()->m_ready)
+            return;
+
+        PendingRequestPtr pending = queue.front();
+        queue.pop_front();
+        finish(pending);
+    }
+}
+
+void CheckWorkerPool::finish(const PendingRequestPtr &pending) {
+    try {
+        switch (pending->m_type) {
+        case PendingType::CHECK:
+            m_logic->finishCheck(pending->m_context,
+                                 static_cast<const CheckRequest &>(*pending->m_request),
+                                 pending->m_result);
+            break;
+        case PendingType::SIMPLE_CHECK:
+            m_logic->finishSimpleCheck(pending->m_context,
+                                       static_cast<const SimpleCheckRequest &>(
+                                               *pending->m_request),
+                                       pending->m_result);
+            break;
+        case PendingType::CHECK_BATCH:
+            m_logic->finishCheckBatch(pending->m_context,
+                                      static_cast<const CheckBatchRequest &>(
+                                              *pending->m_request),
+                                      pending->m_batchResults);
+            break;
+        case PendingType::OTHER:
+            pending->m_request->execute(*m_logic, pending->m_context);
+            break;
+        }
+    } catch (const Exception &ex) {
+        LOGE("Error finishing request [%" PRIu16 "]: <%s>",
+             pending->m_request->sequenceNumber(), ex.what());
+    }
+}
+
+template <typename RequestType>
+void CheckWorkerPool::executeInOrder(const RequestContext &context, const RequestType &request) {
+    if (isBusy(context.responseQueue())) {
+        enqueueOther(context);
+        return;
+    }
+    m_logic->execute(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context, const AdminCheckRequest &request) {
+    executeInOrder(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context, const AgentActionRequest &request) {
+    executeInOrder(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context,
+                              const AgentRegisterRequest &request) {
+    executeInOrder(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context, const CancelRequest &request) {
+    executeInOrder(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context,
+                              const CheckBatchRequest &request UNUSED) {
+    enqueueCheck(PendingType::CHECK_BATCH, context);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context,
+                              const CheckRequest &request UNUSED) {
+    enqueueCheck(PendingType::CHECK, context);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context,
+                              const DescriptionListRequest &request) {
+    executeInOrder(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context, const EraseRequest &request) {
+    executeInOrder(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context,
+                              const InsertOrUpdateBucketRequest &request) {
+    executeInOrder(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context,
+                              const InvalidationSubscribeRequest &request) {
+    executeInOrder(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context, const ListRequest &request) {
+    executeInOrder(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context, const RemoveBucketRequest &request) {
+    executeInOrder(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context, const SetPoliciesRequest &request) {
+    executeInOrder(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context, const SignalRequest &request) {
+    executeInOrder(context, request);
+}
+
+void CheckWorkerPool::execute(const RequestContext &context,
+                              const SimpleCheckRequest &request UNUSED) {
+    enqueueCheck(PendingType::SIMPLE_CHECK, context);
+}
+
+void CheckWorkerPool::contextClosed(const RequestContext &context) {
+    m_pending.erase(context.responseQueue());
+    m_logic->contextClosed(context);
+}
+
+} // namespace Cynara
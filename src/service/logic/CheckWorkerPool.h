@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/service/logic/CheckWorkerPool.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines pool of threads evaluating check requests against storage
+ */
+
+#ifndef SRC_SERVICE_LOGIC_CHECKWORKERPOOL_H_
+#define SRC_SERVICE_LOGIC_CHECKWORKERPOOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <logic/CheckLogicInterface.h>
+#include <request/pointers.h>
+#include <request/RequestContext.h>
+#include <request/RequestTaker.h>
+#include <types/Link.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+
+namespace Cynara {
+
+/**
+ * CheckWorkerPool stands in front of Logic in the main (I/O) thread. Storage part of
+ * CheckRequest, SimpleCheckRequest and CheckBatchRequest is evaluated by worker threads,
+ * everything else is done by Logic in the main thread. Requests received on a single link are
+ * always completed in order they were received, so responses keep request order per connection.
+ */
+class CheckWorkerPool : public RequestTaker {
+public:
+    CheckWorkerPool(unsigned int workersCount);
+    virtual ~CheckWorkerPool();
+
+    void bindLogic(CheckLogicInterfacePtr logic) {
+        m_logic = logic;
+    }
+
+    void unbindAll(void) {
+        m_logic.reset();
+    }
+
+    void start(void);
+    void stop(void);
+
+    int notificationFd(void) const {
+        return m_notificationFd;
+    }
+
+    void dispatch(const RequestPtr &request, const RequestContext &context);
+    void processResults(void);
+
+    virtual void execute(const RequestContext &context, const AdminCheckRequest &request);
+    virtual void execute(const RequestContext &context, const AgentActionRequest &request);
+    virtual void execute(const RequestContext &context, const AgentRegisterRequest &request);
+    virtual void execute(const RequestContext &context, const CancelRequest &request);
+    virtual void execute(const RequestContext &context, const CheckBatchRequest &request);
+    virtual void execute(const RequestContext &context, const CheckRequest &request);
+    virtual void execute(const RequestContext &context, const DescriptionListRequest &request);
+    virtual void execute(const RequestContext &context, const EraseRequest &request);
+    virtual void execute(const RequestContext &context, const InsertOrUpdateBucketRequest &request);
+    virtual void execute(const RequestContext &context,
+                         const InvalidationSubscribeRequest &request);
+    virtual void execute(const RequestContext &context, const ListRequest &request);
+    virtual void execute(const RequestContext &context, const RemoveBucketRequest &request);
+    virtual void execute(const RequestContext &context, const SetPoliciesRequest &request);
+    virtual void execute(const RequestContext &context, const SignalRequest &request);
+    virtual void execute(const RequestContext &context, const SimpleCheckRequest &request);
+
+    virtual void contextClosed(const RequestContext &context);
+
+private:
+    enum class PendingType {
+        CHECK,
+        SIMPLE_CHECK,
+        CHECK_BATCH,
+        OTHER
+    };
+
+    struct PendingRequest {
+        PendingRequest(PendingType type, const RequestPtr &request,
+                       const RequestContext &context, const LinkId &linkId)
+            : m_type(type), m_request(request), m_context(context), m_linkId(linkId),
+              m_ready(false) {
+        }
+
+        PendingType m_type;
+        RequestPtr m_request;
+        RequestContext m_context;
+        LinkId m_linkId;
+        bool m_ready;
+        PolicyResult m_result;
+        std::vector<PolicyResult> m_batchResults;
+    };
+    typedef std::shared_ptr<PendingRequest> PendingRequestPtr;
+
+    unsigned int m_workersCount;
+    CheckLogicInterfacePtr m_logic;
+    RequestPtr m_dispatchedRequest;
+    std::map<LinkId, std::deque<PendingRequestPtr>> m_pending;
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_jobsMutex;
+    std::condition_variable m_jobsCondition;
+    std::deque<PendingRequestPtr> m_jobs;
+    bool m_stopping;
+
+    std::mutex m_resultsMutex;
+    std::vector<PendingRequestPtr> m_results;
+    int m_notificationFd;
+
+    void workerLoop(void);
+    PolicyResult checkStorage(const PolicyKey &key);
+    void evaluate(PendingRequest &pending);
+    void enqueueCheck(PendingType type, const RequestContext &context);
+    void enqueueOther(const RequestContext &context);
+    void finish(const PendingRequestPtr &pending);
+    void flush(const LinkId &linkId);
+    bool isBusy(const LinkId &linkId) const;
+
+    template <typename RequestType>
+    void executeInOrder(const RequestContext &context, const RequestType &request);
+};
+
+} // namespace Cynara
+
+#endif /* SRC_SERVICE_LOGIC_CHECKWORKERPOOL_H_ */
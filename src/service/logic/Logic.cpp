@@ -32,6 +32,7 @@
 #include <common.h>
 #include <log/log.h>
 #include <exceptions/BucketNotExistsException.h>
+#include <exceptions/ContextErrorException.h>
 #include <exceptions/DatabaseCorruptedException.h>
 #include <exceptions/DatabaseException.h>
 #include <exceptions/DefaultBucketDeletionException.h>
@@ -45,10 +46,12 @@
 #include <request/AgentActionRequest.h>
 #include <request/AgentRegisterRequest.h>
 #include <request/CancelRequest.h>
+#include <request/CheckBatchRequest.h>
 #include <request/CheckRequest.h>
 #include <request/DescriptionListRequest.h>
 #include <request/EraseRequest.h>
 #include <request/InsertOrUpdateBucketRequest.h>
+#include <request/InvalidationSubscribeRequest.h>
 #include <request/ListRequest.h>
 #include <request/RemoveBucketRequest.h>
 #include <request/RequestContext.h>
@@ -58,6 +61,7 @@
 #include <response/AdminCheckResponse.h>
 #include <response/AgentRegisterResponse.h>
 #include <response/CancelResponse.h>
+#include <response/CheckBatchResponse.h>
 #include <response/CheckResponse.h>
 #include <response/CodeResponse.h>
 #include <response/DescriptionListResponse.h>
@@ -78,7 +82,9 @@
 
 namespace Cynara {
 
-Logic::Logic() : m_dbCorrupted(false) {
+const std::size_t Logic::MAX_JOURNAL_SIZE = 1 << 20;
+
+Logic::Logic() : m_dbCorrupted(false), m_policiesChanged(false) {
 }
 
 Logic::~Logic() {
@@ -172,8 +178,26 @@ void Logic::execute(const RequestContext &context, const CancelRequest &request)
     context.returnResponse(CancelResponse(request.sequenceNumber()));
 }
 
+void Logic::execute(const RequestContext &context, const CheckBatchRequest &request) {
+    std::vector<PolicyResult> storageResults;
+    storageResults.reserve(request.keys().size());
+    for (const auto &key : request.keys())
+        storageResults.push_back(checkStorage(key));
+
+    finishCheckBatch(context, request, storageResults);
+}
+
 void Logic::execute(const RequestContext &context, const CheckRequest &request) {
-    PolicyResult result(PredefinedPolicyType::DENY);
+    finishCheck(context, request, checkStorage(request.key()));
+}
+
+PolicyResult Logic::checkStorage(const PolicyKey &key) {
+    return (m_dbCorrupted ? PredefinedPolicyType::DENY : m_storage->checkPolicy(key));
+}
+
+void Logic::finishCheck(const RequestContext &context, const CheckRequest &request,
+                        const PolicyResult &storageResult) {
+    PolicyResult result(storageResult);
     if (check(context, request.key(), request.sequenceNumber(), result)) {
         m_auditLog.log(request.key(), result);
         context.returnResponse(CheckResponse(result, request.sequenceNumber()));
@@ -188,8 +212,6 @@ bool Logic::check(const RequestContext &context, const PolicyKey &key,
         return false;
     }
 
-    result = (m_dbCorrupted ? PredefinedPolicyType::DENY : m_storage->checkPolicy(key));
-
     switch (result.policyType()) {
         case PredefinedPolicyType::ALLOW :
             LOGD("check of policy key <%s> returned ALLOW", key.toString().c_str());
@@ -310,7 +332,7 @@ void Logic::execute(const RequestContext &context, const EraseRequest &request)
         }
     }
 
-    context.returnResponse(CodeResponse(code, request.sequenceNumber()));
+    returnCodeResponse(context, code, request.sequenceNumber());
 }
 
 void Logic::execute(const RequestContext &context, const InsertOrUpdateBucketRequest &request) {
@@ -334,7 +356,12 @@ void Logic::execute(const RequestContext &context, const InsertOrUpdateBucketReq
         }
     }
 
-    context.returnResponse(CodeResponse(code, request.sequenceNumber()));
+    returnCodeResponse(context, code, request.sequenceNumber());
+}
+
+void Logic::execute(const RequestContext &context,
+                    const InvalidationSubscribeRequest &request UNUSED) {
+    m_socketManager->subscribeInvalidation(context.responseQueue());
 }
 
 void Logic::execute(const RequestContext &context, const ListRequest &request) {
@@ -372,7 +399,7 @@ void Logic::execute(const RequestContext &context, const RemoveBucketRequest &re
             code = CodeResponse::Code::NOT_ALLOWED;
         }
     }
-    context.returnResponse(CodeResponse(code, request.sequenceNumber()));
+    returnCodeResponse(context, code, request.sequenceNumber());
 }
 
 void Logic::execute(const RequestContext &context, const SetPoliciesRequest &request) {
@@ -395,14 +422,40 @@ void Logic::execute(const RequestContext &context, const SetPoliciesRequest &req
         }
     }
 
-    context.returnResponse(CodeResponse(code, request.sequenceNumber()));
+    returnCodeResponse(context, code, request.sequenceNumber());
 }
 
 void Logic::execute(const RequestContext &context, const SimpleCheckRequest &request) {
+    finishSimpleCheck(context, request, checkStorage(request.key()));
+}
+
+void Logic::finishSimpleCheck(const RequestContext &context, const SimpleCheckRequest &request,
+                              const PolicyResult &storageResult) {
+    PolicyResult result(storageResult);
+    int retValue = simpleCheck(request.key(), result);
+    m_auditLog.log(request.key(), result);
+    context.returnResponse(SimpleCheckResponse(retValue, result,
+                                               request.sequenceNumber()));
+}
+
+void Logic::finishCheckBatch(const RequestContext &context, const CheckBatchRequest &request,
+                             const std::vector<PolicyResult> &storageResults) {
+    const auto &keys = request.keys();
+    CheckBatchResponse::Answers answers;
+    answers.reserve(keys.size());
+
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        PolicyResult result(storageResults[i]);
+        int retValue = simpleCheck(keys[i], result);
+        m_auditLog.log(keys[i], result);
+        answers.push_back(CheckBatchResponse::Answer(retValue, result));
+    }
+
+    context.returnResponse(CheckBatchResponse(std::move(answers), request.sequenceNumber()));
+}
+
+int Logic::simpleCheck(const PolicyKey &key, PolicyResult &result) {
     int retValue = CYNARA_API_SUCCESS;
-    PolicyResult result;
-    PolicyKey key = request.key();
-    result = m_storage->checkPolicy(key);
 
     switch (result.policyType()) {
     case PredefinedPolicyType::ALLOW:
@@ -448,9 +501,7 @@ void Logic::execute(const RequestContext &context, const SimpleCheckRequest &req
         }
     }
     }
-    m_auditLog.log(request.key(), result);
-    context.returnResponse(SimpleCheckResponse(retValue, result,
-                                               request.sequenceNumber()));
+    return retValue;
 }
 
 void Logic::checkPoliciesTypes(const std::map<PolicyBucketId, std::vector<Policy>> &policies,
@@ -488,12 +539,70 @@ void Logic::contextClosed(const RequestContext &context) {
 }
 
 void Logic::onPoliciesChanged(void) {
-    m_storage->save();
-    m_socketManager->disconnectAllClients();
+    m_policiesChanged = true;
     m_pluginManager->invalidateAll();
     //todo remove all saved contexts (if there will be any saved contexts)
 }
 
+void Logic::returnCodeResponse(const RequestContext &context, CodeResponse::Code code,
+                               ProtocolFrameSequenceNumber sequenceNumber) {
+    // Keep order of answers, when some modifications still wait for commit
+    if (m_policiesChanged) {
+        m_uncommittedResponses.push_back({context, code, sequenceNumber});
+        return;
+    }
+
+    context.returnResponse(CodeResponse(code, sequenceNumber));
+}
+
+void Logic::commitPolicyChanges(void) {
+    if (!m_policiesChanged)
+        return;
+
+    bool committed = true;
+    try {
+        m_storage->commit();
+    } catch (const DatabaseCorruptedException &) {
+        LOGE("Committing policy changes failed and database cannot be reloaded");
+        m_dbCorrupted = true;
+        committed = false;
+    } catch (const DatabaseException &ex) {
+        LOGE("Committing policy changes failed: <%s>", ex.message().c_str());
+        committed = false;
+    }
+    m_policiesChanged = false;
+
+    // Clients are notified once for all changes done in main loop pass
+    m_socketManager->invalidateClientCaches();
+
+    for (const auto &response : m_uncommittedResponses) {
+        auto code = response.m_code;
+        if (!committed && code == CodeResponse::Code::OK)
+            code = CodeResponse::Code::FAILED;
+        try {
+            response.m_context.returnResponse(CodeResponse(code, response.m_sequenceNumber));
+        } catch (const ContextErrorException &) {
+            LOGD("Admin disconnected before its request was committed");
+        }
+    }
+    m_uncommittedResponses.clear();
+
+    if (m_storage->journalSize() > MAX_JOURNAL_SIZE)
+        compactPolicies();
+}
+
+bool Logic::compactionPending(void) const {
+    return m_storage && m_storage->journalSize() > 0;
+}
+
+void Logic::compactPolicies(void) {
+    try {
+        m_storage->save();
+    } catch (const DatabaseException &ex) {
+        LOGE("Compacting policy journal failed: <%s>", ex.message().c_str());
+    }
+}
+
 void Logic::handleAgentTalkerDisconnection(const AgentTalkerPtr &agentTalkerPtr) {
     CheckContextPtr checkContextPtr = m_checkRequestManager.getContext(agentTalkerPtr);
     if (checkContextPtr == nullptr) {
@@ -25,6 +25,8 @@
 #ifndef SRC_SERVICE_LOGIC_LOGIC_H_
 #define SRC_SERVICE_LOGIC_LOGIC_H_
 
+#include <atomic>
+#include <cstddef>
 #include <map>
 #include <vector>
 
@@ -35,17 +37,21 @@
 #include <types/PolicyResult.h>
 #include <types/PolicyType.h>
 
+#include <logic/CheckLogicInterface.h>
 #include <main/pointers.h>
 #include <plugin/PluginManager.h>
+#include <protocol/ProtocolFrameHeader.h>
 #include <request/CheckRequestManager.h>
 #include <request/pointers.h>
+#include <request/RequestContext.h>
 #include <request/RequestTaker.h>
+#include <response/CodeResponse.h>
 
 #include <cynara-plugin.h>
 
 namespace Cynara {
 
-class Logic : public RequestTaker {
+class Logic : public CheckLogicInterface {
 public:
     Logic();
     virtual ~Logic();
@@ -77,10 +83,13 @@ public:
     virtual void execute(const RequestContext &context, const AgentActionRequest &request);
     virtual void execute(const RequestContext &context, const AgentRegisterRequest &request);
     virtual void execute(const RequestContext &context, const CancelRequest &request);
+    virtual void execute(const RequestContext &context, const CheckBatchRequest &request);
     virtual void execute(const RequestContext &context, const CheckRequest &request);
     virtual void execute(const RequestContext &context, const DescriptionListRequest &request);
     virtual void execute(const RequestContext &context, const EraseRequest &request);
     virtual void execute(const RequestContext &context, const InsertOrUpdateBucketRequest &request);
+    virtual void execute(const RequestContext &context,
+                         const InvalidationSubscribeRequest &request);
     virtual void execute(const RequestContext &context, const ListRequest &request);
     virtual void execute(const RequestContext &context, const RemoveBucketRequest &request);
     virtual void execute(const RequestContext &context, const SetPoliciesRequest &request);
@@ -90,19 +99,49 @@ public:
     virtual void contextClosed(const RequestContext &context);
     virtual void loadDb(void);
 
+    virtual PolicyResult checkStorage(const PolicyKey &key);
+    virtual void finishCheck(const RequestContext &context, const CheckRequest &request,
+                             const PolicyResult &storageResult);
+    virtual void finishSimpleCheck(const RequestContext &context,
+                                   const SimpleCheckRequest &request,
+                                   const PolicyResult &storageResult);
+    virtual void finishCheckBatch(const RequestContext &context, const CheckBatchRequest &request,
+                                  const std::vector<PolicyResult> &storageResults);
+
+    /*
+     * Policy modifications are journaled, not saved. All modifications done while handling
+     * requests of one main loop pass are committed together and only then admin requests are
+     * answered. Journal is compacted into database when service is idle or journal grows big.
+     */
+    void commitPolicyChanges(void);
+    bool compactionPending(void) const;
+    void compactPolicies(void);
+
 private:
+    struct UncommittedResponse {
+        RequestContext m_context;
+        CodeResponse::Code m_code;
+        ProtocolFrameSequenceNumber m_sequenceNumber;
+    };
+
+    static const std::size_t MAX_JOURNAL_SIZE;
+
     AgentManagerPtr m_agentManager;
     CheckRequestManager m_checkRequestManager;
     PluginManagerPtr m_pluginManager;
     StoragePtr m_storage;
     SocketManagerPtr m_socketManager;
     AuditLog m_auditLog;
-    bool m_dbCorrupted;
+    // Read by check workers, while main loop may set it on failed commit
+    std::atomic<bool> m_dbCorrupted;
+    bool m_policiesChanged;
+    std::vector<UncommittedResponse> m_uncommittedResponses;
 
     bool check(const RequestContext &context, const PolicyKey &key,
                ProtocolFrameSequenceNumber checkId, PolicyResult &result);
     bool pluginCheck(const RequestContext &context, const PolicyKey &key,
                      ProtocolFrameSequenceNumber checkId, PolicyResult &result);
+    int simpleCheck(const PolicyKey &key, PolicyResult &result);
     bool update(const PolicyKey &key, ProtocolFrameSequenceNumber checkId,
                 const PluginData &agentData, const RequestContext &request,
                 const ServicePluginInterfacePtr &plugin);
@@ -114,6 +153,8 @@ private:
     void handleClientDisconnection(const CheckContextPtr &checkContextPtr);
 
     void onPoliciesChanged(void);
+    void returnCodeResponse(const RequestContext &context, CodeResponse::Code code,
+                            ProtocolFrameSequenceNumber sequenceNumber);
 };
 
 } // namespace Cynara
@@ -21,6 +21,7 @@
  */
 
 #include <cstdlib>
+#include <cstring>
 #include <getopt.h>
 #include <grp.h>
 #include <iostream>
@@ -46,7 +47,9 @@ struct CmdLineOptions handleCmdlineOptions(int argc, char * const *argv) {
               << CmdlineOpt::Daemon
               << CmdlineOpt::Mask << ":"
               << CmdlineOpt::User << ":"
-              << CmdlineOpt::Group << ":";
+              << CmdlineOpt::Group << ":"
+              << CmdlineOpt::Workers << ":"
+              << CmdlineOpt::DecisionIndex;
 
     const struct option longOpts[] = {
         { "help",       no_argument,          NULL, CmdlineOpt::Help },
@@ -55,6 +58,8 @@ struct CmdLineOptions handleCmdlineOptions(int argc, char * const *argv) {
         { "mask",       required_argument,    NULL, CmdlineOpt::Mask },
         { "user",       required_argument,    NULL, CmdlineOpt::User },
         { "group",      required_argument,    NULL, CmdlineOpt::Group },
+        { "workers",    required_argument,    NULL, CmdlineOpt::Workers },
+        { "decision-index", no_argument,      NULL, CmdlineOpt::DecisionIndex },
         { NULL, 0, NULL, 0 }
     };
 
@@ -63,7 +68,9 @@ struct CmdLineOptions handleCmdlineOptions(int argc, char * const *argv) {
                                  .m_daemon = false,
                                  .m_mask = static_cast<mode_t>(-1),
                                  .m_uid = static_cast<uid_t>(-1),
-                                 .m_gid = static_cast<gid_t>(-1) };
+                                 .m_gid = static_cast<gid_t>(-1),
+                                 .m_workers = 0,
+                                 .m_decisionIndex = false };
 
     optind = 0; // On entry to `getopt', zero means this is the first call; initialize.
     int opt;
@@ -109,6 +116,18 @@ struct CmdLineOptions handleCmdlineOptions(int argc, char * const *argv) {
                     return ret;
                 }
                 break;
+            case CmdlineOpt::Workers:
+                ret.m_workers = getWorkers(optarg);
+                if (ret.m_workers == -1) {
+                    printInvalidParam(execName, optarg);
+                    ret.m_error = true;
+                    ret.m_exit = true;
+                    return ret;
+                }
+                break;
+            case CmdlineOpt::DecisionIndex:
+                ret.m_decisionIndex = true;
+                break;
             case ':': // Missing argument
                 ret.m_error = true;
                 ret.m_exit = true;
@@ -116,6 +135,7 @@ struct CmdLineOptions handleCmdlineOptions(int argc, char * const *argv) {
                     case CmdlineOpt::Mask:
                     case CmdlineOpt::User:
                     case CmdlineOpt::Group:
+                    case CmdlineOpt::Workers:
                         printMissingArgument(execName, argv[optind - 1]);
                         return ret;
                 }
@@ -147,6 +167,10 @@ void printHelp(const std::string &execName) {
                  "[by default uid is not changed]" << std::endl;
     std::cout << "  -g, --group=GROUP            change group to GROUP "
                  "[by default gid is not changed]" << std::endl;
+    std::cout << "  -w, --workers=COUNT          evaluate checks in COUNT worker threads "
+                 "[by default checks are evaluated in main thread]" << std::endl;
+    std::cout << "  -i, --decision-index         evaluate checks with compiled index "
+                 "of all buckets [by default index is not used]" << std::endl;
 }
 
 void printVersion(void) {
@@ -207,6 +231,20 @@ gid_t getGid(const char *group) {
     return ret;
 }
 
+int getWorkers(const char *workers) {
+    int ret = -1;
+    if (!workers)
+        return ret;
+    try {
+        size_t pos;
+        ret = std::stoi(workers, &pos);
+        if (pos != strlen(workers) || ret < 0)
+            ret = -1;
+    } catch (...) {
+    }
+    return ret;
+}
+
 } /* namespace CmdlineOpts */
 
 } /* namespace Cynara */
@@ -38,6 +38,8 @@ enum CmdlineOpt {
     Mask = 'm',
     User = 'u',
     Group = 'g',
+    Workers = 'w',
+    DecisionIndex = 'i',
 };
 
 struct CmdLineOptions {
@@ -48,6 +50,8 @@ struct CmdLineOptions {
     mode_t m_mask;
     uid_t m_uid;
     gid_t m_gid;
+    int m_workers;
+    bool m_decisionIndex;
 };
 
 std::ostream &operator<<(std::ostream &os, CmdlineOpt opt);
@@ -61,6 +65,7 @@ void printMissingArgument(const std::string &execName, const std::string &option
 mode_t getMask(const char *mask);
 uid_t getUid(const char *user);
 gid_t getGid(const char *group);
+int getWorkers(const char *workers);
 
 } /* namespace CmdlineOpts */
 
@@ -30,9 +30,11 @@
 #include <exceptions/InitException.h>
 
 #include <agent/AgentManager.h>
+#include <logic/CheckWorkerPool.h>
 #include <logic/Logic.h>
 #include <plugin/PluginManager.h>
 #include <sockets/SocketManager.h>
+#include <storage/DecisionCache.h>
 #include <storage/InMemoryStorageBackend.h>
 #include <storage/Storage.h>
 #include <storage/StorageBackend.h>
@@ -50,13 +52,14 @@ Cynara::~Cynara() {
     finalize();
 }
 
-void Cynara::init(void) {
+void Cynara::init(unsigned int checkWorkers, bool decisionIndex) {
     m_agentManager = std::make_shared<AgentManager>();
     m_logic = std::make_shared<Logic>();
     m_pluginManager = std::make_shared<PluginManager>(PathConfig::PluginPath::serviceDir);
     m_socketManager = std::make_shared<SocketManager>();
     m_storageBackend = std::make_shared<InMemoryStorageBackend>(PathConfig::StoragePath::dbDir);
-    m_storage = std::make_shared<Storage>(*m_storageBackend);
+    m_storage = std::make_shared<Storage>(*m_storageBackend,
+                                          DecisionCache::CACHE_DEFAULT_CAPACITY, decisionIndex);
 
     m_logic->bindAgentManager(m_agentManager);
     m_logic->bindPluginManager(m_pluginManager);
@@ -65,10 +68,19 @@ void Cynara::init(void) {
 
     m_socketManager->bindLogic(m_logic);
 
+    if (checkWorkers > 0) {
+        m_checkWorkerPool = std::make_shared<CheckWorkerPool>(checkWorkers);
+        m_checkWorkerPool->bindLogic(m_logic);
+        m_socketManager->bindCheckWorkerPool(m_checkWorkerPool);
+    }
+
     m_databaseLock.lock(); // Wait until database lock can be acquired
     m_logic->loadDb();
 
     m_pluginManager->loadPlugins();
+
+    if (m_checkWorkerPool)
+        m_checkWorkerPool->start();
 }
 
 void Cynara::run(void) {
@@ -80,6 +92,11 @@ void Cynara::run(void) {
 }
 
 void Cynara::finalize(void) {
+    if (m_checkWorkerPool) {
+        m_checkWorkerPool->stop();
+        m_checkWorkerPool->unbindAll();
+    }
+
     if (m_logic) {
         m_logic->unbindAll();
     }
@@ -89,6 +106,7 @@ void Cynara::finalize(void) {
     }
 
     m_agentManager.reset();
+    m_checkWorkerPool.reset();
     m_logic.reset();
     m_pluginManager.reset();
     m_socketManager.reset();
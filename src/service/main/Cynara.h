@@ -35,12 +35,13 @@ public:
     Cynara();
     ~Cynara();
 
-    void init(void);
+    void init(unsigned int checkWorkers = 0, bool decisionIndex = false);
     void run(void);
     void finalize(void);
 
 private:
     AgentManagerPtr m_agentManager;
+    CheckWorkerPoolPtr m_checkWorkerPool;
     LogicPtr m_logic;
     PluginManagerPtr m_pluginManager;
     SocketManagerPtr m_socketManager;
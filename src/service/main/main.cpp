@@ -108,7 +108,7 @@ int main(int argc, char **argv) {
 
         Cynara::Cynara cynara;
         LOGI("Cynara service is starting ...");
-        cynara.init();
+        cynara.init(options.m_workers, options.m_decisionIndex);
         LOGI("Cynara service is started");
 
 #ifdef BUILD_WITH_SYSTEMD
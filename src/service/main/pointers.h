@@ -30,6 +30,9 @@ namespace Cynara {
 class AgentManager;
 typedef std::shared_ptr<AgentManager> AgentManagerPtr;
 
+class CheckWorkerPool;
+typedef std::shared_ptr<CheckWorkerPool> CheckWorkerPoolPtr;
+
 class Logic;
 typedef std::shared_ptr<Logic> LogicPtr;
 
@@ -20,16 +20,31 @@
  * @brief       This file implements descriptor class
  */
 
+#include <cstring>
+
+#include <attributes/attributes.h>
+
 #include "Descriptor.h"
 
 namespace Cynara {
 
-Descriptor::Descriptor() : m_listen(false), m_used(false), m_client(false), m_protocol(nullptr) {
+namespace {
+
+void keepArenaData(const void *buffer UNUSED, size_t bufferSize UNUSED, void *userParam UNUSED) {
+}
+
+} // namespace anonymous
+
+Descriptor::Descriptor() : m_listen(false), m_used(false), m_client(false), m_writeArmed(false),
+                           m_invalidationSubscriber(false), m_readArenaUsed(0),
+                           m_protocol(nullptr) {
 }
 
 void Descriptor::checkQueues(void) {
-    if (!m_writeQueue)
+    if (!m_writeQueue) {
         m_writeQueue = std::make_shared<BinaryQueue>();
+        m_writeQueue->setNotEmptyCallback(m_writeNotification);
+    }
     if (!m_readQueue)
         m_readQueue = std::make_shared<BinaryQueue>();
 }
@@ -39,9 +54,15 @@ BinaryQueuePtr Descriptor::writeQueue(void) {
     return m_writeQueue;
 }
 
+void Descriptor::setWriteNotification(const BinaryQueue::NotEmptyCallback &callback) {
+    m_writeNotification = callback;
+    if (m_writeQueue)
+        m_writeQueue->setNotEmptyCallback(m_writeNotification);
+}
+
 bool Descriptor::hasDataToWrite(void) const {
     if (m_writeQueue)
-        return !(m_writeQueue->empty() && m_writeBuffer.empty());
+        return !m_writeQueue->empty();
     return false;
 }
 
@@ -49,9 +70,21 @@ ResponseTakerPtr Descriptor::responseTaker(void) const {
     return std::static_pointer_cast<ResponseTaker>(m_protocol);
 }
 
-void Descriptor::pushReadBuffer(const RawBuffer &readbuffer) {
+unsigned char *Descriptor::readArenaTail(size_t &available) {
+    if (m_readArena.empty())
+        m_readArena.resize(DEFAULT_BUFFER_SIZE);
+    else if (m_readArenaUsed == m_readArena.size())
+        m_readArena.resize(2 * m_readArena.size());
+
+    available = m_readArena.size() - m_readArenaUsed;
+    return m_readArena.data() + m_readArenaUsed;
+}
+
+void Descriptor::commitRead(size_t size) {
     checkQueues();
-    m_readQueue->appendCopy(readbuffer.data(), readbuffer.size());
+    m_readArenaUsed += size;
+    // Arena keeps ownership of data, so queue gets it with no-op deleter
+    m_readQueue->appendUnmanaged(m_readArena.data(), m_readArenaUsed, &keepArenaData);
 }
 
 RequestPtr Descriptor::extractRequest(void) {
@@ -59,24 +92,34 @@ RequestPtr Descriptor::extractRequest(void) {
     return m_protocol->extractRequestFromBuffer(m_readQueue);
 }
 
-RawBuffer &Descriptor::prepareWriteBuffer(void) {
+bool Descriptor::dispatchRequest(RequestTaker &taker, const RequestContext &context) {
     checkQueues();
-    size_t queuedDataSize = m_writeQueue->size();
-    size_t bufferDataSize = m_writeBuffer.size();
+    return m_protocol->dispatchRequestFromBuffer(m_readQueue, taker, context);
+}
 
-    m_writeBuffer.resize(queuedDataSize + bufferDataSize);
-    m_writeQueue->flattenConsume(m_writeBuffer.data() + bufferDataSize, queuedDataSize);
+void Descriptor::releaseParsedRead(void) {
+    checkQueues();
+    size_t unparsed = m_readQueue->size();
+    m_readQueue->clear();
 
-    return m_writeBuffer;
+    if (unparsed > 0 && unparsed < m_readArenaUsed)
+        memmove(m_readArena.data(), m_readArena.data() + m_readArenaUsed - unparsed, unparsed);
+    m_readArenaUsed = unparsed;
 }
 
 void Descriptor::clear(void) {
     m_listen = false;
     m_used = false;
     m_client = false;
+    m_writeArmed = false;
+    m_invalidationSubscriber = false;
+    if (m_writeQueue)
+        m_writeQueue->setNotEmptyCallback(nullptr);
+    m_writeNotification = nullptr;
     m_readQueue.reset();
     m_writeQueue.reset();
-    m_writeBuffer.clear();
+    m_readArena.clear();
+    m_readArenaUsed = 0;
     m_protocol.reset();
 }
 
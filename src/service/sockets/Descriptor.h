@@ -24,6 +24,7 @@
 #define SRC_SERVICE_SOCKETS_DESCRIPTOR_H_
 
 #include <memory>
+#include <stdio.h>
 
 #include <common.h>
 
@@ -33,6 +34,8 @@
 
 namespace Cynara {
 
+const size_t DEFAULT_BUFFER_SIZE = BUFSIZ;
+
 class Descriptor {
 public:
     Descriptor();
@@ -49,6 +52,14 @@ public:
         return m_client;
     }
 
+    bool isWriteArmed(void) const {
+        return m_writeArmed;
+    }
+
+    bool isInvalidationSubscriber(void) const {
+        return m_invalidationSubscriber;
+    }
+
     bool hasDataToWrite(void) const;
 
     const ProtocolPtr protocol(void) const {
@@ -75,10 +86,26 @@ public:
         m_client = client;
     }
 
-    void pushReadBuffer(const RawBuffer &readbuffer);
-    RequestPtr extractRequest(void);
+    void setWriteArmed(bool writeArmed) {
+        m_writeArmed = writeArmed;
+    }
+
+    void setInvalidationSubscriber(bool invalidationSubscriber) {
+        m_invalidationSubscriber = invalidationSubscriber;
+    }
 
-    RawBuffer &prepareWriteBuffer(void);
+    void setWriteNotification(const BinaryQueue::NotEmptyCallback &callback);
+
+    /*
+     * Read arena is a growable buffer reused for all reads from descriptor.
+     * Data received into arena tail are handed to protocol without copying
+     * and bytes left unparsed are moved back to arena beginning.
+     */
+    unsigned char *readArenaTail(size_t &available);
+    void commitRead(size_t size);
+    RequestPtr extractRequest(void);
+    bool dispatchRequest(RequestTaker &taker, const RequestContext &context);
+    void releaseParsedRead(void);
 
     void clear(void);
 
@@ -86,10 +113,14 @@ private:
     bool m_listen;
     bool m_used;
     bool m_client;
+    bool m_writeArmed;
+    bool m_invalidationSubscriber;
 
+    BinaryQueue::NotEmptyCallback m_writeNotification;
     BinaryQueuePtr m_readQueue;
     BinaryQueuePtr m_writeQueue;
-    RawBuffer m_writeBuffer;
+    RawBuffer m_readArena;
+    size_t m_readArenaUsed;
 
     ProtocolPtr m_protocol;
 
@@ -25,7 +25,7 @@
 #include <fcntl.h>
 #include <memory>
 #include <signal.h>
-#include <sys/select.h>
+#include <sys/epoll.h>
 #include <sys/signalfd.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
@@ -45,6 +45,7 @@
 #include <exceptions/InitException.h>
 #include <exceptions/UnexpectedErrorException.h>
 
+#include <logic/CheckWorkerPool.h>
 #include <logic/Logic.h>
 #include <main/Cynara.h>
 #include <protocol/ProtocolAdmin.h>
@@ -53,18 +54,19 @@
 #include <protocol/ProtocolSignal.h>
 #include <request/pointers.h>
 #include <request/RequestContext.h>
+#include <response/InvalidateCacheResponse.h>
 #include <stdexcept>
 
 #include "SocketManager.h"
 
 namespace Cynara {
 
-SocketManager::SocketManager() : m_working(false), m_maxDesc(-1) {
-    FD_ZERO(&m_readSet);
-    FD_ZERO(&m_writeSet);
+SocketManager::SocketManager() : m_working(false), m_epollFd(-1) {
 }
 
 SocketManager::~SocketManager() {
+    if (m_epollFd != -1)
+        close(m_epollFd);
 }
 
 void SocketManager::run(void) {
@@ -78,6 +80,7 @@ void SocketManager::init(void) {
     const mode_t adminSocketUMask(0077);
     const mode_t agentSocketUMask(0);
 
+    createEpoll();
     createDomainSocket(std::make_shared<ProtocolClient>(), PathConfig::SocketPath::client,
                        clientSocketUMask, true);
     createDomainSocket(std::make_shared<ProtocolAdmin>(), PathConfig::SocketPath::admin,
@@ -85,17 +88,33 @@ void SocketManager::init(void) {
     createDomainSocket(std::make_shared<ProtocolAgent>(), PathConfig::SocketPath::agent,
                        agentSocketUMask, false);
     createSignalSocket(std::make_shared<ProtocolSignal>());
+    if (m_checkWorkerPool)
+        addReadSocket(m_checkWorkerPool->notificationFd());
     LOGI("SocketManger init done");
 }
 
+void SocketManager::createEpoll(void) {
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd == -1) {
+        UNUSED int err = errno;
+        LOGE("Error during epoll instance creation: <%s>", strerror(err));
+        throw InitException();
+    }
+}
+
 void SocketManager::mainLoop(void) {
     LOGI("SocketManger mainLoop start");
+    struct epoll_event events[MAX_EPOLL_EVENTS];
     m_working  = true;
     while (m_working) {
-        fd_set readSet = m_readSet;
-        fd_set writeSet = m_writeSet;
+        int timeout = m_logic->compactionPending() ? COMPACTION_DELAY : -1;
+        int ret = epoll_wait(m_epollFd, events, MAX_EPOLL_EVENTS, timeout);
 
-        int ret = select(m_maxDesc + 1, &readSet, &writeSet, nullptr, nullptr);
+        if (ret == 0) {
+            // Nothing happened for a while, good time to fold journal into database
+            m_logic->compactPolicies();
+            continue;
+        }
 
         if (ret < 0) {
             switch (errno) {
@@ -105,27 +124,41 @@ void SocketManager::mainLoop(void) {
                 int err = errno;
                 throw UnexpectedErrorException(err, strerror(err));
             }
-        } else if (ret > 0) {
-            for (int i = 0; i < m_maxDesc + 1 && ret; ++i) {
-                if (FD_ISSET(i, &readSet)) {
-                    readyForRead(i);
-                    --ret;
-                }
-                if (FD_ISSET(i, &writeSet)) {
-                    readyForWrite(i);
-                    --ret;
-                }
-            }
+        }
 
-            for (int i = 0; i < m_maxDesc + 1; ++i) {
-                if (m_fds[i].isUsed() && m_fds[i].hasDataToWrite())
-                    addWriteSocket(i);
+        for (int i = 0; i < ret; ++i) {
+            int fd = events[i].data.fd;
+            if (m_checkWorkerPool && fd == m_checkWorkerPool->notificationFd()) {
+                m_checkWorkerPool->processResults();
+                continue;
             }
+            // descriptor might have been closed while handling previous events
+            if (!m_fds[fd].isUsed())
+                continue;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                readyForRead(fd);
+            if (m_fds[fd].isUsed() && (events[i].events & EPOLLOUT))
+                readyForWrite(fd);
         }
+
+        m_logic->commitPolicyChanges();
+        flushPendingWrites();
     }
     LOGI("SocketManger mainLoop done");
 }
 
+void SocketManager::flushPendingWrites(void) {
+    // Responses queued during whole loop pass are sent with one syscall per descriptor.
+    // Writing may close descriptors and queue more writes, so do not iterate with iterators.
+    for (size_t i = 0; i < m_pendingWrites.size(); ++i) {
+        int fd = m_pendingWrites[i];
+        auto &desc = m_fds[fd];
+        if (desc.isUsed() && desc.hasDataToWrite())
+            readyForWrite(fd);
+    }
+    m_pendingWrites.clear();
+}
+
 void SocketManager::mainLoopStop(void) {
     m_working = false;
 }
@@ -138,32 +171,42 @@ void SocketManager::readyForRead(int fd) {
         return;
     }
 
-    RawBuffer readBuffer(DEFAULT_BUFFER_SIZE);
-    ssize_t size = read(fd, readBuffer.data(), DEFAULT_BUFFER_SIZE);
+    // Drain socket, so pipelined requests are handled in as few syscalls as possible
+    while (true) {
+        size_t available;
+        unsigned char *buffer = desc.readArenaTail(available);
+        ssize_t size = read(fd, buffer, available);
 
-    if (size > 0) {
-        LOGD("read [%zd] bytes", size);
-        readBuffer.resize(size);
-        if (handleRead(fd, readBuffer)) {
-            LOGD("SocketManger readyForRead on fd [%d] successfully done", fd);
-            return;
-        }
-        LOGI("interpreting buffer read from [%d] failed", fd);
-    } else if (size < 0) {
-        int err = errno;
-        switch (err) {
-            case EAGAIN:
+        if (size > 0) {
+            LOGD("read [%zd] bytes", size);
+            if (!handleRead(fd, size)) {
+                LOGI("interpreting buffer read from [%d] failed", fd);
+                break;
+            }
+            // short read means there is nothing more waiting in socket
+            if (static_cast<size_t>(size) < available) {
+                LOGD("SocketManger readyForRead on fd [%d] successfully done", fd);
+                return;
+            }
+        } else if (size < 0) {
+            int err = errno;
+            switch (err) {
+                case EINTR:
+                    continue;
+                case EAGAIN:
 #if EWOULDBLOCK != EAGAIN
-            case EWOULDBLOCK:
+                case EWOULDBLOCK:
 #endif
-            case EINTR:
-                return;
-            default:
-                LOGW("While reading from [%d] socket, error [%d]:<%s>",
-                     fd, err, strerror(err));
+                    return;
+                default:
+                    LOGW("While reading from [%d] socket, error [%d]:<%s>",
+                         fd, err, strerror(err));
+            }
+            break;
+        } else {
+            LOGN("Socket [%d] closed on other end", fd);
+            break;
         }
-    } else {
-        LOGN("Socket [%d] closed on other end", fd);
     }
     closeSocket(fd);
     LOGD("SocketManger readyForRead on fd [%d] done", fd);
@@ -172,15 +215,22 @@ void SocketManager::readyForRead(int fd) {
 void SocketManager::readyForWrite(int fd) {
     LOGD("SocketManger readyForWrite on fd [%d] start", fd);
     auto &desc = m_fds[fd];
-    auto &buffer = desc.prepareWriteBuffer();
-    size_t size = buffer.size();
-    ssize_t result = write(fd, buffer.data(), size);
+    auto queue = desc.writeQueue();
+
+    struct iovec vector[MAX_WRITE_VECTOR_SIZE];
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = vector;
+    message.msg_iovlen = queue->exportIovec(vector, MAX_WRITE_VECTOR_SIZE);
+
+    ssize_t result = sendmsg(fd, &message, MSG_NOSIGNAL);
     if (result == -1) {
         int err = errno;
         switch (err) {
         case EAGAIN:
         case EINTR:
-            // select will trigger write once again, nothing to do
+            // wait until epoll triggers write once again
+            addWriteSocket(fd);
             break;
         case EPIPE:
         default:
@@ -192,10 +242,12 @@ void SocketManager::readyForWrite(int fd) {
     }
 
     LOGD("written [%zd] bytes", result);
-    buffer.erase(buffer.begin(), buffer.begin() + result);
+    queue->consume(result);
 
-    if (buffer.empty())
+    if (queue->empty())
         removeWriteSocket(fd);
+    else
+        addWriteSocket(fd);
     LOGD("SocketManger readyForWrite on fd [%d] done", fd);
 }
 
@@ -211,46 +263,59 @@ void SocketManager::readyForAccept(int fd) {
     }
     LOGD("Accept on sock [%d]. New client socket opened [%d]", fd, clientFd);
 
-    auto &desc = createDescriptor(clientFd, m_fds[fd].isClient());
-    desc.setListen(false);
-    desc.setProtocol(m_fds[fd].protocol()->clone());
-    addReadSocket(clientFd);
+    addConnection(clientFd, m_fds[fd].isClient(), m_fds[fd].protocol()->clone());
     LOGD("SocketManger readyForAccept on fd [%d] done", fd);
 }
 
+void SocketManager::addConnection(int fd, bool client, ProtocolPtr protocol) {
+    auto &desc = createDescriptor(fd, client);
+    desc.setListen(false);
+    desc.setProtocol(protocol);
+    addReadSocket(fd);
+}
+
 void SocketManager::closeSocket(int fd) {
     LOGD("SocketManger closeSocket fd [%d] start", fd);
     Descriptor &desc = m_fds[fd];
     requestTaker()->contextClosed(RequestContext(nullptr, desc.writeQueue()));
+    m_linkFds.erase(desc.writeQueue().get());
     removeReadSocket(fd);
-    removeWriteSocket(fd);
     desc.clear();
     close(fd);
     LOGD("SocketManger closeSocket fd [%d] done", fd);
 }
 
-bool SocketManager::handleRead(int fd, const RawBuffer &readbuffer) {
+bool SocketManager::handleRead(int fd, size_t size) {
     LOGD("SocketManger handleRead on fd [%d] start", fd);
     auto &desc = m_fds[fd];
-    desc.pushReadBuffer(readbuffer);
+    desc.commitRead(size);
 
-    try {
-        while(true) {
-            //try extract request from binary data received on socket
-            auto req = desc.extractRequest();
-            if (!req)   // not enough data to build request yet
-                break;
-            LOGD("request extracted");
+    //build context
+    RequestContext context(desc.responseTaker(), desc.writeQueue());
 
-            //build context
-            RequestContext context(desc.responseTaker(), desc.writeQueue());
-            //pass request to request taker
-            req->execute(*requestTaker(), context);
+    try {
+        if (m_checkWorkerPool) {
+            // Requests wait for workers, so they have to be kept on heap
+            while (true) {
+                //try extract request from binary data received on socket
+                auto req = desc.extractRequest();
+                if (!req)   // not enough data to build request yet
+                    break;
+                LOGD("request extracted");
+
+                m_checkWorkerPool->dispatch(req, context);
+            }
+        } else {
+            //pass requests built on stack directly to request taker
+            while (desc.dispatchRequest(*requestTaker(), context)) {
+                LOGD("request dispatched");
+            }
         }
     } catch (const Exception &ex) {
         LOGE("Error handling request <%s>. Closing socket", ex.what());
         return false;
     }
+    desc.releaseParsedRead();
     LOGD("SocketManger handleRead on fd [%d] done", fd);
     return true;
 }
@@ -376,42 +441,85 @@ void SocketManager::createSignalSocket(ProtocolPtr protocol) {
 }
 
 Descriptor &SocketManager::createDescriptor(int fd, bool client) {
-    if (fd > m_maxDesc) {
-        m_maxDesc = fd;
-        if (fd >= static_cast<int>(m_fds.size()))
-            m_fds.resize(fd + 20);
-    }
+    if (fd >= static_cast<int>(m_fds.size()))
+        m_fds.resize(fd + 20);
     auto &desc = m_fds[fd];
     desc.setUsed(true);
     desc.setClient(client);
+    desc.setWriteNotification([this, fd](void) { m_pendingWrites.push_back(fd); });
+    m_linkFds[desc.writeQueue().get()] = fd;
     return desc;
 }
 
 void SocketManager::addReadSocket(int fd) {
-    FD_SET(fd, &m_readSet);
+    modifyEpoll(EPOLL_CTL_ADD, fd, EPOLLIN);
 }
 
 void SocketManager::removeReadSocket(int fd) {
-    FD_CLR(fd, &m_readSet);
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr) == -1) {
+        UNUSED int err = errno;
+        LOGW("Error removing descriptor [%d] from epoll: <%s>", fd, strerror(err));
+    }
 }
 
 void SocketManager::addWriteSocket(int fd) {
-    FD_SET(fd, &m_writeSet);
+    auto &desc = m_fds[fd];
+    if (desc.isWriteArmed())
+        return;
+    modifyEpoll(EPOLL_CTL_MOD, fd, EPOLLIN | EPOLLOUT);
+    desc.setWriteArmed(true);
 }
 
 void SocketManager::removeWriteSocket(int fd) {
-    FD_CLR(fd, &m_writeSet);
+    auto &desc = m_fds[fd];
+    if (!desc.isWriteArmed())
+        return;
+    modifyEpoll(EPOLL_CTL_MOD, fd, EPOLLIN);
+    desc.setWriteArmed(false);
+}
+
+void SocketManager::modifyEpoll(int operation, int fd, uint32_t events) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.fd = fd;
+
+    if (epoll_ctl(m_epollFd, operation, fd, &event) == -1) {
+        int err = errno;
+        LOGE("Error in epoll_ctl [%d] on descriptor [%d]: <%s>", operation, fd, strerror(err));
+        throw UnexpectedErrorException(err, strerror(err));
+    }
 }
 
 RequestTakerPtr SocketManager::requestTaker(void) {
+    if (m_checkWorkerPool)
+        return std::static_pointer_cast<RequestTaker>(m_checkWorkerPool);
     return std::static_pointer_cast<RequestTaker>(m_logic);
 }
 
-void SocketManager::disconnectAllClients(void) {
-    for(int i = 0; i <= m_maxDesc; ++i) {
+void SocketManager::subscribeInvalidation(const LinkId &linkId) {
+    auto it = m_linkFds.find(linkId.get());
+    if (it == m_linkFds.end())
+        return;
+
+    auto &desc = m_fds[it->second];
+    if (desc.isClient() && !desc.isListen())
+        desc.setInvalidationSubscriber(true);
+}
+
+void SocketManager::invalidateClientCaches(void) {
+    // Clients, which did not subscribe for invalidation, learn about change by disconnection
+    for(int i = 0; i < static_cast<int>(m_fds.size()); ++i) {
         auto &desc = m_fds[i];
-        if(desc.isUsed() && desc.isClient() && !desc.isListen())
+        if(!desc.isUsed() || !desc.isClient() || desc.isListen())
+            continue;
+
+        if (desc.isInvalidationSubscriber()) {
+            RequestContext context(desc.responseTaker(), desc.writeQueue());
+            context.returnResponse(InvalidateCacheResponse(0));
+        } else {
             closeSocket(i);
+        }
     }
 }
 
@@ -23,20 +23,23 @@
 #ifndef SRC_SERVICE_SOCKETS_SOCKETMANAGER_H_
 #define SRC_SERVICE_SOCKETS_SOCKETMANAGER_H_
 
+#include <unordered_map>
 #include <vector>
 #include <memory>
-#include <stdio.h>
 
 #include <common.h>
 
 #include <main/pointers.h>
 #include <protocol/Protocol.h>
 #include <request/RequestTaker.h>
+#include <types/Link.h>
 #include "Descriptor.h"
 
 namespace Cynara {
 
-const size_t DEFAULT_BUFFER_SIZE = BUFSIZ;
+const int MAX_EPOLL_EVENTS = 64;
+const int COMPACTION_DELAY = 1000; // ms
+const size_t MAX_WRITE_VECTOR_SIZE = 64;
 
 class SocketManager {
 public:
@@ -50,32 +53,38 @@ public:
         m_logic = logic;
     }
 
+    void bindCheckWorkerPool(CheckWorkerPoolPtr checkWorkerPool) {
+        m_checkWorkerPool = checkWorkerPool;
+    }
+
     void unbindAll(void) {
         m_logic.reset();
+        m_checkWorkerPool.reset();
     }
 
-    void disconnectAllClients(void);
+    void subscribeInvalidation(const LinkId &linkId);
+    void invalidateClientCaches(void);
 
 private:
     LogicPtr m_logic;
+    CheckWorkerPoolPtr m_checkWorkerPool;
 
     typedef std::vector<Descriptor> FDVector;
     FDVector m_fds;
+    // Descriptors of links, so link of a request is resolved without scanning all descriptors
+    std::unordered_map<const BinaryQueue *, int> m_linkFds;
 
     bool m_working;
 
-    fd_set m_readSet;
-    fd_set m_writeSet;
-    int m_maxDesc;
+    int m_epollFd;
+    std::vector<int> m_pendingWrites;
 
     void init(void);
     void mainLoop(void);
 
-    void readyForRead(int fd);
-    void readyForWrite(int fd);
     void readyForAccept(int fd);
     void closeSocket(int fd);
-    bool handleRead(int fd, const RawBuffer &readbuffer);
+    bool handleRead(int fd, size_t size);
 
     void createDomainSocket(ProtocolPtr protocol, const std::string &path, mode_t mask,
                             bool client);
@@ -91,8 +100,25 @@ private:
     void removeReadSocket(int fd);
     void addWriteSocket(int fd);
     void removeWriteSocket(int fd);
+    void modifyEpoll(int operation, int fd, uint32_t events);
 
     RequestTakerPtr requestTaker(void);
+
+protected:
+    // Steps of main loop, so they can be driven over connections not accepted on cynara sockets
+    void createEpoll(void);
+    void addConnection(int fd, bool client, ProtocolPtr protocol);
+    void flushPendingWrites(void);
+    void readyForRead(int fd);
+    void readyForWrite(int fd);
+
+    const Descriptor &descriptor(int fd) const {
+        return m_fds[fd];
+    }
+
+    int epollFd(void) const {
+        return m_epollFd;
+    }
 };
 
 } // namespace Cynara
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/BinaryDeserializer.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file implements deserializer of memory-mapped binary database files
+ */
+
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <exceptions/BinaryFileCorruptedException.h>
+#include <exceptions/FileNotFoundException.h>
+#include <types/Policy.h>
+#include <types/PolicyArena.h>
+#include <types/PolicyCollection.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+
+#include <storage/Checksum.h>
+
+#include "BinaryDeserializer.h"
+
+namespace Cynara {
+
+BinaryDeserializer::BinaryDeserializer(const std::string &filename) : m_filename(filename),
+    m_data(nullptr), m_size(0), m_strings(nullptr) {
+    int fd = TEMP_FAILURE_RETRY(open(filename.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd < 0)
+        throw FileNotFoundException(filename);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw FileNotFoundException(filename);
+    }
+
+    if (static_cast<std::size_t>(st.st_size) < sizeof(BinaryFormat::FileHeader)) {
+        close(fd);
+        throw BinaryFileCorruptedException(filename, "truncated header");
+    }
+
+    m_size = static_cast<std::size_t>(st.st_size);
+    void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        throw FileNotFoundException(filename);
+    m_data = static_cast<const char *>(data);
+
+    try {
+        validate();
+    } catch (...) {
+        munmap(const_cast<char *>(m_data), m_size);
+        throw;
+    }
+}
+
+BinaryDeserializer::~BinaryDeserializer() {
+    munmap(const_cast<char *>(m_data), m_size);
+}
+
+bool BinaryDeserializer::isBinaryFile(const std::string &filename) {
+    int fd = TEMP_FAILURE_RETRY(open(filename.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd < 0)
+        return false;
+
+    char buffer[BinaryFormat::MAGIC_SIZE];
+    ssize_t ret = TEMP_FAILURE_RETRY(read(fd, buffer, sizeof(buffer)));
+    close(fd);
+
+    return ret > 0 && BinaryFormat::hasMagic(buffer, static_cast<std::size_t>(ret));
+}
+
+void BinaryDeserializer::validate(void) {
+    const auto &head = header();
+    if (!BinaryFormat::hasMagic(head.magic, BinaryFormat::MAGIC_SIZE))
+        throw BinaryFileCorruptedException(m_filename, "bad magic");
+    if (head.byteOrder != BinaryFormat::BYTE_ORDER_MARK)
+        throw BinaryFileCorruptedException(m_filename, "foreign byte order");
+    if (head.version != BinaryFormat::VERSION)
+        throw BinaryFileCorruptedException(m_filename, "unsupported version");
+
+    std::size_t recordSize;
+    switch (head.kind) {
+        case BinaryFormat::INDEX_FILE:
+            recordSize = sizeof(BinaryFormat::BucketRecord);
+            break;
+        case BinaryFormat::BUCKET_FILE:
+            recordSize = sizeof(BinaryFormat::PolicyRecord);
+            break;
+        default:
+            throw BinaryFileCorruptedException(m_filename, "unknown file kind");
+    }
+
+    // Sizes are checked against remaining space before adding, so they cannot overflow
+    std::size_t contentSize = m_size - sizeof(BinaryFormat::FileHeader);
+    if (head.recordCount > contentSize / recordSize)
+        throw BinaryFileCorruptedException(m_filename, "size mismatch");
+    std::size_t recordsSize = static_cast<std::size_t>(head.recordCount) * recordSize;
+    if (head.stringTableSize != contentSize - recordsSize)
+        throw BinaryFileCorruptedException(m_filename, "size mismatch");
+
+    const char *content = m_data + sizeof(BinaryFormat::FileHeader);
+    Checksum::Hasher hasher;
+    hasher.update(content, contentSize);
+    if (hasher.digest() != head.checksum)
+        throw BinaryFileCorruptedException(m_filename, "checksum mismatch");
+
+    m_strings = content + recordsSize;
+}
+
+void BinaryDeserializer::expectKind(BinaryFormat::FileKind kind) const {
+    if (header().kind != kind)
+        throw BinaryFileCorruptedException(m_filename, "unexpected file kind");
+}
+
+PolicyType BinaryDeserializer::policyType(uint32_t type) const {
+    if (type > std::numeric_limits<PolicyType>::max())
+        throw BinaryFileCorruptedException(m_filename, "invalid policy type");
+    return static_cast<PolicyType>(type);
+}
+
+std::string BinaryDeserializer::string(const BinaryFormat::StringRef &ref) const {
+    uint64_t end = static_cast<uint64_t>(ref.offset) + ref.length;
+    if (end > header().stringTableSize)
+        throw BinaryFileCorruptedException(m_filename, "string reference out of bounds");
+    return std::string(m_strings + ref.offset, ref.length);
+}
+
+void BinaryDeserializer::initBuckets(Buckets &buckets) const {
+    expectKind(BinaryFormat::INDEX_FILE);
+    buckets.clear();
+
+    const auto *record = records<BinaryFormat::BucketRecord>();
+    for (uint32_t i = 0; i < header().recordCount; ++i, ++record) {
+        auto bucketId = string(record->id);
+        PolicyResult defaultPolicy(policyType(record->type),
+                                   string(record->metadata));
+        if (!buckets.insert({ bucketId, PolicyBucket(bucketId, defaultPolicy) }).second)
+            throw BinaryFileCorruptedException(m_filename, "duplicated bucket " + bucketId);
+    }
+}
+
+void BinaryDeserializer::loadPolicies(PolicyBucket &bucket) const {
+    expectKind(BinaryFormat::BUCKET_FILE);
+
+    // Number of policies is known, so all of them are created in a single block
+    PolicyArena arena(header().recordCount);
+    PolicyCollection policies;
+    policies.reserve(header().recordCount);
+
+    const auto *record = records<BinaryFormat::PolicyRecord>();
+    for (uint32_t i = 0; i < header().recordCount; ++i, ++record) {
+        PolicyKey key(string(record->client), string(record->user), string(record->privilege));
+        PolicyResult result(policyType(record->type), string(record->metadata));
+        policies.push_back(arena.create(key, result));
+    }
+    bucket.insertPolicies(policies);
+}
+
+} /* namespace Cynara */
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/BinaryDeserializer.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines deserializer of memory-mapped binary database files
+ */
+
+#ifndef SRC_STORAGE_BINARYDESERIALIZER_H_
+#define SRC_STORAGE_BINARYDESERIALIZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <types/PolicyBucket.h>
+#include <types/PolicyType.h>
+
+#include <storage/BinaryFormat.h>
+#include <storage/Buckets.h>
+
+namespace Cynara {
+
+class BinaryDeserializer {
+public:
+    BinaryDeserializer(const std::string &filename);
+    ~BinaryDeserializer();
+
+    BinaryDeserializer(const BinaryDeserializer &) = delete;
+    BinaryDeserializer &operator=(const BinaryDeserializer &) = delete;
+
+    void initBuckets(Buckets &buckets) const;
+    void loadPolicies(PolicyBucket &bucket) const;
+
+    static bool isBinaryFile(const std::string &filename);
+
+private:
+    void validate(void);
+    void expectKind(BinaryFormat::FileKind kind) const;
+    PolicyType policyType(uint32_t type) const;
+    std::string string(const BinaryFormat::StringRef &ref) const;
+
+    const BinaryFormat::FileHeader &header(void) const {
+        return *reinterpret_cast<const BinaryFormat::FileHeader *>(m_data);
+    }
+
+    template<typename Record>
+    const Record *records(void) const {
+        return reinterpret_cast<const Record *>(m_data + sizeof(BinaryFormat::FileHeader));
+    }
+
+    std::string m_filename;
+    const char *m_data;
+    std::size_t m_size;
+    const char *m_strings;
+};
+
+} /* namespace Cynara */
+
+#endif /* SRC_STORAGE_BINARYDESERIALIZER_H_ */
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/BinaryFormat.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file implements helpers of binary database format
+ */
+
+#include <cstring>
+
+#include "BinaryFormat.h"
+
+namespace Cynara {
+
+namespace BinaryFormat {
+
+const char magic[MAGIC_SIZE] = { '\x7f', 'C', 'Y', 'N', 'A', 'R', 'A', '\0' };
+
+bool hasMagic(const char *data, std::size_t size) {
+    return size >= MAGIC_SIZE && memcmp(data, magic, MAGIC_SIZE) == 0;
+}
+
+} /* namespace BinaryFormat */
+
+} /* namespace Cynara */
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/BinaryFormat.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines layout of binary database files
+ */
+
+#ifndef SRC_STORAGE_BINARYFORMAT_H_
+#define SRC_STORAGE_BINARYFORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Cynara {
+
+/*
+ * Every binary database file (index or bucket) consists of:
+ *   - FileHeader,
+ *   - recordCount fixed-width records (BucketRecord in index, PolicyRecord in bucket files),
+ *   - string table referenced by records with StringRef (offset relative to table start).
+ * Checksum in header is XXH64 (Checksum::Hasher) of everything following the header.
+ * Integers are stored in host byte order; byteOrder field allows detecting foreign files.
+ */
+namespace BinaryFormat {
+
+const std::size_t MAGIC_SIZE = 8;
+extern const char magic[MAGIC_SIZE];
+const uint32_t VERSION = 2;
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+enum FileKind : uint32_t {
+    INDEX_FILE = 1,
+    BUCKET_FILE = 2,
+};
+
+struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct FileHeader {
+    char magic[MAGIC_SIZE];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t kind;
+    uint32_t recordCount;
+    uint32_t stringTableSize;
+    uint32_t reserved;
+    uint64_t checksum;
+};
+
+struct BucketRecord {
+    StringRef id;
+    uint32_t type;
+    StringRef metadata;
+};
+
+struct PolicyRecord {
+    StringRef client;
+    StringRef user;
+    StringRef privilege;
+    uint32_t type;
+    StringRef metadata;
+};
+
+static_assert(sizeof(FileHeader) == 40, "Binary database header layout changed");
+static_assert(sizeof(BucketRecord) == 20, "Binary database bucket record layout changed");
+static_assert(sizeof(PolicyRecord) == 36, "Binary database policy record layout changed");
+
+bool hasMagic(const char *data, std::size_t size);
+
+} /* namespace BinaryFormat */
+
+} /* namespace Cynara */
+
+#endif /* SRC_STORAGE_BINARYFORMAT_H_ */
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/BinarySerializer.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file implements serializer of binary database files
+ */
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <exceptions/CannotCreateFileException.h>
+#include <types/Policy.h>
+
+#include <storage/Checksum.h>
+
+#include "BinarySerializer.h"
+
+namespace Cynara {
+
+BinarySerializer::BinarySerializer(const std::string &filename, BinaryFormat::FileKind kind)
+    : m_filename(filename), m_kind(kind), m_recordCount(0) {
+}
+
+void BinarySerializer::dumpIndex(const std::string &filename, const Buckets &buckets) {
+    BinarySerializer serializer(filename, BinaryFormat::INDEX_FILE);
+    for (const auto &bucketIter : buckets) {
+        const auto &bucket = bucketIter.second;
+        BinaryFormat::BucketRecord record;
+        record.id = serializer.addString(bucket.id());
+        record.type = bucket.defaultPolicy().policyType();
+        record.metadata = serializer.addString(bucket.defaultPolicy().metadata());
+        serializer.addRecord(record);
+    }
+    serializer.save();
+}
+
+void BinarySerializer::dumpBucket(const std::string &filename, const PolicyBucket &bucket) {
+    BinarySerializer serializer(filename, BinaryFormat::BUCKET_FILE);
+    for (auto it = std::begin(bucket); it != std::end(bucket); ++it) {
+        const auto &policy = *it;
+        BinaryFormat::PolicyRecord record;
+        record.client = serializer.addString(policy->key().client().toString());
+        record.user = serializer.addString(policy->key().user().toString());
+        record.privilege = serializer.addString(policy->key().privilege().toString());
+        record.type = policy->result().policyType();
+        record.metadata = serializer.addString(policy->result().metadata());
+        serializer.addRecord(record);
+    }
+    serializer.save();
+}
+
+BinaryFormat::StringRef BinarySerializer::addString(const std::string &value) {
+    auto it = m_stringRefs.find(value);
+    if (it != m_stringRefs.end())
+        return it->second;
+
+    if (m_strings.size() + value.size() > std::numeric_limits<uint32_t>::max())
+        throw CannotCreateFileException(m_filename);
+
+    BinaryFormat::StringRef ref;
+    ref.offset = static_cast<uint32_t>(m_strings.size());
+    ref.length = static_cast<uint32_t>(value.size());
+    m_strings.append(value);
+    m_stringRefs.insert({ value, ref });
+    return ref;
+}
+
+template<typename Record>
+void BinarySerializer::addRecord(const Record &record) {
+    auto offset = m_records.size();
+    m_records.resize(offset + sizeof(Record));
+    memcpy(m_records.data() + offset, &record, sizeof(Record));
+    ++m_recordCount;
+}
+
+void BinarySerializer::save(void) const {
+    BinaryFormat::FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BinaryFormat::magic, BinaryFormat::MAGIC_SIZE);
+    header.version = BinaryFormat::VERSION;
+    header.byteOrder = BinaryFormat::BYTE_ORDER_MARK;
+    header.kind = m_kind;
+    header.recordCount = m_recordCount;
+    header.stringTableSize = static_cast<uint32_t>(m_strings.size());
+    Checksum::Hasher hasher;
+    hasher.update(m_records.data(), m_records.size());
+    hasher.update(m_strings.data(), m_strings.size());
+    header.checksum = hasher.digest();
+
+    std::ofstream stream(m_filename, std::ofstream::out | std::ofstream::trunc
+                                   | std::ofstream::binary);
+    if (!stream.is_open())
+        throw CannotCreateFileException(m_filename);
+
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    stream.write(m_records.data(), m_records.size());
+    stream.write(m_strings.data(), m_strings.size());
+    stream.flush();
+
+    if (!stream.good())
+        throw CannotCreateFileException(m_filename);
+}
+
+} /* namespace Cynara */
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/BinarySerializer.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines serializer of binary database files
+ */
+
+#ifndef SRC_STORAGE_BINARYSERIALIZER_H_
+#define SRC_STORAGE_BINARYSERIALIZER_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <types/PolicyBucket.h>
+
+#include <storage/BinaryFormat.h>
+#include <storage/Buckets.h>
+
+namespace Cynara {
+
+class BinarySerializer {
+public:
+    static void dumpIndex(const std::string &filename, const Buckets &buckets);
+    static void dumpBucket(const std::string &filename, const PolicyBucket &bucket);
+
+private:
+    BinarySerializer(const std::string &filename, BinaryFormat::FileKind kind);
+
+    BinaryFormat::StringRef addString(const std::string &value);
+    template<typename Record>
+    void addRecord(const Record &record);
+    void save(void) const;
+
+    std::string m_filename;
+    BinaryFormat::FileKind m_kind;
+    uint32_t m_recordCount;
+    std::vector<char> m_records;
+    std::string m_strings;
+    std::unordered_map<std::string, BinaryFormat::StringRef> m_stringRefs;
+};
+
+} /* namespace Cynara */
+
+#endif /* SRC_STORAGE_BINARYSERIALIZER_H_ */
@@ -27,6 +27,7 @@
 
 #include <config/PathConfig.h>
 #include <exceptions/BucketRecordCorruptedException.h>
+#include <types/PolicyArena.h>
 #include <types/PolicyCollection.h>
 #include <types/PolicyResult.h>
 #include <types/PolicyType.h>
@@ -39,6 +40,7 @@ namespace Cynara {
 
 PolicyCollection BucketDeserializer::loadPolicies(void) {
     PolicyCollection policies;
+    PolicyArena arena;
 
     // TODO: Get someone smart to do error checking on stream
     std::string line;
@@ -53,13 +55,16 @@ PolicyCollection BucketDeserializer::loadPolicies(void) {
             auto policyType = StorageDeserializer::parsePolicyType(line, beginToken);
             auto metadata = StorageDeserializer::parseMetadata(line, beginToken);
             PolicyResult policyResult(policyType, metadata);
-            policies.push_back(std::make_shared<Policy>(policyKey, policyResult));
+            policies.push_back(arena.create(policyKey, policyResult));
         } catch (const BucketRecordCorruptedException &ex) {
             throw ex.withLineNumber(lineNum);
         }
         ++lineNum;
     }
 
+    if (m_verifier)
+        m_verifier();
+
     return policies;
 }
 
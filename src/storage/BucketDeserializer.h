@@ -23,6 +23,7 @@
 #define SRC_STORAGE_BUCKETDESERIALIZER_H_
 
 #include <fstream>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -34,7 +35,12 @@ namespace Cynara {
 class BucketDeserializer {
 
 public:
-    BucketDeserializer(std::shared_ptr<std::istream> inStream) : m_inStream(inStream) {
+    // Verifier is called after whole bucket is parsed, to check stream contents
+    typedef std::function<void(void)> StreamVerifier;
+
+    BucketDeserializer(std::shared_ptr<std::istream> inStream,
+                       StreamVerifier verifier = nullptr)
+        : m_inStream(inStream), m_verifier(verifier) {
     }
 
     PolicyCollection loadPolicies(void);
@@ -42,6 +48,7 @@ public:
 
 private:
     std::shared_ptr<std::istream> m_inStream;
+    StreamVerifier m_verifier;
 };
 
 } /* namespace Cynara */
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/Checksum.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file implements checksum algorithms of database files
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "Checksum.h"
+
+namespace Cynara {
+
+namespace Checksum {
+
+namespace {
+
+const std::string md5CryptPrefix("$1$");
+const std::string xxh64Prefix("$xxh64$");
+
+const uint64_t PRIME1 = 11400714785074694791ULL;
+const uint64_t PRIME2 = 14029467366897019727ULL;
+const uint64_t PRIME3 = 1609587929392839161ULL;
+const uint64_t PRIME4 = 9650029242287828579ULL;
+const uint64_t PRIME5 = 2870177450012600261ULL;
+
+inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Reads are little endian regardless of host, so checksums do not depend on architecture
+inline uint64_t read64(const char *data) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i)
+        value = (value << 8) | static_cast<unsigned char>(data[i]);
+    return value;
+}
+
+inline uint64_t read32(const char *data) {
+    uint64_t value = 0;
+    for (int i = 3; i >= 0; --i)
+        value = (value << 8) | static_cast<unsigned char>(data[i]);
+    return value;
+}
+
+inline uint64_t hashRound(uint64_t accumulator, uint64_t input) {
+    accumulator += input * PRIME2;
+    return rotateLeft(accumulator, 31) * PRIME1;
+}
+
+inline uint64_t mergeRound(uint64_t accumulator, uint64_t value) {
+    accumulator ^= hashRound(0, value);
+    return accumulator * PRIME1 + PRIME4;
+}
+
+} // namespace
+
+Hasher::Hasher(uint64_t seed) : m_seed(seed), m_totalSize(0), m_stripeSize(0) {
+    m_accumulators[0] = seed + PRIME1 + PRIME2;
+    m_accumulators[1] = seed + PRIME2;
+    m_accumulators[2] = seed;
+    m_accumulators[3] = seed - PRIME1;
+}
+
+void Hasher::update(const char *data, std::size_t size) {
+    m_totalSize += size;
+
+    if (m_stripeSize > 0) {
+        std::size_t count = std::min(size, STRIPE_SIZE - m_stripeSize);
+        memcpy(m_stripe + m_stripeSize, data, count);
+        m_stripeSize += count;
+        data += count;
+        size -= count;
+        if (m_stripeSize < STRIPE_SIZE)
+            return;
+        consumeStripe(m_stripe);
+        m_stripeSize = 0;
+    }
+
+    for (; size >= STRIPE_SIZE; data += STRIPE_SIZE, size -= STRIPE_SIZE)
+        consumeStripe(data);
+
+    memcpy(m_stripe, data, size);
+    m_stripeSize = size;
+}
+
+void Hasher::consumeStripe(const char *stripe) {
+    for (int i = 0; i < 4; ++i)
+        m_accumulators[i] = hashRound(m_accumulators[i], read64(stripe + 8 * i));
+}
+
+uint64_t Hasher::digest(void) const {
+    uint64_t hash;
+    if (m_totalSize >= STRIPE_SIZE) {
+        hash = rotateLeft(m_accumulators[0], 1) + rotateLeft(m_accumulators[1], 7) +
+               rotateLeft(m_accumulators[2], 12) + rotateLeft(m_accumulators[3], 18);
+        for (int i = 0; i < 4; ++i)
+            hash = mergeRound(hash, m_accumulators[i]);
+    } else {
+        hash = m_seed + PRIME5;
+    }
+    hash += m_totalSize;
+
+    const char *data = m_stripe;
+    std::size_t size = m_stripeSize;
+    for (; size >= 8; data += 8, size -= 8)
+        hash = rotateLeft(hash ^ hashRound(0, read64(data)), 27) * PRIME1 + PRIME4;
+    if (size >= 4) {
+        hash = rotateLeft(hash ^ (read32(data) * PRIME1), 23) * PRIME2 + PRIME3;
+        data += 4;
+        size -= 4;
+    }
+    for (; size > 0; ++data, --size)
+        hash = rotateLeft(hash ^ (static_cast<unsigned char>(*data) * PRIME5), 11) * PRIME1;
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+std::string Hasher::checksum(void) const {
+    static const char digits[] = "0123456789abcdef";
+    uint64_t hash = digest();
+    std::string checksum(xxh64Prefix);
+    for (int shift = 60; shift >= 0; shift -= 4)
+        checksum.push_back(digits[(hash >> shift) & 0xF]);
+    return checksum;
+}
+
+bool algorithm(const std::string &checksum, Algorithm &algorithm) {
+    if (checksum.compare(0, xxh64Prefix.size(), xxh64Prefix) == 0) {
+        algorithm = Algorithm::XXH64;
+        return true;
+    }
+    if (checksum.compare(0, md5CryptPrefix.size(), md5CryptPrefix) == 0) {
+        algorithm = Algorithm::MD5_CRYPT;
+        return true;
+    }
+    return false;
+}
+
+} // namespace Checksum
+
+} // namespace Cynara
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/Checksum.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines checksum algorithms of database files
+ */
+
+#ifndef SRC_STORAGE_CHECKSUM_H_
+#define SRC_STORAGE_CHECKSUM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Cynara {
+
+namespace Checksum {
+
+/*
+ * Checksum records start with algorithm identifier, like in crypt(3) output:
+ * "$1$$<md5-crypt>" written by Cynara older than 0.8.0 and "$xxh64$<16 hex digits>".
+ */
+enum class Algorithm {
+    MD5_CRYPT,
+    XXH64,
+};
+
+const Algorithm DEFAULT_ALGORITHM = Algorithm::XXH64;
+
+/*
+ * Incremental XXH64 hash, so files can be checksummed while they are streamed.
+ * Kept free of Cynara libraries, as it is built into cynara-db-chsgen too.
+ */
+class Hasher {
+public:
+    Hasher(uint64_t seed = 0);
+
+    void update(const char *data, std::size_t size);
+    uint64_t digest(void) const;
+
+    // Checksum record of data passed so far
+    std::string checksum(void) const;
+
+private:
+    void consumeStripe(const char *stripe);
+
+    static const std::size_t STRIPE_SIZE = 32;
+
+    uint64_t m_seed;
+    uint64_t m_accumulators[4];
+    uint64_t m_totalSize;
+    char m_stripe[STRIPE_SIZE];
+    std::size_t m_stripeSize;
+};
+
+// Returns false when checksum record was written by unknown algorithm
+bool algorithm(const std::string &checksum, Algorithm &algorithm);
+
+} // namespace Checksum
+
+} // namespace Cynara
+
+#endif /* SRC_STORAGE_CHECKSUM_H_ */
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/ChecksumInputStream.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file implements input file stream computing checksum of data being read
+ */
+
+#include "ChecksumInputStream.h"
+
+namespace Cynara {
+
+ChecksumInputStream::ChecksumInputStream(const std::string &filename, bool keepContents)
+    : std::istream(nullptr), m_buffer(filename, keepContents) {
+    rdbuf(&m_buffer);
+}
+
+std::string ChecksumInputStream::checksum(void) {
+    m_buffer.drain();
+    return m_buffer.checksum();
+}
+
+const std::string &ChecksumInputStream::contents(void) {
+    m_buffer.drain();
+    return m_buffer.contents();
+}
+
+ChecksumInputStream::HashingBuffer::HashingBuffer(const std::string &filename,
+                                                  bool keepContents)
+    : m_keepContents(keepContents) {
+    m_file.open(filename, std::ios_base::in);
+    setg(m_data, m_data, m_data);
+}
+
+void ChecksumInputStream::HashingBuffer::drain(void) {
+    while (!traits_type::eq_int_type(underflow(), traits_type::eof())) {
+        setg(m_data, egptr(), egptr());
+    }
+}
+
+ChecksumInputStream::HashingBuffer::int_type ChecksumInputStream::HashingBuffer::underflow(void) {
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    std::streamsize size = m_file.is_open() ? m_file.sgetn(m_data, BUFFER_SIZE) : 0;
+    if (size <= 0)
+        return traits_type::eof();
+
+    m_hasher.update(m_data, static_cast<std::size_t>(size));
+    if (m_keepContents)
+        m_contents.append(m_data, static_cast<std::size_t>(size));
+
+    setg(m_data, m_data, m_data + size);
+    return traits_type::to_int_type(*gptr());
+}
+
+} // namespace Cynara
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/ChecksumInputStream.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines input file stream computing checksum of data being read
+ */
+
+#ifndef SRC_STORAGE_CHECKSUMINPUTSTREAM_H_
+#define SRC_STORAGE_CHECKSUMINPUTSTREAM_H_
+
+#include <cstddef>
+#include <fstream>
+#include <istream>
+#include <streambuf>
+#include <string>
+
+#include <storage/Checksum.h>
+
+namespace Cynara {
+
+/*
+ * File is hashed while deserializers parse it, so database is verified in a single pass.
+ * Whole contents are kept only on demand, for algorithms which cannot work incrementally.
+ */
+class ChecksumInputStream : public std::istream {
+public:
+    ChecksumInputStream(const std::string &filename, bool keepContents);
+
+    bool is_open(void) const {
+        return m_buffer.is_open();
+    }
+
+    // Both read rest of file first, so results always cover whole file
+    std::string checksum(void);
+    const std::string &contents(void);
+
+private:
+    class HashingBuffer : public std::streambuf {
+    public:
+        HashingBuffer(const std::string &filename, bool keepContents);
+
+        bool is_open(void) const {
+            return m_file.is_open();
+        }
+        void drain(void);
+
+        std::string checksum(void) const {
+            return m_hasher.checksum();
+        }
+        const std::string &contents(void) const {
+            return m_contents;
+        }
+
+    protected:
+        virtual int_type underflow(void);
+
+    private:
+        static const std::size_t BUFFER_SIZE = 16 * 1024;
+
+        std::filebuf m_file;
+        Checksum::Hasher m_hasher;
+        bool m_keepContents;
+        std::string m_contents;
+        char m_data[BUFFER_SIZE];
+    };
+
+    HashingBuffer m_buffer;
+};
+
+} // namespace Cynara
+
+#endif /* SRC_STORAGE_CHECKSUMINPUTSTREAM_H_ */
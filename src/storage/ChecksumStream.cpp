@@ -25,8 +25,6 @@
 
 #include <config/PathConfig.h>
 
-#include <storage/ChecksumValidator.h>
-
 #include "ChecksumStream.h"
 
 namespace Cynara {
@@ -41,17 +39,18 @@ ChecksumStream::~ChecksumStream() {
 }
 
 ChecksumStream& ChecksumStream::operator<<(std::ostream& (*manip)(std::ostream&)) {
-    m_bufStream << manip;
     m_outStream << manip;
     return *this;
 }
 
 void ChecksumStream::open(const std::string &filename, std::ios_base::openmode mode) {
-    m_outStream.open(filename, mode);
+    if (!m_buffer.open(filename, mode)) {
+        m_outStream.setstate(std::ios_base::failbit);
+    }
 }
 
 bool ChecksumStream::is_open(void) const {
-    return m_outStream.is_open();
+    return m_buffer.is_open();
 }
 
 std::ios_base::fmtflags ChecksumStream::flags(void) const {
@@ -63,9 +62,45 @@ std::ios_base::fmtflags ChecksumStream::flags(std::ios_base::fmtflags flags) {
 }
 
 void ChecksumStream::save() {
-    m_outStream.close();
-    *m_chsStream << m_filename << m_fieldSeparator << ChecksumValidator::generate(m_bufStream.str())
-                 << m_recordSeparator;
+    m_outStream.flush();
+    m_buffer.close();
+    *m_chsStream << m_filename << m_fieldSeparator << m_buffer.checksum() << m_recordSeparator;
+}
+
+ChecksumStream::HashingBuffer::HashingBuffer() {
+    setp(m_data, m_data + BUFFER_SIZE);
+}
+
+bool ChecksumStream::HashingBuffer::open(const std::string &filename,
+                                         std::ios_base::openmode mode) {
+    return m_file.open(filename, mode | std::ios_base::out) != nullptr;
+}
+
+bool ChecksumStream::HashingBuffer::close(void) {
+    bool flushed = flushBuffer();
+    return m_file.close() != nullptr && flushed;
+}
+
+ChecksumStream::HashingBuffer::int_type ChecksumStream::HashingBuffer::overflow(int_type c) {
+    if (!flushBuffer())
+        return traits_type::eof();
+
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+int ChecksumStream::HashingBuffer::sync(void) {
+    return flushBuffer() && m_file.pubsync() == 0 ? 0 : -1;
+}
+
+bool ChecksumStream::HashingBuffer::flushBuffer(void) {
+    std::streamsize size = pptr() - pbase();
+    m_hasher.update(pbase(), static_cast<std::size_t>(size));
+    setp(m_data, m_data + BUFFER_SIZE);
+    return m_file.sputn(m_data, size) == size;
 }
 
 } // namespace Cynara
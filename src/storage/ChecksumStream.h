@@ -23,18 +23,25 @@
 #ifndef SRC_STORAGE_CHECKSUMSTREAM_H_
 #define SRC_STORAGE_CHECKSUMSTREAM_H_
 
+#include <cstddef>
 #include <fstream>
 #include <iostream>
 #include <memory>
-#include <sstream>
+#include <streambuf>
 #include <string>
 
+#include <storage/Checksum.h>
+
 namespace Cynara {
 
+/*
+ * Data is hashed on its way to file, so checksum is ready when file is written
+ * without keeping a copy of whole file in memory.
+ */
 class ChecksumStream {
 public:
     ChecksumStream(const std::string &filename, const std::shared_ptr<std::ofstream> &stream)
-    : m_chsStream(stream), m_filename(filename) {
+    : m_chsStream(stream), m_outStream(&m_buffer), m_filename(filename) {
     }
     ~ChecksumStream();
 
@@ -48,11 +55,39 @@ public:
     std::ios_base::fmtflags flags(std::ios_base::fmtflags flags);
 
 private:
+    class HashingBuffer : public std::streambuf {
+    public:
+        HashingBuffer();
+
+        bool open(const std::string &filename, std::ios_base::openmode mode);
+        bool is_open(void) const {
+            return m_file.is_open();
+        }
+        bool close(void);
+
+        std::string checksum(void) const {
+            return m_hasher.checksum();
+        }
+
+    protected:
+        virtual int_type overflow(int_type c);
+        virtual int sync(void);
+
+    private:
+        bool flushBuffer(void);
+
+        static const std::size_t BUFFER_SIZE = 4096;
+
+        std::filebuf m_file;
+        Checksum::Hasher m_hasher;
+        char m_data[BUFFER_SIZE];
+    };
+
     void save(void);
 
     std::shared_ptr<std::ofstream> m_chsStream;
-    std::ofstream m_outStream;
-    std::stringstream m_bufStream;
+    HashingBuffer m_buffer;
+    std::ostream m_outStream;
     const std::string m_filename;
     static const char m_fieldSeparator;
     static const char m_recordSeparator;
@@ -60,7 +95,6 @@ private:
 
 template<typename Type>
 ChecksumStream& ChecksumStream::operator<<(const Type& item) {
-    m_bufStream << item;
     m_outStream << item;
     return *this;
 }
@@ -21,6 +21,7 @@
  */
 
 #include <algorithm>
+#include <crypt.h>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
@@ -34,6 +35,8 @@
 #include <exceptions/UnexpectedErrorException.h>
 #include <log/log.h>
 
+#include <storage/Checksum.h>
+
 #include "ChecksumValidator.h"
 
 namespace Cynara {
@@ -57,8 +60,18 @@ void ChecksumValidator::load(std::istream &stream) {
     }
 };
 
-const std::string ChecksumValidator::generate(const std::string &data) {
-    const char *checksum = crypt(data.c_str(), "$1$");
+const std::string ChecksumValidator::generate(const std::string &data,
+                                              Checksum::Algorithm algorithm) {
+    if (algorithm == Checksum::Algorithm::XXH64) {
+        Checksum::Hasher hasher;
+        hasher.update(data.data(), data.size());
+        return hasher.checksum();
+    }
+
+    // crypt() uses static buffer, so reentrant version is needed for concurrent loading
+    std::unique_ptr<struct crypt_data> cryptData(new struct crypt_data);
+    cryptData->initialized = 0;
+    const char *checksum = crypt_r(data.c_str(), "$1$", cryptData.get());
 
     if (nullptr != checksum) {
         return checksum;
@@ -74,11 +87,65 @@ const std::string ChecksumValidator::generate(const std::string &data) {
 };
 
 void ChecksumValidator::compare(std::istream &stream, const std::string &pathname,
-                                bool isBackupValid) {
+                                bool isBackupValid) const {
     if (isChecksumIndex(pathname)) {
         return;
     }
 
+    std::stringstream copyStream;
+    std::copy(std::istreambuf_iterator<char>(stream),
+              std::istreambuf_iterator<char>(),
+              std::ostreambuf_iterator<char>(copyStream));
+    stream.seekg(0);
+
+    compare(copyStream.str(), pathname, isBackupValid);
+};
+
+void ChecksumValidator::compare(const std::string &data, const std::string &pathname,
+                                bool isBackupValid) const {
+    if (isChecksumIndex(pathname)) {
+        return;
+    }
+
+    Checksum::Algorithm algorithm;
+    auto expected = recordedChecksum(pathname, isBackupValid, algorithm);
+    if (expected != generate(data, algorithm)) {
+        throw ChecksumRecordCorruptedException(expected);
+    }
+};
+
+void ChecksumValidator::verify(ChecksumInputStream &stream, const std::string &pathname,
+                               bool isBackupValid) const {
+    if (isChecksumIndex(pathname)) {
+        return;
+    }
+
+    Checksum::Algorithm algorithm;
+    auto expected = recordedChecksum(pathname, isBackupValid, algorithm);
+    auto actual = (algorithm == Checksum::Algorithm::XXH64) ? stream.checksum()
+                                                            : generate(stream.contents(), algorithm);
+    if (expected != actual) {
+        throw ChecksumRecordCorruptedException(expected);
+    }
+}
+
+bool ChecksumValidator::needsContents(const std::string &pathname, bool isBackupValid) const {
+    if (isChecksumIndex(pathname)) {
+        return false;
+    }
+
+    try {
+        Checksum::Algorithm algorithm;
+        recordedChecksum(pathname, isBackupValid, algorithm);
+        return algorithm != Checksum::Algorithm::XXH64;
+    } catch (const ChecksumRecordCorruptedException &) {
+        // verify() will report it
+        return false;
+    }
+}
+
+std::string ChecksumValidator::recordedChecksum(const std::string &pathname, bool isBackupValid,
+                                                Checksum::Algorithm &algorithm) const {
     std::unique_ptr<char, decltype(free)*> pathnameDuplicate(strdup(pathname.c_str()), free);
     if (pathnameDuplicate == nullptr) {
         LOGE("Insufficient memory available to allocate duplicate filename: <%s>",
@@ -87,7 +154,6 @@ void ChecksumValidator::compare(std::istream &stream, const std::string &pathnam
     }
 
     std::string filename(::basename(pathnameDuplicate.get()));
-    std::stringstream copyStream;
 
     if (isBackupValid) {
         auto backupSuffixPos = filename.rfind(PathConfig::StoragePath::backupFilenameSuffix);
@@ -99,15 +165,18 @@ void ChecksumValidator::compare(std::istream &stream, const std::string &pathnam
         }
     }
 
-    std::copy(std::istreambuf_iterator<char>(stream),
-              std::istreambuf_iterator<char>(),
-              std::ostreambuf_iterator<char>(copyStream));
-    stream.seekg(0);
-
-    if (m_sums[filename] != generate(copyStream.str())) {
-        throw ChecksumRecordCorruptedException(m_sums[filename]);
+    // Records keep checksums of the algorithm they were written with
+    auto expected = checksum(filename);
+    if (!Checksum::algorithm(expected, algorithm)) {
+        throw ChecksumRecordCorruptedException(expected);
     }
-};
+    return expected;
+}
+
+std::string ChecksumValidator::checksum(const std::string &filename) const {
+    auto it = m_sums.find(filename);
+    return it != m_sums.end() ? it->second : std::string();
+}
 
 const std::string ChecksumValidator::parseFilename(const std::string &line,
                                                    std::size_t &beginToken) {
@@ -28,6 +28,9 @@
 #include <string>
 #include <unordered_map>
 
+#include <storage/Checksum.h>
+#include <storage/ChecksumInputStream.h>
+
 namespace Cynara {
 
 class ChecksumValidator;
@@ -38,18 +41,32 @@ public:
     ChecksumValidator(const std::string &path) : m_dbPath(path) {}
 
     void load(std::istream &stream);
-    void compare(std::istream &stream, const std::string &pathname, bool isBackupValid);
+    void compare(std::istream &stream, const std::string &pathname, bool isBackupValid) const;
+    // Compares already read file contents; safe to call from several threads at once
+    void compare(const std::string &data, const std::string &pathname, bool isBackupValid) const;
+
+    // Verifies file after it was parsed through stream, without reading it again
+    void verify(ChecksumInputStream &stream, const std::string &pathname,
+                bool isBackupValid) const;
+    // Tells if stream opened for verify() has to keep file contents for recorded algorithm
+    bool needsContents(const std::string &pathname, bool isBackupValid) const;
 
     void clear(void) {
         m_sums.clear();
     }
 
-    static const std::string generate(const std::string &data);
+    // Returns checksum recorded for given database file or empty string if there is none
+    std::string checksum(const std::string &filename) const;
+
+    static const std::string generate(const std::string &data,
+                                      Checksum::Algorithm algorithm = Checksum::DEFAULT_ALGORITHM);
 
 protected:
     typedef std::unordered_map<std::string, std::string> Checksums;
 
     bool isChecksumIndex(const std::string &pathname) const;
+    std::string recordedChecksum(const std::string &pathname, bool isBackupValid,
+                                 Checksum::Algorithm &algorithm) const;
 
     static const std::string parseFilename(const std::string &line, std::size_t &beginToken);
     static const std::string parseChecksum(const std::string &line, std::size_t &beginToken);
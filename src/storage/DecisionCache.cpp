@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/DecisionCache.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file contains decision cache implementation
+ */
+
+#include <log/log.h>
+
+#include "DecisionCache.h"
+
+namespace Cynara {
+
+const std::size_t DecisionCache::CACHE_DEFAULT_CAPACITY;
+
+DecisionCache::DecisionCache(std::size_t capacity) : m_capacity(capacity), m_hits(0),
+    m_misses(0), m_generation(0), m_hand(0) {
+    if (m_capacity > 0)
+        m_referenced.reset(new std::atomic<bool>[m_capacity]());
+}
+
+bool DecisionCache::get(const PolicyKey &key, PolicyResult &result) {
+    if (m_capacity == 0)
+        return false;
+
+    ReadLockGuard guard(m_lock);
+
+    auto resultIt = m_entries.find(key);
+    if (resultIt == m_entries.end()) {
+        ++m_misses;
+        return false;
+    }
+
+    ++m_hits;
+    m_referenced[resultIt->second.slot].store(true, std::memory_order_relaxed);
+    result = resultIt->second.result;
+    return true;
+}
+
+void DecisionCache::update(const PolicyKey &key, const PolicyResult &result) {
+    if (m_capacity == 0)
+        return;
+
+    WriteLockGuard guard(m_lock);
+    store(key, result);
+}
+
+void DecisionCache::update(const PolicyKey &key, const PolicyResult &result,
+                           std::size_t generation) {
+    if (m_capacity == 0)
+        return;
+
+    WriteLockGuard guard(m_lock);
+    if (generation == m_generation)
+        store(key, result);
+}
+
+void DecisionCache::store(const PolicyKey &key, const PolicyResult &result) {
+    auto resultIt = m_entries.find(key);
+    if (resultIt != m_entries.end()) {
+        resultIt->second.result = result;
+        m_referenced[resultIt->second.slot].store(true, std::memory_order_relaxed);
+        return;
+    }
+
+    std::size_t slot;
+    if (m_clock.size() < m_capacity) {
+        slot = m_clock.size();
+        m_clock.push_back(nullptr);
+    } else {
+        slot = evict();
+    }
+
+    auto inserted = m_entries.insert(std::make_pair(key, Entry{result, slot})).first;
+    m_clock[slot] = &inserted->first;
+    m_referenced[slot].store(false, std::memory_order_relaxed);
+}
+
+void DecisionCache::clear(void) {
+    WriteLockGuard guard(m_lock);
+
+    LOGD("Clearing decision cache: entries [%zu], hits [%zu], misses [%zu]",
+         m_entries.size(), m_hits.load(), m_misses.load());
+    m_entries.clear();
+    m_clock.clear();
+    m_hand = 0;
+    ++m_generation;
+}
+
+std::size_t DecisionCache::generation(void) const {
+    return m_generation;
+}
+
+std::size_t DecisionCache::hits(void) const {
+    return m_hits;
+}
+
+std::size_t DecisionCache::misses(void) const {
+    return m_misses;
+}
+
+std::size_t DecisionCache::evict(void) {
+    // Referenced entries get second chance, first not referenced one is evicted
+    while (m_referenced[m_hand].exchange(false, std::memory_order_relaxed))
+        m_hand = (m_hand + 1) % m_capacity;
+
+    std::size_t slot = m_hand;
+    m_entries.erase(m_entries.find(*m_clock[slot]));
+    m_hand = (m_hand + 1) % m_capacity;
+    return slot;
+}
+
+} // namespace Cynara
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/DecisionCache.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file contains decision cache header
+ */
+
+#ifndef SRC_STORAGE_DECISIONCACHE_H_
+#define SRC_STORAGE_DECISIONCACHE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <lock/ReadWriteLock.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyKeyHelpers.h>
+#include <types/PolicyResult.h>
+
+namespace Cynara {
+
+/**
+ * Bounded cache of results of full (recursive, starting in default bucket)
+ * storage checks. Cache is safe to use from many threads. It must be cleared
+ * whenever any policy or bucket is changed.
+ * Entries are keyed by policy keys compared by interned ids, so no string is built for
+ * lookup. Entries are evicted with CLOCK (second chance) policy: a hit only marks its entry
+ * as referenced, so many threads can be served from cache concurrently.
+ * Every clear starts new generation. Checks evaluated on storage snapshot, which
+ * could be replaced meanwhile, store results only if generation did not change.
+ */
+class DecisionCache {
+public:
+    static const std::size_t CACHE_DEFAULT_CAPACITY = 10000;
+
+    DecisionCache(std::size_t capacity = CACHE_DEFAULT_CAPACITY);
+
+    bool get(const PolicyKey &key, PolicyResult &result);
+    void update(const PolicyKey &key, const PolicyResult &result);
+    // Stores result only if cache was not cleared since generation was read
+    void update(const PolicyKey &key, const PolicyResult &result, std::size_t generation);
+    void clear(void);
+
+    std::size_t generation(void) const;
+
+    std::size_t hits(void) const;
+    std::size_t misses(void) const;
+
+private:
+    // Interned features are equal when their ids are equal. Transient ones share
+    // NOT_INTERNED_ID, so their values are compared and hashed.
+    struct KeyHash {
+        std::size_t operator()(const PolicyKey &key) const {
+            return PolicyKeyHelpers::hashKey(key);
+        }
+    };
+
+    struct KeyEqual {
+        bool operator()(const PolicyKey &key1, const PolicyKey &key2) const {
+            return PolicyKeyIds(key1) == PolicyKeyIds(key2) && key1 == key2;
+        }
+    };
+
+    struct Entry {
+        PolicyResult result;
+        std::size_t slot;
+    };
+
+    typedef std::unordered_map<PolicyKey, Entry, KeyHash, KeyEqual> Entries;
+
+    void store(const PolicyKey &key, const PolicyResult &result);
+    std::size_t evict(void);
+
+    const std::size_t m_capacity;
+    std::atomic<std::size_t> m_hits;
+    std::atomic<std::size_t> m_misses;
+    std::atomic<std::size_t> m_generation;
+
+    Entries m_entries;
+    // Clock slots point to keys of entries; referenced flags are set by hits under read lock
+    std::vector<const PolicyKey *> m_clock;
+    std::unique_ptr<std::atomic<bool>[]> m_referenced;
+    std::size_t m_hand;
+    mutable ReadWriteLock m_lock;
+};
+
+} // namespace Cynara
+
+#endif /* SRC_STORAGE_DECISIONCACHE_H_ */
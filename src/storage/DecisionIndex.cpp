@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/DecisionIndex.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file contains decision index implementation
+ */
+
+#include <unordered_map>
+#include <vector>
+
+#include <log/log.h>
+#include <types/PolicyBucket.h>
+#include <types/PolicyBucketId.h>
+#include <types/PolicyType.h>
+
+#include <storage/StorageSnapshot.h>
+
+#include "DecisionIndex.h"
+
+namespace Cynara {
+
+DecisionIndex::DecisionIndex(bool enabled) : m_enabled(enabled), m_state(State::Invalid) {
+}
+
+bool DecisionIndex::check(const StorageSnapshot &snapshot, const PolicyKey &key,
+                          const PolicyKeyHashes &hashes, PolicyResult &result) {
+    if (!m_enabled)
+        return false;
+
+    if (m_state.load() == State::Invalid) {
+        // Only one thread compiles index; others check snapshot buckets meanwhile
+        std::unique_lock<std::mutex> lock(m_compileMutex, std::try_to_lock);
+        if (!lock.owns_lock())
+            return false;
+        if (m_state.load() == State::Invalid)
+            m_state.store(compile(snapshot) ? State::Ready : State::Unusable);
+    }
+
+    if (m_state.load() != State::Ready)
+        return false;
+
+    Matches matches;
+    std::size_t count = 0;
+    for (unsigned variant = 0; variant < PolicyKeyHelpers::VARIANTS_COUNT; ++variant) {
+        if (PolicyKeyHelpers::isVariantRedundant(key, variant))
+            continue;
+
+        auto range = m_entries.equal_range(PolicyKeyHelpers::variantHash(hashes, variant));
+        for (auto it = range.first; it != range.second; ++it) {
+            if (PolicyKeyHelpers::matchesVariant(it->second.key, key, variant)) {
+                matches[count++] = &it->second;
+                break;
+            }
+        }
+    }
+
+    result = minimalPolicy(0, matches, count);
+    return true;
+}
+
+bool DecisionIndex::compile(const StorageSnapshot &snapshot) {
+    std::unordered_map<PolicyBucketId, std::size_t> indexes;
+    std::vector<const PolicyBucket *> reachable;
+    auto visit = [&] (const PolicyBucketId &bucketId) -> bool {
+        if (indexes.count(bucketId))
+            return true;
+
+        auto bucket = snapshot.bucket(bucketId);
+        if (!bucket) {
+            LOGW("Decision index not compiled: bucket <%s> does not exist", bucketId.c_str());
+            return false;
+        }
+        indexes[bucketId] = reachable.size();
+        reachable.push_back(bucket);
+        return true;
+    };
+
+    // Default bucket gets index 0
+    if (!visit(defaultPolicyBucketId))
+        return false;
+
+    for (std::size_t index = 0; index < reachable.size(); ++index) {
+        const auto &bucket = *reachable[index];
+        m_defaultPolicies.push_back(bucket.defaultPolicy());
+
+        for (const auto &policy : bucket) {
+            const auto &policyResult = policy->result();
+            std::size_t target = 0;
+            if (policyResult.policyType() == PredefinedPolicyType::BUCKET) {
+                if (!visit(policyResult.metadata()))
+                    return false;
+                target = indexes[policyResult.metadata()];
+            }
+            entry(policy->key()).rules.emplace_back(index, policyResult, target);
+        }
+    }
+
+    LOGD("Decision index compiled: buckets [%zu], keys [%zu]",
+         m_defaultPolicies.size(), m_entries.size());
+    return true;
+}
+
+DecisionIndex::Entry &DecisionIndex::entry(const PolicyKey &key) {
+    auto hash = PolicyKeyHelpers::hashKey(key);
+    auto range = m_entries.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.key == key)
+            return it->second;
+    }
+    return m_entries.emplace(hash, Entry(key))->second;
+}
+
+PolicyResult DecisionIndex::minimalPolicy(std::size_t bucket, const Matches &matches,
+                                          std::size_t count) const {
+    bool hasMinimal = false;
+    PolicyResult minimal = m_defaultPolicies[bucket];
+
+    auto proposeMinimal = [&minimal, &hasMinimal](const PolicyResult &candidate) {
+        if (hasMinimal == false) {
+            minimal = candidate;
+        } else if (candidate < minimal) {
+            minimal = candidate;
+        }
+        hasMinimal = true;
+    };
+
+    for (std::size_t i = 0; i < count; ++i) {
+        for (const auto &rule : matches[i]->rules) {
+            if (rule.bucket != bucket)
+                continue;
+
+            switch (rule.result.policyType()) {
+                case PredefinedPolicyType::DENY:
+                    return rule.result; // Do not expect lower value than DENY
+                case PredefinedPolicyType::BUCKET: {
+                        auto minimumOfBucket = minimalPolicy(rule.target, matches, count);
+                        if (minimumOfBucket != PredefinedPolicyType::NONE) {
+                            proposeMinimal(minimumOfBucket);
+                        }
+                        continue;
+                    }
+                case PredefinedPolicyType::ALLOW:
+                default:
+                    break;
+            }
+
+            proposeMinimal(rule.result);
+        }
+    }
+
+    return minimal;
+}
+
+} // namespace Cynara
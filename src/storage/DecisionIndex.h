@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/DecisionIndex.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines decision index - bucket graph compiled for checks
+ */
+
+#ifndef SRC_STORAGE_DECISIONINDEX_H_
+#define SRC_STORAGE_DECISIONINDEX_H_
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <types/PolicyKey.h>
+#include <types/PolicyKeyHelpers.h>
+#include <types/PolicyResult.h>
+
+namespace Cynara {
+
+class StorageSnapshot;
+
+/**
+ * Buckets reachable from default bucket, flattened into single map from policy key
+ * to all policies with that key in all those buckets. Full check probes the map once
+ * per key variant, no matter how deep bucket links go, and evaluates bucket graph
+ * on found policies only.
+ *
+ * Index is compiled lazily by the first check from buckets of immutable storage snapshot,
+ * which owns the index. Checks may run concurrently. Checks done while index is being
+ * compiled are not indexed, so they do not wait for compilation.
+ */
+class DecisionIndex {
+public:
+    DecisionIndex(bool enabled = false);
+
+    /*
+     * Evaluates recursive check starting in default bucket.
+     * Returns false, when index is disabled, cannot be compiled for given snapshot
+     * or is being compiled by another thread.
+     */
+    bool check(const StorageSnapshot &snapshot, const PolicyKey &key,
+               const PolicyKeyHashes &hashes, PolicyResult &result);
+
+    bool enabled(void) const {
+        return m_enabled;
+    }
+
+private:
+    struct Rule {
+        Rule(std::size_t bucketIndex, const PolicyResult &policyResult, std::size_t targetIndex)
+            : bucket(bucketIndex), result(policyResult), target(targetIndex) {}
+
+        std::size_t bucket;
+        PolicyResult result;
+        std::size_t target; // Index of linked bucket for BUCKET policies
+    };
+
+    struct Entry {
+        Entry(const PolicyKey &policyKey) : key(policyKey) {}
+
+        PolicyKey key;
+        std::vector<Rule> rules;
+    };
+
+    typedef std::unordered_multimap<std::size_t, Entry> Entries;
+    typedef const Entry *Matches[PolicyKeyHelpers::VARIANTS_COUNT];
+
+    enum class State {
+        Invalid,
+        Ready,
+        Unusable,
+    };
+
+    bool compile(const StorageSnapshot &snapshot);
+    Entry &entry(const PolicyKey &key);
+    PolicyResult minimalPolicy(std::size_t bucket, const Matches &matches,
+                               std::size_t count) const;
+
+    bool m_enabled;
+    std::atomic<State> m_state;
+    std::mutex m_compileMutex;
+
+    Entries m_entries;
+    std::vector<PolicyResult> m_defaultPolicies;
+};
+
+} // namespace Cynara
+
+#endif /* SRC_STORAGE_DECISIONINDEX_H_ */
@@ -35,6 +35,7 @@
 
 #include <log/log.h>
 #include <config/PathConfig.h>
+#include <exceptions/BucketDeserializationException.h>
 #include <exceptions/BucketNotExistsException.h>
 #include <exceptions/DatabaseCorruptedException.h>
 #include <exceptions/DatabaseException.h>
@@ -44,7 +45,10 @@
 #include <types/PolicyResult.h>
 #include <types/PolicyType.h>
 
+#include <storage/BinaryDeserializer.h>
+#include <storage/BinarySerializer.h>
 #include <storage/BucketDeserializer.h>
+#include <storage/ChecksumInputStream.h>
 #include <storage/Integrity.h>
 #include <storage/StorageDeserializer.h>
 #include <storage/StorageSerializer.h>
@@ -54,10 +58,45 @@
 namespace Cynara {
 
 InMemoryStorageBackend::InMemoryStorageBackend(const std::string &path) : m_dbPath(path),
-    m_checksum(path), m_integrity(path) {
+    m_checksum(path), m_integrity(path), m_format(DatabaseFormat::TEXT),
+    m_wal(path + PathConfig::StoragePath::walFilename) {
 }
 
 void InMemoryStorageBackend::load(void) {
+    loadDatabase();
+
+    // Modifications committed after last snapshot are applied and folded into new one
+    m_wal.open();
+    if (replayLog() > 0) {
+        LOGN("Folding write-ahead log into database.");
+        save();
+    }
+
+    publishSnapshot();
+}
+
+void InMemoryStorageBackend::rollback(void) {
+    // Database snapshot with committed frames of log is the last durable state. Log is not
+    // folded, as writing database has just failed.
+    loadDatabase();
+    if (m_wal.isOpen())
+        replayLog();
+    publishSnapshot();
+}
+
+std::size_t InMemoryStorageBackend::replayLog(void) {
+    try {
+        return m_wal.replay(*this);
+    } catch (const DatabaseCorruptedException &) {
+        LOGC("Replaying write-ahead log failed.");
+        buckets().clear();
+        m_checksum.clear();
+        publishSnapshot();
+        throw;
+    }
+}
+
+void InMemoryStorageBackend::loadDatabase(void) {
     bool isBackupValid = m_integrity.backupGuardExists();
     std::string bucketSuffix = "";
     std::string indexFilename = m_dbPath + PathConfig::StoragePath::indexFilename;
@@ -70,25 +109,37 @@ void InMemoryStorageBackend::load(void) {
     }
 
     try {
-        std::ifstream chsStream;
-        openFileStream(chsStream, chsFilename, isBackupValid);
-        m_checksum.load(chsStream);
-
-        auto indexStream = std::make_shared<std::ifstream>();
-        openFileStream(*indexStream, indexFilename, isBackupValid);
-
-        StorageDeserializer storageDeserializer(indexStream,
-            std::bind(&InMemoryStorageBackend::bucketStreamOpener, this,
-                      std::placeholders::_1, bucketSuffix, isBackupValid));
-
-        storageDeserializer.initBuckets(buckets());
-        storageDeserializer.loadBuckets(buckets());
+        if (BinaryDeserializer::isBinaryFile(indexFilename)) {
+            m_format = DatabaseFormat::BINARY;
+            loadBinaryDatabase(indexFilename, bucketSuffix);
+        } else {
+            m_format = DatabaseFormat::TEXT;
+            std::ifstream chsStream;
+            openFileStream(chsStream, chsFilename, isBackupValid);
+            m_checksum.load(chsStream);
+
+            auto indexStream = openChecksumStream(indexFilename, isBackupValid);
+
+            StorageDeserializer storageDeserializer(indexStream,
+                std::bind(&InMemoryStorageBackend::bucketStreamOpener, this,
+                          std::placeholders::_1, bucketSuffix, isBackupValid));
+
+            storageDeserializer.initBuckets(buckets());
+            m_checksum.verify(*indexStream, indexFilename, isBackupValid);
+            storageDeserializer.loadBuckets(buckets());
+        }
     } catch (const DatabaseException &) {
         LOGC("Reading cynara database failed.");
         buckets().clear();
+        m_checksum.clear();
+        publishSnapshot();
         throw DatabaseCorruptedException();
     }
-    m_checksum.clear();
+
+    // Loaded buckets match files on disk; checksums are kept to reuse them for unmodified buckets
+    for (auto &bucketIter : buckets()) {
+        bucketIter.second.setDirty(false);
+    }
 
     if (!hasBucket(defaultPolicyBucketId)) {
         LOGN("Creating defaultBucket.");
@@ -104,12 +155,64 @@ void InMemoryStorageBackend::save(void) {
     openDumpFileStream<std::ofstream>(*chsStream,
             checksumFilename + PathConfig::StoragePath::backupFilenameSuffix);
 
-    dumpDatabase(chsStream);
+    // Only dirty buckets are rewritten, backups of other ones are hard links to primary files
+    auto modifiedIds = backupUnmodifiedBuckets(*chsStream);
 
-    m_integrity.syncDatabase(buckets(), true);
+    if (m_format == DatabaseFormat::BINARY) {
+        // Binary files carry their own checksums, so checksum index is left empty
+        dumpBinaryDatabase(modifiedIds);
+    } else {
+        dumpDatabase(chsStream, modifiedIds);
+    }
+    chsStream->close();
+
+    m_integrity.syncDatabase(modifiedIds, true);
     m_integrity.createBackupGuard();
-    m_integrity.revalidatePrimaryDatabase(buckets());
+    m_integrity.revalidatePrimaryDatabase(buckets(), modifiedIds);
     //guard is removed during revalidation
+
+    for (auto &bucketIter : buckets()) {
+        bucketIter.second.setDirty(false);
+    }
+
+    if (m_format == DatabaseFormat::BINARY) {
+        m_checksum.clear();
+    } else {
+        std::ifstream stream(checksumFilename);
+        m_checksum.load(stream);
+    }
+
+    // Snapshot contains all modifications, so log can be dropped
+    m_wal.reset();
+}
+
+void InMemoryStorageBackend::commit(void) {
+    if (!m_wal.isOpen()) {
+        save();
+        return;
+    }
+
+    m_wal.commit();
+}
+
+StorageSnapshotPtr InMemoryStorageBackend::snapshot(void) const {
+    return std::atomic_load(&m_snapshot);
+}
+
+void InMemoryStorageBackend::publishSnapshot(void) {
+    auto previous = snapshot();
+    std::atomic_store(&m_snapshot,
+                      std::make_shared<const StorageSnapshot>(buckets(), previous.get()));
+}
+
+void InMemoryStorageBackend::setFormat(DatabaseFormat format) {
+    if (format == m_format)
+        return;
+
+    m_format = format;
+    for (auto &bucketIter : buckets()) {
+        bucketIter.second.setDirty(true);
+    }
 }
 
 PolicyBucket InMemoryStorageBackend::searchDefaultBucket(const PolicyKey &key) {
@@ -126,10 +229,25 @@ PolicyBucket InMemoryStorageBackend::searchBucket(const PolicyBucketId &bucketId
     }
 }
 
+std::size_t InMemoryStorageBackend::matchBucket(const PolicyBucketId &bucketId,
+                                                const PolicyKey &key,
+                                                const PolicyKeyHashes &hashes,
+                                                PolicyResult &defaultPolicy,
+                                                PolicyBucket::Matches &matches) {
+    auto bucketIt = buckets().find(bucketId);
+    if (bucketIt == buckets().end())
+        throw BucketNotExistsException(bucketId);
+
+    const auto &bucket = bucketIt->second;
+    defaultPolicy = bucket.defaultPolicy();
+    return bucket.match(key, hashes, matches);
+}
+
 void InMemoryStorageBackend::insertPolicy(const PolicyBucketId &bucketId, PolicyPtr policy) {
     try {
         auto &bucket = buckets().at(bucketId);
         bucket.insertPolicy(policy);
+        m_wal.recordInsertPolicy(bucketId, *policy);
     } catch (const std::out_of_range &) {
         throw BucketNotExistsException(bucketId);
     }
@@ -139,6 +257,7 @@ void InMemoryStorageBackend::createBucket(const PolicyBucketId &bucketId,
                                           const PolicyResult &defaultPolicy) {
     PolicyBucket newBucket(bucketId, defaultPolicy);
     buckets().insert({ bucketId, newBucket });
+    m_wal.recordSetBucket(bucketId, defaultPolicy);
 }
 
 void InMemoryStorageBackend::updateBucket(const PolicyBucketId &bucketId,
@@ -146,6 +265,7 @@ void InMemoryStorageBackend::updateBucket(const PolicyBucketId &bucketId,
     try {
         auto &bucket = buckets().at(bucketId);
         bucket.setDefaultPolicy(defaultPolicy);
+        m_wal.recordSetBucket(bucketId, defaultPolicy);
     } catch (const std::out_of_range &) {
         throw BucketNotExistsException(bucketId);
     }
@@ -156,6 +276,7 @@ void InMemoryStorageBackend::deleteBucket(const PolicyBucketId &bucketId) {
     if (bucketErased == 0) {
         throw BucketNotExistsException(bucketId);
     }
+    m_wal.recordDeleteBucket(bucketId);
 }
 
 bool InMemoryStorageBackend::hasBucket(const PolicyBucketId &bucketId) {
@@ -167,27 +288,18 @@ void InMemoryStorageBackend::deletePolicy(const PolicyBucketId &bucketId, const
         // TODO: Move the erase code to PolicyCollection maybe?
         auto &bucket = buckets().at(bucketId);
         bucket.deletePolicy(key);
+        m_wal.recordDeletePolicy(bucketId, key);
     } catch (const std::out_of_range &) {
         throw BucketNotExistsException(bucketId);
     }
 }
 
 void InMemoryStorageBackend::deleteLinking(const PolicyBucketId &bucketId) {
-    auto bucketIdMatches = [&bucketId] (PolicyPtr policy) -> bool {
-        auto policyResult = policy->result();
-
-        // Check bucket id only if policy is a bucket policy
-        // TODO: Maybe move the test to PolicyResult
-        if (policyResult.policyType() == PredefinedPolicyType::BUCKET) {
-            return policyResult.metadata() == bucketId;
-        }
-        return false;
-    };
-
+    // Every bucket indexes its links, so only policies linking to bucketId are visited
     for (auto &bucketIter : buckets()) {
-        auto &bucket = bucketIter.second;
-        bucket.deletePolicy(bucketIdMatches);
+        bucketIter.second.deleteLinking(bucketId);
     }
+    m_wal.recordDeleteLinking(bucketId);
 }
 
 PolicyBucket::Policies InMemoryStorageBackend::listPolicies(const PolicyBucketId &bucketId,
@@ -202,6 +314,8 @@ PolicyBucket::Policies InMemoryStorageBackend::listPolicies(const PolicyBucketId
 
 void InMemoryStorageBackend::erasePolicies(const PolicyBucketId &bucketId, bool recursive,
                                            const PolicyKey &filter) {
+    // Recorded upfront, so replay repeats also partial erase interrupted by missing bucket
+    m_wal.recordErasePolicies(bucketId, recursive, filter);
     PolicyBucket::BucketIds bucketIds = {bucketId};
 
     while (!bucketIds.empty()) {
@@ -214,16 +328,45 @@ void InMemoryStorageBackend::erasePolicies(const PolicyBucketId &bucketId, bool
                 auto subBuckets = policyBucket.getSubBuckets();
                 bucketIds.insert(subBuckets.begin(), subBuckets.end());
             }
-            policyBucket.deletePolicy([&filter] (PolicyPtr policy) -> bool {
-                 return policy->key().matchFilter(filter);
-            });
+            policyBucket.erasePolicies(filter);
         } catch (const std::out_of_range &) {
             throw BucketNotExistsException(bucketId);
         }
     }
 }
 
-void InMemoryStorageBackend::dumpDatabase(const std::shared_ptr<std::ofstream> &chsStream) {
+PolicyBucket::BucketIds InMemoryStorageBackend::backupUnmodifiedBuckets(
+        std::ofstream &chsStream) {
+    PolicyBucket::BucketIds modifiedIds;
+
+    for (const auto &bucketIter : buckets()) {
+        const auto &bucketId = bucketIter.first;
+        auto filename = PathConfig::StoragePath::bucketFilenamePrefix + bucketId;
+        std::string checksum;
+        if (m_format == DatabaseFormat::TEXT) {
+            checksum = m_checksum.checksum(filename);
+            if (checksum.empty()) {
+                modifiedIds.insert(bucketId);
+                continue;
+            }
+        }
+
+        if (bucketIter.second.dirty() || !m_integrity.linkBackupBucket(bucketId)) {
+            modifiedIds.insert(bucketId);
+            continue;
+        }
+
+        if (m_format == DatabaseFormat::TEXT) {
+            chsStream << filename << PathConfig::StoragePath::fieldSeparator << checksum
+                      << PathConfig::StoragePath::recordSeparator;
+        }
+    }
+
+    return modifiedIds;
+}
+
+void InMemoryStorageBackend::dumpDatabase(const std::shared_ptr<std::ofstream> &chsStream,
+                                          const PolicyBucket::BucketIds &modifiedIds) {
     auto indexStream = std::make_shared<ChecksumStream>(PathConfig::StoragePath::indexFilename,
             chsStream);
     std::string indexFilename = m_dbPath + PathConfig::StoragePath::indexFilename;
@@ -231,8 +374,38 @@ void InMemoryStorageBackend::dumpDatabase(const std::shared_ptr<std::ofstream> &
             indexFilename + PathConfig::StoragePath::backupFilenameSuffix);
 
     StorageSerializer<ChecksumStream> storageSerializer(indexStream);
-    storageSerializer.dump(buckets(), std::bind(&InMemoryStorageBackend::bucketDumpStreamOpener,
-                           this, std::placeholders::_1, chsStream));
+    storageSerializer.dumpIndex(buckets());
+
+    for (const auto &bucketId : modifiedIds) {
+        bucketDumpStreamOpener(bucketId, chsStream)->dump(buckets().at(bucketId));
+    }
+}
+
+void InMemoryStorageBackend::dumpBinaryDatabase(const PolicyBucket::BucketIds &modifiedIds) {
+    const auto &suffix = PathConfig::StoragePath::backupFilenameSuffix;
+    BinarySerializer::dumpIndex(m_dbPath + PathConfig::StoragePath::indexFilename + suffix,
+                                buckets());
+
+    for (const auto &bucketId : modifiedIds) {
+        BinarySerializer::dumpBucket(m_dbPath + PathConfig::StoragePath::bucketFilenamePrefix +
+                                     bucketId + suffix, buckets().at(bucketId));
+    }
+}
+
+void InMemoryStorageBackend::loadBinaryDatabase(const std::string &indexFilename,
+                                                const std::string &bucketSuffix) {
+    BinaryDeserializer(indexFilename).initBuckets(buckets());
+
+    for (auto &bucketIter : buckets()) {
+        const auto &bucketId = bucketIter.first;
+        std::string bucketFilename = m_dbPath + PathConfig::StoragePath::bucketFilenamePrefix +
+                                     bucketId + bucketSuffix;
+        try {
+            BinaryDeserializer(bucketFilename).loadPolicies(bucketIter.second);
+        } catch (const FileNotFoundException &) {
+            throw BucketDeserializationException(bucketId);
+        }
+    }
 }
 
 void InMemoryStorageBackend::openFileStream(std::ifstream &stream, const std::string &filename,
@@ -248,14 +421,27 @@ void InMemoryStorageBackend::openFileStream(std::ifstream &stream, const std::st
     m_checksum.compare(stream, filename, isBackupValid);
 }
 
+std::shared_ptr<ChecksumInputStream> InMemoryStorageBackend::openChecksumStream(
+        const std::string &filename, bool isBackupValid) const {
+    auto stream = std::make_shared<ChecksumInputStream>(filename,
+                                              m_checksum.needsContents(filename, isBackupValid));
+    if (!stream->is_open()) {
+        throw FileNotFoundException(filename);
+    }
+    return stream;
+}
+
 std::shared_ptr<BucketDeserializer> InMemoryStorageBackend::bucketStreamOpener(
         const PolicyBucketId &bucketId, const std::string &filenameSuffix, bool isBackupValid) {
     std::string bucketFilename = m_dbPath + PathConfig::StoragePath::bucketFilenamePrefix +
             bucketId + filenameSuffix;
-    auto bucketStream = std::make_shared<std::ifstream>();
+    // Called concurrently for different buckets; file is verified while it is parsed
     try {
-        openFileStream(*bucketStream, bucketFilename, isBackupValid);
-        return std::make_shared<BucketDeserializer>(bucketStream);
+        auto bucketStream = openChecksumStream(bucketFilename, isBackupValid);
+        auto verifier = [this, bucketStream, bucketFilename, isBackupValid] () -> void {
+            m_checksum.verify(*bucketStream, bucketFilename, isBackupValid);
+        };
+        return std::make_shared<BucketDeserializer>(bucketStream, verifier);
     } catch (const FileNotFoundException &) {
         return nullptr;
     } catch (const std::bad_alloc &) {
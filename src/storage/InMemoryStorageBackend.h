@@ -23,6 +23,7 @@
 #ifndef SRC_STORAGE_INMEMORYSTORAGEBACKEND_H_
 #define SRC_STORAGE_INMEMORYSTORAGEBACKEND_H_
 
+#include <cstddef>
 #include <fstream>
 #include <memory>
 #include <string>
@@ -32,29 +33,47 @@
 #include <types/PolicyBucket.h>
 #include <types/PolicyBucketId.h>
 #include <types/PolicyKey.h>
+#include <types/PolicyKeyHelpers.h>
 #include <types/PolicyResult.h>
 
 #include <storage/BucketDeserializer.h>
+#include <storage/ChecksumInputStream.h>
 #include <storage/Buckets.h>
 #include <storage/ChecksumStream.h>
 #include <storage/ChecksumValidator.h>
 #include <storage/Integrity.h>
 #include <storage/StorageBackend.h>
 #include <storage/StorageSerializer.h>
+#include <storage/StorageSnapshot.h>
+#include <storage/WriteAheadLog.h>
 
 namespace Cynara {
 
 class InMemoryStorageBackend : public StorageBackend {
 public:
+    enum class DatabaseFormat {
+        TEXT,
+        BINARY
+    };
+
     InMemoryStorageBackend() = delete;
     InMemoryStorageBackend(const std::string &path);
     virtual ~InMemoryStorageBackend() {};
 
     virtual void load(void);
     virtual void save(void);
+    virtual void commit(void);
+    virtual void rollback(void);
+
+    virtual std::size_t journalSize(void) const {
+        return m_wal.size();
+    }
 
     virtual PolicyBucket searchDefaultBucket(const PolicyKey &key);
     virtual PolicyBucket searchBucket(const PolicyBucketId &bucketId, const PolicyKey &key);
+    virtual std::size_t matchBucket(const PolicyBucketId &bucketId, const PolicyKey &key,
+                                    const PolicyKeyHashes &hashes, PolicyResult &defaultPolicy,
+                                    PolicyBucket::Matches &matches);
     virtual void insertPolicy(const PolicyBucketId &bucketId, PolicyPtr policy);
     virtual void createBucket(const PolicyBucketId &bucketId, const PolicyResult &defaultPolicy);
     virtual void updateBucket(const PolicyBucketId &bucketId, const PolicyResult &defaultPolicy);
@@ -67,9 +86,33 @@ public:
     virtual void erasePolicies(const PolicyBucketId &bucketId, bool recursive,
                                const PolicyKey &filter);
 
+    virtual const Buckets *inMemoryBuckets(void) const {
+        return &buckets();
+    }
+
+    virtual StorageSnapshotPtr snapshot(void) const;
+    virtual void publishSnapshot(void);
+
+    // Format of loaded database; save() writes database in the same format
+    // Changing format makes all buckets dirty, so next save() rewrites whole database
+    DatabaseFormat format(void) const {
+        return m_format;
+    }
+
+    void setFormat(DatabaseFormat format);
+
 protected:
-    void dumpDatabase(const std::shared_ptr<std::ofstream> &chsStream);
+    PolicyBucket::BucketIds backupUnmodifiedBuckets(std::ofstream &chsStream);
+    void dumpDatabase(const std::shared_ptr<std::ofstream> &chsStream,
+                      const PolicyBucket::BucketIds &modifiedIds);
+    void dumpBinaryDatabase(const PolicyBucket::BucketIds &modifiedIds);
+    void loadDatabase(void);
+    // Replays committed frames of log, returns number of them
+    std::size_t replayLog(void);
+    void loadBinaryDatabase(const std::string &indexFilename, const std::string &bucketSuffix);
     void openFileStream(std::ifstream &stream, const std::string &filename, bool isBackupValid);
+    std::shared_ptr<ChecksumInputStream> openChecksumStream(const std::string &filename,
+                                                            bool isBackupValid) const;
     std::shared_ptr<BucketDeserializer> bucketStreamOpener(const PolicyBucketId &bucketId,
                                                            const std::string &fileNameSuffix,
                                                            bool isBackupValid);
@@ -86,6 +129,9 @@ private:
     Buckets m_buckets;
     ChecksumValidator m_checksum;
     Integrity m_integrity;
+    DatabaseFormat m_format;
+    WriteAheadLog m_wal;
+    StorageSnapshotPtr m_snapshot; // accessed atomically
 
 protected:
     virtual Buckets &buckets(void) {
@@ -65,14 +65,17 @@ void Integrity::createBackupGuard(void) const {
 }
 
 void Integrity::syncDatabase(const Buckets &buckets, bool syncBackup) {
+    syncDatabase(bucketIds(buckets), syncBackup);
+}
+
+void Integrity::syncDatabase(const PolicyBucket::BucketIds &bucketIds, bool syncBackup) {
     std::string suffix = "";
 
     if (syncBackup) {
         suffix += StorageConfig::backupFilenameSuffix;
     }
 
-    for (const auto &bucketIter : buckets) {
-        const auto &bucketId = bucketIter.first;
+    for (const auto &bucketId : bucketIds) {
         const auto &bucketFilename = m_dbPath + StorageConfig::bucketFilenamePrefix +
                 bucketId + suffix;
 
@@ -85,8 +88,14 @@ void Integrity::syncDatabase(const Buckets &buckets, bool syncBackup) {
 }
 
 void Integrity::revalidatePrimaryDatabase(const Buckets &buckets) {
-    createPrimaryHardLinks(buckets);
-    syncDatabase(buckets, false);
+    revalidatePrimaryDatabase(buckets, bucketIds(buckets));
+}
+
+void Integrity::revalidatePrimaryDatabase(const Buckets &buckets,
+                                          const PolicyBucket::BucketIds &modifiedIds) {
+    // Backups of unmodified buckets are links to primary files, so they are already in place
+    createPrimaryHardLinks(modifiedIds);
+    syncDatabase(modifiedIds, false);
 
     deleteHardLink(m_dbPath + StorageConfig::guardFilename);
     syncDirectory(m_dbPath);
@@ -94,6 +103,21 @@ void Integrity::revalidatePrimaryDatabase(const Buckets &buckets) {
     deleteBackupHardLinks(buckets);
 }
 
+bool Integrity::linkBackupBucket(const PolicyBucketId &bucketId) {
+    const auto &bucketFilename = m_dbPath + StorageConfig::bucketFilenamePrefix + bucketId;
+    const auto &backupFilename = bucketFilename + StorageConfig::backupFilenameSuffix;
+
+    deleteHardLink(backupFilename);
+    if (link(bucketFilename.c_str(), backupFilename.c_str()) < 0) {
+        int err = errno;
+        if (err == ENOENT)
+            return false;
+        LOGE("'link' function error [%d] : <%s>", err, strerror(err));
+        throw UnexpectedErrorException(err, strerror(err));
+    }
+    return true;
+}
+
 void Integrity::deleteNonIndexedFiles(BucketPresenceTester tester) {
     DIR *dirPtr = nullptr;
     struct dirent *direntPtr;
@@ -116,7 +140,7 @@ void Integrity::deleteNonIndexedFiles(BucketPresenceTester tester) {
 
     while (errno = 0, (direntPtr = readdir(dirPtr)) != nullptr) {
         std::string filename = direntPtr->d_name;
-        //ignore all special files (working dir, parent dir, index, checksums)
+        //ignore all special files (working dir, parent dir, index, checksums, write-ahead log)
         if (isSpecialDirectory(filename) || isSpecialDatabaseEntry(filename)) {
             continue;
         }
@@ -192,9 +216,8 @@ void Integrity::syncDirectory(const std::string &dirname, mode_t mode) {
     syncElement(dirname, O_DIRECTORY, mode);
 }
 
-void Integrity::createPrimaryHardLinks(const Buckets &buckets) {
-    for (const auto &bucketIter : buckets) {
-        const auto &bucketId = bucketIter.first;
+void Integrity::createPrimaryHardLinks(const PolicyBucket::BucketIds &bucketIds) {
+    for (const auto &bucketId : bucketIds) {
         const auto &bucketFilename = m_dbPath + StorageConfig::bucketFilenamePrefix + bucketId;
 
         deleteHardLink(bucketFilename);
@@ -224,6 +247,14 @@ void Integrity::deleteBackupHardLinks(const Buckets &buckets) {
             StorageConfig::backupFilenameSuffix);
 }
 
+PolicyBucket::BucketIds Integrity::bucketIds(const Buckets &buckets) {
+    PolicyBucket::BucketIds ids;
+    for (const auto &bucketIter : buckets) {
+        ids.insert(bucketIter.first);
+    }
+    return ids;
+}
+
 void Integrity::createHardLink(const std::string &oldName, const std::string &newName) {
     int ret = link(oldName.c_str(), newName.c_str());
 
@@ -254,7 +285,8 @@ bool Integrity::isSpecialDirectory(const std::string &filename) {
 
 bool Integrity::isSpecialDatabaseEntry(const std::string &filename) {
     return PathConfig::StoragePath::indexFilename == filename ||
-           PathConfig::StoragePath::checksumFilename == filename;
+           PathConfig::StoragePath::checksumFilename == filename ||
+           PathConfig::StoragePath::walFilename == filename;
 }
 
 } /* namespace Cynara */
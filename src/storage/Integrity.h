@@ -27,6 +27,9 @@
 #include <memory>
 #include <string>
 
+#include <types/PolicyBucket.h>
+#include <types/PolicyBucketId.h>
+
 #include <storage/Buckets.h>
 
 namespace Cynara {
@@ -41,7 +44,11 @@ public:
     virtual bool backupGuardExists(void) const;
     virtual void createBackupGuard(void) const;
     virtual void syncDatabase(const Buckets &buckets, bool syncBackup);
+    virtual void syncDatabase(const PolicyBucket::BucketIds &bucketIds, bool syncBackup);
     virtual void revalidatePrimaryDatabase(const Buckets &buckets);
+    virtual void revalidatePrimaryDatabase(const Buckets &buckets,
+                                           const PolicyBucket::BucketIds &modifiedIds);
+    virtual bool linkBackupBucket(const PolicyBucketId &bucketId);
     virtual void deleteNonIndexedFiles(BucketPresenceTester tester);
 
 protected:
@@ -49,9 +56,10 @@ protected:
                             mode_t mode = S_IRUSR | S_IWUSR);
     static void syncDirectory(const std::string &dirname, mode_t mode = S_IRUSR | S_IWUSR);
 
-    void createPrimaryHardLinks(const Buckets &buckets);
+    void createPrimaryHardLinks(const PolicyBucket::BucketIds &bucketIds);
     void deleteBackupHardLinks(const Buckets &buckets);
 
+    static PolicyBucket::BucketIds bucketIds(const Buckets &buckets);
     static void createHardLink(const std::string &oldName, const std::string &newName);
     static void deleteHardLink(const std::string &filename);
 
@@ -21,20 +21,26 @@
  * @brief       This file implements policy rules storage procedures
  */
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
 #include <exceptions/BucketNotExistsException.h>
+#include <exceptions/DatabaseException.h>
 #include <exceptions/DefaultBucketDeletionException.h>
 #include <exceptions/DefaultBucketSetNoneException.h>
 #include <types/pointers.h>
 #include <types/Policy.h>
+#include <types/PolicyArena.h>
 #include <types/PolicyBucket.h>
 #include <types/PolicyBucketId.h>
 #include <types/PolicyCollection.h>
+#include <types/PolicyKeyHelpers.h>
 #include <types/PolicyResult.h>
 #include <types/PolicyType.h>
 
+#include <storage/StorageSnapshot.h>
+
 #include "Storage.h"
 
 namespace Cynara {
@@ -42,14 +48,51 @@ namespace Cynara {
 PolicyResult Storage::checkPolicy(const PolicyKey &key,
                                   const PolicyBucketId &startBucketId /*= defaultPolicyBucketId*/,
                                   bool recursive /*= true*/) {
-    auto policies = m_backend.searchBucket(startBucketId, key);
-    return minimalPolicy(policies, key, recursive);
+    bool cacheable = (recursive && startBucketId == defaultPolicyBucketId);
+    PolicyResult result;
+    if (cacheable && m_decisionCache.get(key, result))
+        return result;
+
+    // Generation is read before snapshot is pinned, so result evaluated on snapshot
+    // replaced meanwhile is not cached. Values of transient key not known when it was
+    // read might be interned by policies added since, so they are looked up again.
+    auto generation = m_decisionCache.generation();
+    if (key.isInterned()) {
+        result = evaluatePolicy(key, startBucketId, recursive, cacheable);
+        if (cacheable)
+            m_decisionCache.update(key, result, generation);
+    } else {
+        PolicyKey resolvedKey = key.resolved();
+        result = evaluatePolicy(resolvedKey, startBucketId, recursive, cacheable);
+        if (cacheable)
+            m_decisionCache.update(resolvedKey, result, generation);
+    }
+    return result;
 };
 
-PolicyResult Storage::minimalPolicy(const PolicyBucket &bucket, const PolicyKey &key,
+PolicyResult Storage::evaluatePolicy(const PolicyKey &key, const PolicyBucketId &startBucketId,
+                                     bool recursive, bool cacheable) {
+    PolicyResult result;
+    PolicyKeyHashes hashes(key);
+    auto pinned = snapshot();
+    if (pinned) {
+        if (!cacheable || !m_decisionIndex || !pinned->indexedCheck(key, hashes, result))
+            result = minimalPolicy(*pinned, startBucketId, key, hashes, recursive);
+    } else {
+        ReadLockGuard guard(m_lock);
+        result = minimalPolicy(m_backend, startBucketId, key, hashes, recursive);
+    }
+    return result;
+}
+
+template <typename BucketSource>
+PolicyResult Storage::minimalPolicy(BucketSource &source, const PolicyBucketId &bucketId,
+                                    const PolicyKey &key, const PolicyKeyHashes &hashes,
                                     bool recursive) {
     bool hasMinimal = false;
-    PolicyResult minimal = bucket.defaultPolicy();
+    PolicyResult minimal;
+    PolicyBucket::Matches matches;
+    auto count = source.matchBucket(bucketId, key, hashes, minimal, matches);
 
     auto proposeMinimal = [&minimal, &hasMinimal](const PolicyResult &candidate) {
         if (hasMinimal == false) {
@@ -60,16 +103,16 @@ PolicyResult Storage::minimalPolicy(const PolicyBucket &bucket, const PolicyKey
         hasMinimal = true;
     };
 
-    for (const auto policy : bucket) {
-        const auto &policyResult = policy->result();
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto &policyResult = matches[i]->result();
 
         switch (policyResult.policyType()) {
             case PredefinedPolicyType::DENY:
                 return policyResult; // Do not expect lower value than DENY
             case PredefinedPolicyType::BUCKET: {
                     if (recursive == true) {
-                        auto bucketResults = m_backend.searchBucket(policyResult.metadata(), key);
-                        auto minimumOfBucket = minimalPolicy(bucketResults, key, true);
+                        auto minimumOfBucket = minimalPolicy(source, policyResult.metadata(),
+                                                             key, hashes, true);
                         if (minimumOfBucket != PredefinedPolicyType::NONE) {
                             proposeMinimal(minimumOfBucket);
                         }
@@ -87,8 +130,24 @@ PolicyResult Storage::minimalPolicy(const PolicyBucket &bucket, const PolicyKey
     return minimal;
 }
 
-void Storage::insertPolicies(const std::map<PolicyBucketId, std::vector<Policy>> &policiesByBucketId) {
+template <typename Modification>
+void Storage::modify(Modification modification) {
+    WriteLockGuard guard(m_lock);
 
+    // Also partial modification interrupted by exception has to be published
+    try {
+        modification();
+    } catch (...) {
+        m_backend.publishSnapshot();
+        m_decisionCache.clear();
+        throw;
+    }
+
+    m_backend.publishSnapshot();
+    m_decisionCache.clear();
+}
+
+void Storage::insertPolicies(const std::map<PolicyBucketId, std::vector<Policy>> &policiesByBucketId) {
     auto pointedBucketExists = [this] (const Policy &policy) -> void {
         if (policy.result().policyType() == PredefinedPolicyType::BUCKET) {
             const auto &bucketId = policy.result().metadata();
@@ -98,40 +157,44 @@ void Storage::insertPolicies(const std::map<PolicyBucketId, std::vector<Policy>>
         }
     };
 
-    // TODO: Rewrite, when transactions are supported
-    // Check if all of buckets exist
-    for (const auto &group : policiesByBucketId) {
-        const auto &bucketId = group.first;
-        const auto &policies = group.second;
+    modify([&] () -> void {
+        // TODO: Rewrite, when transactions are supported
+        // Check if all of buckets exist
+        for (const auto &group : policiesByBucketId) {
+            const auto &bucketId = group.first;
+            const auto &policies = group.second;
 
-        if (m_backend.hasBucket(bucketId) == false) {
-            throw BucketNotExistsException(bucketId);
-        }
+            if (m_backend.hasBucket(bucketId) == false) {
+                throw BucketNotExistsException(bucketId);
+            }
 
-        std::for_each(policies.cbegin(), policies.cend(), pointedBucketExists);
-    }
+            std::for_each(policies.cbegin(), policies.cend(), pointedBucketExists);
+        }
 
-    // Then insert policies
-    for (const auto &group : policiesByBucketId) {
-        const PolicyBucketId &bucketId = group.first;
-        const auto &policies = group.second;
-        for (const auto &policy : policies) {
-            m_backend.insertPolicy(bucketId, std::make_shared<Policy>(policy));
+        // Then insert policies
+        for (const auto &group : policiesByBucketId) {
+            const PolicyBucketId &bucketId = group.first;
+            const auto &policies = group.second;
+            PolicyArena arena(policies.size());
+            for (const auto &policy : policies) {
+                m_backend.insertPolicy(bucketId, arena.create(policy.key(), policy.result()));
+            }
         }
-    }
+    });
 }
 
 void Storage::addOrUpdateBucket(const PolicyBucketId &bucketId,
                                 const PolicyResult &defaultBucketPolicy) {
-
     if (bucketId == defaultPolicyBucketId && defaultBucketPolicy == PredefinedPolicyType::NONE)
         throw DefaultBucketSetNoneException();
 
-    if (m_backend.hasBucket(bucketId)) {
-        m_backend.updateBucket(bucketId, defaultBucketPolicy);
-    } else {
-        m_backend.createBucket(bucketId, defaultBucketPolicy);
-    }
+    modify([&] () -> void {
+        if (m_backend.hasBucket(bucketId)) {
+            m_backend.updateBucket(bucketId, defaultBucketPolicy);
+        } else {
+            m_backend.createBucket(bucketId, defaultBucketPolicy);
+        }
+    });
 }
 
 void Storage::deleteBucket(const PolicyBucketId &bucketId) {
@@ -141,35 +204,67 @@ void Storage::deleteBucket(const PolicyBucketId &bucketId) {
         throw DefaultBucketDeletionException();
     }
 
-    m_backend.deleteLinking(bucketId);
-    m_backend.deleteBucket(bucketId);
+    modify([&] () -> void {
+        m_backend.deleteLinking(bucketId);
+        m_backend.deleteBucket(bucketId);
+    });
 }
 
 void Storage::deletePolicies(const std::map<PolicyBucketId, std::vector<PolicyKey>> &keysByBucketId) {
-    for (const auto &bucket : keysByBucketId) {
-        const PolicyBucketId &bucketId = bucket.first;
-        for (const auto &policyKey : bucket.second) {
-            m_backend.deletePolicy(bucketId, policyKey);
+    modify([&] () -> void {
+        for (const auto &bucket : keysByBucketId) {
+            const PolicyBucketId &bucketId = bucket.first;
+            for (const auto &policyKey : bucket.second) {
+                m_backend.deletePolicy(bucketId, policyKey);
+            }
         }
-    }
+    });
 }
 
 PolicyBucket::Policies Storage::listPolicies(const PolicyBucketId &bucketId,
                                              const PolicyKey &filter) const {
+    auto pinned = snapshot();
+    if (pinned)
+        return pinned->listPolicies(bucketId, filter);
+
+    ReadLockGuard guard(m_lock);
     return m_backend.listPolicies(bucketId, filter);
 }
 
 void Storage::erasePolicies(const PolicyBucketId &bucketId, bool recursive,
                             const PolicyKey &filter) {
-    return m_backend.erasePolicies(bucketId, recursive, filter);
+    modify([&] () -> void {
+        m_backend.erasePolicies(bucketId, recursive, filter);
+    });
 }
 
 void Storage::load(void) {
-    m_backend.load();
+    modify([this] () -> void {
+        m_backend.load();
+    });
 }
 
 void Storage::save(void) {
+    ReadLockGuard guard(m_lock);
     m_backend.save();
 }
 
+void Storage::commit(void) {
+    try {
+        ReadLockGuard guard(m_lock);
+        m_backend.commit();
+    } catch (const DatabaseException &) {
+        // Checks must not see modifications reported to admin as failed
+        modify([this] () -> void {
+            m_backend.rollback();
+        });
+        throw;
+    }
+}
+
+std::size_t Storage::journalSize(void) const {
+    ReadLockGuard guard(m_lock);
+    return m_backend.journalSize();
+}
+
 } // namespace Cynara
@@ -24,24 +24,46 @@
 #ifndef SRC_STORAGE_STORAGE_H_
 #define SRC_STORAGE_STORAGE_H_
 
+#include <cstddef>
 #include <map>
 #include <string>
 #include <vector>
 
+#include <lock/ReadWriteLock.h>
 #include <types/Policy.h>
 #include <types/PolicyBucket.h>
 #include <types/PolicyBucketId.h>
 #include <types/PolicyKey.h>
+#include <types/PolicyKeyHelpers.h>
 #include <types/PolicyResult.h>
 
+#include <storage/DecisionCache.h>
 #include <storage/StorageBackend.h>
+#include <storage/StorageSnapshot.h>
 
 namespace Cynara {
 
+/**
+ * Storage may be read concurrently by many threads (checkPolicy, listPolicies, save),
+ * while all modifying operations acquire exclusive access.
+ * If backend publishes snapshots, checks and listings read the latest published one
+ * without taking any lock, so they are not blocked by modifications. Every modifying
+ * operation publishes new snapshot, when it is done.
+ * Results of full checks may be kept in decision cache (disabled when cacheCapacity is 0),
+ * which is cleared by every modification.
+ * Full checks, that miss the cache, may be evaluated with decision index (if enabled)
+ * compiled on demand for every snapshot.
+ */
 class Storage
 {
 public:
-    Storage(StorageBackend &backend) : m_backend(backend) {}
+    Storage(StorageBackend &backend, std::size_t cacheCapacity = 0, bool decisionIndex = false)
+        : m_backend(backend), m_decisionCache(cacheCapacity), m_decisionIndex(decisionIndex) {}
+
+    // Pins consistent version of all buckets, nullptr if backend does not publish snapshots
+    StorageSnapshotPtr snapshot(void) const {
+        return m_backend.snapshot();
+    }
 
     PolicyResult checkPolicy(const PolicyKey &key,
                              const PolicyBucketId &startBucketId = defaultPolicyBucketId,
@@ -60,12 +82,32 @@ public:
 
     void load(void);
     void save(void);
+    // Makes modifications durable without rewriting database, save() compacts them later.
+    // When it fails, modifications are reverted and exception is rethrown.
+    void commit(void);
+    std::size_t journalSize(void) const;
+
+    const DecisionCache &decisionCache(void) const {
+        return m_decisionCache;
+    }
 
 protected:
-    PolicyResult minimalPolicy(const PolicyBucket &bucket, const PolicyKey &key, bool recursive);
+    PolicyResult evaluatePolicy(const PolicyKey &key, const PolicyBucketId &startBucketId,
+                                bool recursive, bool cacheable);
+
+    template <typename BucketSource>
+    PolicyResult minimalPolicy(BucketSource &source, const PolicyBucketId &bucketId,
+                               const PolicyKey &key, const PolicyKeyHashes &hashes,
+                               bool recursive);
+
+    template <typename Modification>
+    void modify(Modification modification);
 
 private:
     StorageBackend &m_backend; // backend strategy
+    mutable ReadWriteLock m_lock;
+    DecisionCache m_decisionCache;
+    bool m_decisionIndex;
 };
 
 } // namespace Cynara
@@ -23,14 +23,19 @@
 #ifndef SRC_STORAGE_STORAGEBACKEND_H_
 #define SRC_STORAGE_STORAGEBACKEND_H_
 
+#include <cstddef>
 #include <string>
 
 #include <types/pointers.h>
 #include <types/PolicyBucket.h>
 #include <types/PolicyKey.h>
+#include <types/PolicyKeyHelpers.h>
 #include <types/PolicyBucketId.h>
 #include <types/PolicyResult.h>
 
+#include <storage/Buckets.h>
+#include <storage/StorageSnapshot.h>
+
 namespace Cynara {
 
 class StorageBackend {
@@ -41,6 +46,16 @@ public:
     virtual PolicyBucket searchDefaultBucket(const PolicyKey &key) = 0;
     virtual PolicyBucket searchBucket(const PolicyBucketId &bucket, const PolicyKey &key) = 0;
 
+    // Same as searchBucket(), but without materializing filtered bucket.
+    // Returns number of policies put into matches.
+    virtual std::size_t matchBucket(const PolicyBucketId &bucket, const PolicyKey &key,
+                                    const PolicyKeyHashes &hashes, PolicyResult &defaultPolicy,
+                                    PolicyBucket::Matches &matches) {
+        auto filtered = searchBucket(bucket, key);
+        defaultPolicy = filtered.defaultPolicy();
+        return filtered.match(key, hashes, matches);
+    }
+
     virtual void insertPolicy(const PolicyBucketId &bucket, PolicyPtr policy) = 0;
 
     virtual void createBucket(const PolicyBucketId &bucketId,
@@ -58,6 +73,34 @@ public:
                                const PolicyKey &filter) = 0;
     virtual void load(void) = 0;
     virtual void save(void) = 0;
+
+    // Makes modifications durable; backends without journal simply save whole database.
+    // save() folds journal into database snapshot.
+    virtual void commit(void) {
+        save();
+    }
+
+    // Reverts modifications, which failed to be committed, to last durable state
+    virtual void rollback(void) {
+        load();
+    }
+
+    virtual std::size_t journalSize(void) const {
+        return 0;
+    }
+
+    // Backends keeping all buckets in memory expose them for compiling decision index
+    virtual const Buckets *inMemoryBuckets(void) const {
+        return nullptr;
+    }
+
+    // Backends keeping all buckets in memory publish immutable snapshot of them after
+    // modifications, so readers do not need to exclude writers. Others return nullptr.
+    virtual StorageSnapshotPtr snapshot(void) const {
+        return nullptr;
+    }
+
+    virtual void publishSnapshot(void) {}
 };
 
 } /* namespace Cynara */
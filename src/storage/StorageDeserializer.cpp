@@ -20,13 +20,20 @@
  * @brief       Implementation for Cynara::StorageDeserializer
  */
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <istream>
 #include <memory>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 #include <config/PathConfig.h>
 #include <exceptions/BucketDeserializationException.h>
 #include <exceptions/BucketRecordCorruptedException.h>
+#include <log/log.h>
 #include <types/PolicyType.h>
 
 #include <storage/BucketDeserializer.h>
@@ -61,23 +68,69 @@ void StorageDeserializer::initBuckets(Buckets &buckets) {
     }
 }
 
+const std::size_t StorageDeserializer::MAX_LOADING_THREADS = 4;
+
 void StorageDeserializer::loadBuckets(Buckets &buckets) {
-    for (auto &bucketIter : buckets) {
-        const auto &bucketId = bucketIter.first;
-        auto &bucket = bucketIter.second;
-
-        auto bucketDeserializer = m_bucketStreamOpener(bucketId);
-        if (bucketDeserializer != nullptr) {
-            const auto policies = bucketDeserializer->loadPolicies();
-            for (const auto policy : policies) {
-                bucket.insertPolicy(policy);
+    std::vector<Buckets::iterator> bucketList;
+    bucketList.reserve(buckets.size());
+    for (auto bucketIter = buckets.begin(); bucketIter != buckets.end(); ++bucketIter) {
+        bucketList.push_back(bucketIter);
+    }
+
+    std::size_t threadsCount = std::min<std::size_t>({ MAX_LOADING_THREADS, bucketList.size(),
+                                                      std::thread::hardware_concurrency() });
+    if (threadsCount <= 1) {
+        for (auto bucketIter : bucketList) {
+            loadBucket(bucketIter->first, bucketIter->second);
+        }
+        return;
+    }
+
+    // Every bucket is filled by exactly one thread, so buckets need no locking
+    std::vector<std::exception_ptr> errors(bucketList.size());
+    std::atomic<std::size_t> nextBucket(0);
+    auto worker = [&] () -> void {
+        std::size_t i;
+        while ((i = nextBucket++) < bucketList.size()) {
+            try {
+                loadBucket(bucketList[i]->first, bucketList[i]->second);
+            } catch (...) {
+                errors[i] = std::current_exception();
             }
-        } else {
-            throw BucketDeserializationException(bucketId);
         }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount - 1);
+    try {
+        for (std::size_t i = 1; i < threadsCount; ++i) {
+            threads.emplace_back(worker);
+        }
+    } catch (const std::system_error &ex) {
+        // Buckets not taken by started threads are loaded by this one
+        LOGW("Cannot start bucket loading thread: <%s>", ex.what());
+    }
+    worker();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // Report the same failure as sequential loading would
+    for (const auto &error : errors) {
+        if (error)
+            std::rethrow_exception(error);
     }
 }
 
+void StorageDeserializer::loadBucket(const PolicyBucketId &bucketId, PolicyBucket &bucket) {
+    auto bucketDeserializer = m_bucketStreamOpener(bucketId);
+    if (bucketDeserializer == nullptr) {
+        throw BucketDeserializationException(bucketId);
+    }
+
+    bucket.insertPolicies(bucketDeserializer->loadPolicies());
+}
+
 PolicyBucketId StorageDeserializer::parseBucketId(const std::string &line,
                                                     std::size_t &beginToken) {
     auto bucketNameEndToken = line.find(PathConfig::StoragePath::fieldSeparator, beginToken);
@@ -22,6 +22,7 @@
 #ifndef SRC_STORAGE_STORAGEDESERIALIZER_H_
 #define SRC_STORAGE_STORAGEDESERIALIZER_H_
 
+#include <cstddef>
 #include <functional>
 #include <fstream>
 #include <memory>
@@ -43,6 +44,11 @@ public:
     StorageDeserializer(std::shared_ptr<std::istream> inStream,
                         BucketStreamOpener m_bucketStreamOpener);
     void initBuckets(Buckets &buckets);
+
+    /*
+     * Buckets are loaded concurrently, so bucket stream opener must be thread safe.
+     * When several buckets fail, exception of the first one in buckets order is thrown.
+     */
     void loadBuckets(Buckets &buckets);
 
     static PolicyBucketId parseBucketId(const std::string &line, std::size_t &beginToken);
@@ -51,6 +57,10 @@ public:
                                                       std::size_t &beginToken);
 
 private:
+    static const std::size_t MAX_LOADING_THREADS;
+
+    void loadBucket(const PolicyBucketId &bucketId, PolicyBucket &bucket);
+
     std::shared_ptr<std::istream> m_inStream;
     BucketStreamOpener m_bucketStreamOpener;
 };
@@ -56,6 +56,7 @@ public:
     virtual void dump(const Buckets &buckets,
                       BucketStreamOpener streamOpener);
     virtual void dump(const PolicyBucket &bucket);
+    virtual void dumpIndex(const Buckets &buckets);
 
 protected:
     template<typename Arg1, typename... Args>
@@ -86,14 +87,9 @@ StorageSerializer<StreamType>::StorageSerializer(std::shared_ptr<StreamType> os)
 
 template<typename StreamType>
 void StorageSerializer<StreamType>::dump(const Buckets &buckets, BucketStreamOpener streamOpener) {
-    for (const auto bucketIter : buckets) {
-        const auto &bucket = bucketIter.second;
+    dumpIndex(buckets);
 
-        dumpFields(bucket.id(), bucket.defaultPolicy().policyType(),
-                   bucket.defaultPolicy().metadata());
-    }
-
-    for (const auto bucketIter : buckets) {
+    for (const auto &bucketIter : buckets) {
         const auto &bucketId = bucketIter.first;
         const auto &bucket = bucketIter.second;
         auto bucketSerializer = streamOpener(bucketId);
@@ -106,6 +102,16 @@ void StorageSerializer<StreamType>::dump(const Buckets &buckets, BucketStreamOpe
     }
 }
 
+template<typename StreamType>
+void StorageSerializer<StreamType>::dumpIndex(const Buckets &buckets) {
+    for (const auto &bucketIter : buckets) {
+        const auto &bucket = bucketIter.second;
+
+        dumpFields(bucket.id(), bucket.defaultPolicy().policyType(),
+                   bucket.defaultPolicy().metadata());
+    }
+}
+
 template<typename StreamType>
 void StorageSerializer<StreamType>::dump(const PolicyBucket &bucket) {
     for (auto it = std::begin(bucket); it != std::end(bucket); ++it) {
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/StorageSnapshot.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file contains implementation of immutable version of buckets
+ */
+
+#include <exceptions/BucketNotExistsException.h>
+
+#include "StorageSnapshot.h"
+
+namespace Cynara {
+
+StorageSnapshot::StorageSnapshot(const Buckets &buckets, const StorageSnapshot *previous)
+    : m_decisionIndex(true) {
+    m_buckets.reserve(buckets.size());
+    for (const auto &bucketIter : buckets) {
+        const auto &bucketId = bucketIter.first;
+        const auto &bucket = bucketIter.second;
+
+        BucketPtr shared = previous ? previous->sharedBucket(bucketId) : nullptr;
+        if (!shared || shared->revision() != bucket.revision())
+            shared = std::make_shared<const PolicyBucket>(bucket);
+        m_buckets.emplace(bucketId, shared);
+    }
+}
+
+const PolicyBucket *StorageSnapshot::bucket(const PolicyBucketId &bucketId) const {
+    auto it = m_buckets.find(bucketId);
+    return it != m_buckets.end() ? it->second.get() : nullptr;
+}
+
+StorageSnapshot::BucketPtr StorageSnapshot::sharedBucket(const PolicyBucketId &bucketId) const {
+    auto it = m_buckets.find(bucketId);
+    return it != m_buckets.end() ? it->second : nullptr;
+}
+
+std::size_t StorageSnapshot::matchBucket(const PolicyBucketId &bucketId, const PolicyKey &key,
+                                         const PolicyKeyHashes &hashes,
+                                         PolicyResult &defaultPolicy,
+                                         PolicyBucket::Matches &matches) const {
+    auto policyBucket = bucket(bucketId);
+    if (!policyBucket)
+        throw BucketNotExistsException(bucketId);
+
+    defaultPolicy = policyBucket->defaultPolicy();
+    return policyBucket->match(key, hashes, matches);
+}
+
+PolicyBucket::Policies StorageSnapshot::listPolicies(const PolicyBucketId &bucketId,
+                                                     const PolicyKey &filter) const {
+    auto policyBucket = bucket(bucketId);
+    if (!policyBucket)
+        throw BucketNotExistsException(bucketId);
+
+    return policyBucket->listPolicies(filter);
+}
+
+bool StorageSnapshot::indexedCheck(const PolicyKey &key, const PolicyKeyHashes &hashes,
+                                   PolicyResult &result) const {
+    return m_decisionIndex.check(*this, key, hashes, result);
+}
+
+} // namespace Cynara
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/StorageSnapshot.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines immutable version of buckets read without locks
+ */
+
+#ifndef SRC_STORAGE_STORAGESNAPSHOT_H_
+#define SRC_STORAGE_STORAGESNAPSHOT_H_
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+#include <types/PolicyBucket.h>
+#include <types/PolicyBucketId.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyKeyHelpers.h>
+#include <types/PolicyResult.h>
+
+#include <storage/Buckets.h>
+#include <storage/DecisionIndex.h>
+
+namespace Cynara {
+
+class StorageSnapshot;
+typedef std::shared_ptr<const StorageSnapshot> StorageSnapshotPtr;
+
+/**
+ * Immutable copy of all buckets published by backend after each modification.
+ * Readers pin a version by holding a pointer to it and never need storage lock,
+ * while writers prepare next version. Buckets not modified since previous version
+ * are shared with it, and copies of modified ones share policies with backend buckets,
+ * which copy them on their first modification after publishing (copy-on-write).
+ * So publishing costs no copying of policies at all.
+ * Decision index of a version is compiled on demand from buckets of that version.
+ */
+class StorageSnapshot {
+public:
+    typedef std::shared_ptr<const PolicyBucket> BucketPtr;
+
+    StorageSnapshot(const Buckets &buckets, const StorageSnapshot *previous = nullptr);
+
+    // Returns nullptr if bucket does not exist
+    const PolicyBucket *bucket(const PolicyBucketId &bucketId) const;
+    BucketPtr sharedBucket(const PolicyBucketId &bucketId) const;
+
+    std::size_t matchBucket(const PolicyBucketId &bucketId, const PolicyKey &key,
+                            const PolicyKeyHashes &hashes, PolicyResult &defaultPolicy,
+                            PolicyBucket::Matches &matches) const;
+    PolicyBucket::Policies listPolicies(const PolicyBucketId &bucketId,
+                                        const PolicyKey &filter) const;
+
+    // Recursive check starting in default bucket evaluated with decision index
+    bool indexedCheck(const PolicyKey &key, const PolicyKeyHashes &hashes,
+                      PolicyResult &result) const;
+
+    std::size_t size(void) const {
+        return m_buckets.size();
+    }
+
+private:
+    std::unordered_map<PolicyBucketId, BucketPtr> m_buckets;
+    mutable DecisionIndex m_decisionIndex;
+};
+
+} // namespace Cynara
+
+#endif /* SRC_STORAGE_STORAGESNAPSHOT_H_ */
@@ -0,0 +1,441 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/WriteAheadLog.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file implements write-ahead log of storage modifications
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <memory>
+#include <string.h>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <attributes/attributes.h>
+#include <exceptions/BinaryFileCorruptedException.h>
+#include <exceptions/BucketNotExistsException.h>
+#include <exceptions/DatabaseCorruptedException.h>
+#include <exceptions/WriteAheadLogException.h>
+#include <log/log.h>
+#include <types/PolicyType.h>
+
+#include <storage/Checksum.h>
+#include <storage/StorageBackend.h>
+
+#include "WriteAheadLog.h"
+
+namespace Cynara {
+
+namespace {
+
+struct FrameHeader {
+    uint32_t size;
+    uint32_t reserved;
+    uint64_t checksum;
+};
+
+void throwErrno(const std::string &filename, const char *function UNUSED) {
+    int err = errno;
+    LOGE("'%s' function error [%d] : <%s>", function, err, strerror(err));
+    throw WriteAheadLogException(filename, strerror(err));
+}
+
+uint64_t payloadChecksum(const char *payload, std::size_t size) {
+    Checksum::Hasher hasher;
+    hasher.update(payload, size);
+    return hasher.digest();
+}
+
+} // namespace
+
+class WriteAheadLog::Reader {
+public:
+    Reader(const std::string &filename, const char *data, std::size_t size)
+        : m_filename(filename), m_data(data), m_size(size), m_offset(0) {}
+
+    bool atEnd(void) const {
+        return m_offset == m_size;
+    }
+
+    const std::string &filename(void) const {
+        return m_filename;
+    }
+
+    uint8_t byte(void) {
+        require(1);
+        return static_cast<uint8_t>(m_data[m_offset++]);
+    }
+
+    uint32_t integer(void) {
+        require(sizeof(uint32_t));
+        uint32_t value;
+        memcpy(&value, m_data + m_offset, sizeof(value));
+        m_offset += sizeof(value);
+        return value;
+    }
+
+    std::string string(void) {
+        auto length = integer();
+        require(length);
+        std::string value(m_data + m_offset, length);
+        m_offset += length;
+        return value;
+    }
+
+private:
+    void require(std::size_t count) const {
+        if (m_size - m_offset < count)
+            throw BinaryFileCorruptedException(m_filename, "truncated record");
+    }
+
+    const std::string &m_filename;
+    const char *m_data;
+    std::size_t m_size;
+    std::size_t m_offset;
+};
+
+struct WriteAheadLog::Record {
+    Operation operation;
+    PolicyBucketId bucketId;
+    // Fields below are used only by operations, which record them
+    std::string client;
+    std::string user;
+    std::string privilege;
+    PolicyType type;
+    std::string metadata;
+    bool recursive;
+
+    PolicyKey key(void) const {
+        return PolicyKey(client, user, privilege);
+    }
+
+    PolicyResult result(void) const {
+        return PolicyResult(type, metadata);
+    }
+};
+
+WriteAheadLog::WriteAheadLog(const std::string &filename) : m_filename(filename), m_fd(-1),
+    m_size(0), m_replaying(false) {
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    if (isOpen())
+        close(m_fd);
+}
+
+void WriteAheadLog::open(void) {
+    if (isOpen())
+        return;
+
+    bool created = false;
+    m_fd = TEMP_FAILURE_RETRY(::open(m_filename.c_str(), O_RDWR | O_APPEND | O_CLOEXEC));
+    if (m_fd < 0 && errno == ENOENT) {
+        m_fd = TEMP_FAILURE_RETRY(::open(m_filename.c_str(),
+                                         O_RDWR | O_APPEND | O_CLOEXEC | O_CREAT,
+                                         S_IRUSR | S_IWUSR));
+        created = true;
+    }
+    if (m_fd < 0)
+        throwErrno(m_filename, "open");
+
+    struct stat st;
+    if (fstat(m_fd, &st) < 0)
+        throwErrno(m_filename, "fstat");
+    m_size = static_cast<std::size_t>(st.st_size);
+
+    if (created) {
+        // new directory entry must reach disk before any frame is acknowledged
+        std::unique_ptr<char, decltype(free)*> path(strdup(m_filename.c_str()), free);
+        int dirFd = TEMP_FAILURE_RETRY(::open(dirname(path.get()), O_DIRECTORY | O_RDONLY));
+        if (dirFd < 0)
+            throwErrno(m_filename, "open");
+        int ret = fsync(dirFd);
+        close(dirFd);
+        if (ret < 0)
+            throwErrno(m_filename, "fsync");
+    }
+}
+
+std::size_t WriteAheadLog::replay(StorageBackend &backend) {
+    std::string content(m_size, '\0');
+    std::size_t done = 0;
+    while (done < content.size()) {
+        ssize_t ret = TEMP_FAILURE_RETRY(pread(m_fd, &content[done], content.size() - done,
+                                               done));
+        if (ret < 0)
+            throwErrno(m_filename, "pread");
+        if (ret == 0)
+            break;
+        done += static_cast<std::size_t>(ret);
+    }
+    content.resize(done);
+
+    std::size_t offset = 0;
+    std::size_t frames = 0;
+    std::vector<Record> records;
+    m_replaying = true;
+    try {
+        while (content.size() - offset >= sizeof(FrameHeader)) {
+            FrameHeader header;
+            memcpy(&header, content.data() + offset, sizeof(header));
+            const char *payload = content.data() + offset + sizeof(header);
+            if (content.size() - offset - sizeof(header) < header.size ||
+                payloadChecksum(payload, header.size) != header.checksum)
+                break;
+
+            // Whole frame is decoded first, so it is never applied partially
+            records.clear();
+            try {
+                Reader reader(m_filename, payload, header.size);
+                while (!reader.atEnd())
+                    records.push_back(decodeRecord(reader));
+            } catch (const BinaryFileCorruptedException &ex) {
+                LOGE("Frame [%zu] of write-ahead log cannot be decoded: <%s>", frames,
+                     ex.message().c_str());
+                throw DatabaseCorruptedException();
+            }
+
+            for (const auto &record : records)
+                applyRecord(record, backend);
+
+            offset += sizeof(header) + header.size;
+            ++frames;
+        }
+    } catch (...) {
+        m_replaying = false;
+        throw;
+    }
+    m_replaying = false;
+
+    if (offset != content.size()) {
+        LOGW("Dropping [%zu] bytes of incomplete write-ahead log tail", content.size() - offset);
+        if (ftruncate(m_fd, offset) < 0)
+            throwErrno(m_filename, "ftruncate");
+        m_size = offset;
+    }
+
+    return frames;
+}
+
+WriteAheadLog::Record WriteAheadLog::decodeRecord(Reader &reader) {
+    Record record;
+    record.operation = static_cast<Operation>(reader.byte());
+    record.bucketId = reader.string();
+    record.recursive = false;
+
+    switch (record.operation) {
+        case Operation::INSERT_POLICY:
+            record.client = reader.string();
+            record.user = reader.string();
+            record.privilege = reader.string();
+            record.type = static_cast<PolicyType>(reader.integer());
+            record.metadata = reader.string();
+            break;
+        case Operation::DELETE_POLICY:
+            record.client = reader.string();
+            record.user = reader.string();
+            record.privilege = reader.string();
+            break;
+        case Operation::SET_BUCKET:
+            record.type = static_cast<PolicyType>(reader.integer());
+            record.metadata = reader.string();
+            break;
+        case Operation::DELETE_BUCKET:
+        case Operation::DELETE_LINKING:
+            break;
+        case Operation::ERASE_POLICIES:
+            record.recursive = reader.byte() != 0;
+            record.client = reader.string();
+            record.user = reader.string();
+            record.privilege = reader.string();
+            break;
+        default:
+            throw BinaryFileCorruptedException(reader.filename(), "unknown operation");
+    }
+
+    return record;
+}
+
+void WriteAheadLog::applyRecord(const Record &record, StorageBackend &backend) {
+    const auto &bucketId = record.bucketId;
+
+    // Bucket might have been removed later, so snapshot may already lack it
+    try {
+        switch (record.operation) {
+            case Operation::INSERT_POLICY:
+                backend.insertPolicy(bucketId, std::make_shared<Policy>(record.key(),
+                                     record.result()));
+                break;
+            case Operation::DELETE_POLICY:
+                backend.deletePolicy(bucketId, record.key());
+                break;
+            case Operation::SET_BUCKET:
+                if (backend.hasBucket(bucketId))
+                    backend.updateBucket(bucketId, record.result());
+                else
+                    backend.createBucket(bucketId, record.result());
+                break;
+            case Operation::DELETE_BUCKET:
+                if (backend.hasBucket(bucketId))
+                    backend.deleteBucket(bucketId);
+                break;
+            case Operation::DELETE_LINKING:
+                backend.deleteLinking(bucketId);
+                break;
+            case Operation::ERASE_POLICIES:
+                backend.erasePolicies(bucketId, record.recursive, record.key());
+                break;
+        }
+    } catch (const BucketNotExistsException &) {
+    }
+}
+
+void WriteAheadLog::recordInsertPolicy(const PolicyBucketId &bucketId, const Policy &policy) {
+    if (!recording())
+        return;
+
+    beginRecord(Operation::INSERT_POLICY);
+    appendString(bucketId);
+    appendKey(policy.key());
+    appendInteger(policy.result().policyType());
+    appendString(policy.result().metadata());
+}
+
+void WriteAheadLog::recordDeletePolicy(const PolicyBucketId &bucketId, const PolicyKey &key) {
+    if (!recording())
+        return;
+
+    beginRecord(Operation::DELETE_POLICY);
+    appendString(bucketId);
+    appendKey(key);
+}
+
+void WriteAheadLog::recordSetBucket(const PolicyBucketId &bucketId,
+                                    const PolicyResult &defaultPolicy) {
+    if (!recording())
+        return;
+
+    beginRecord(Operation::SET_BUCKET);
+    appendString(bucketId);
+    appendInteger(defaultPolicy.policyType());
+    appendString(defaultPolicy.metadata());
+}
+
+void WriteAheadLog::recordDeleteBucket(const PolicyBucketId &bucketId) {
+    if (!recording())
+        return;
+
+    beginRecord(Operation::DELETE_BUCKET);
+    appendString(bucketId);
+}
+
+void WriteAheadLog::recordDeleteLinking(const PolicyBucketId &bucketId) {
+    if (!recording())
+        return;
+
+    beginRecord(Operation::DELETE_LINKING);
+    appendString(bucketId);
+}
+
+void WriteAheadLog::recordErasePolicies(const PolicyBucketId &bucketId, bool recursive,
+                                        const PolicyKey &filter) {
+    if (!recording())
+        return;
+
+    beginRecord(Operation::ERASE_POLICIES);
+    appendString(bucketId);
+    m_pending.push_back(recursive ? 1 : 0);
+    appendKey(filter);
+}
+
+void WriteAheadLog::commit(void) {
+    if (!isOpen() || m_pending.empty())
+        return;
+
+    FrameHeader header;
+    memset(&header, 0, sizeof(header));
+    header.size = static_cast<uint32_t>(m_pending.size());
+    header.checksum = payloadChecksum(m_pending.data(), m_pending.size());
+
+    std::string frame(reinterpret_cast<const char *>(&header), sizeof(header));
+    frame.append(m_pending);
+
+    try {
+        writeAll(frame.data(), frame.size());
+        if (fdatasync(m_fd) < 0)
+            throwErrno(m_filename, "fdatasync");
+    } catch (...) {
+        // do not leave torn frame, as following frames would be unreachable during replay
+        if (ftruncate(m_fd, m_size) < 0) {
+            LOGE("Cannot truncate write-ahead log after failed commit");
+        }
+        // modifications are reverted by storage, so they are not committed with next frame
+        m_pending.clear();
+        throw;
+    }
+
+    m_size += frame.size();
+    m_pending.clear();
+}
+
+void WriteAheadLog::reset(void) {
+    m_pending.clear();
+    if (!isOpen() || m_size == 0)
+        return;
+
+    if (ftruncate(m_fd, 0) < 0)
+        throwErrno(m_filename, "ftruncate");
+    if (fdatasync(m_fd) < 0)
+        throwErrno(m_filename, "fdatasync");
+    m_size = 0;
+}
+
+void WriteAheadLog::beginRecord(Operation operation) {
+    m_pending.push_back(static_cast<char>(operation));
+}
+
+void WriteAheadLog::appendInteger(uint32_t value) {
+    m_pending.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void WriteAheadLog::appendString(const std::string &value) {
+    appendInteger(static_cast<uint32_t>(value.size()));
+    m_pending.append(value);
+}
+
+void WriteAheadLog::appendKey(const PolicyKey &key) {
+    appendString(key.client().toString());
+    appendString(key.user().toString());
+    appendString(key.privilege().toString());
+}
+
+void WriteAheadLog::writeAll(const char *data, std::size_t size) {
+    while (size > 0) {
+        ssize_t ret = TEMP_FAILURE_RETRY(write(m_fd, data, size));
+        if (ret < 0)
+            throwErrno(m_filename, "write");
+        data += ret;
+        size -= static_cast<std::size_t>(ret);
+    }
+}
+
+} /* namespace Cynara */
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        src/storage/WriteAheadLog.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines write-ahead log of storage modifications
+ */
+
+#ifndef SRC_STORAGE_WRITEAHEADLOG_H_
+#define SRC_STORAGE_WRITEAHEADLOG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <types/Policy.h>
+#include <types/PolicyBucketId.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+
+namespace Cynara {
+
+class StorageBackend;
+
+/*
+ * Log is a sequence of frames: {uint32 payload size, uint32 reserved, uint64 payload checksum,
+ * payload}. Checksum is XXH64 computed by Checksum::Hasher.
+ * Each frame is written with a single write() followed by fdatasync() and holds all
+ * modifications recorded since previous commit, so a frame is applied entirely or not at all.
+ * Records are applied with StorageBackend operations on top of last database snapshot.
+ * Frame with valid checksum, which cannot be decoded, makes replay throw
+ * DatabaseCorruptedException, as it cannot be told apart from a torn write.
+ */
+class WriteAheadLog {
+public:
+    WriteAheadLog(const std::string &filename);
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog &) = delete;
+    WriteAheadLog &operator=(const WriteAheadLog &) = delete;
+
+    // Modifications are recorded only when log is open
+    void open(void);
+    bool isOpen(void) const {
+        return m_fd >= 0;
+    }
+
+    std::size_t replay(StorageBackend &backend);
+
+    void recordInsertPolicy(const PolicyBucketId &bucketId, const Policy &policy);
+    void recordDeletePolicy(const PolicyBucketId &bucketId, const PolicyKey &key);
+    void recordSetBucket(const PolicyBucketId &bucketId, const PolicyResult &defaultPolicy);
+    void recordDeleteBucket(const PolicyBucketId &bucketId);
+    void recordDeleteLinking(const PolicyBucketId &bucketId);
+    void recordErasePolicies(const PolicyBucketId &bucketId, bool recursive,
+                             const PolicyKey &filter);
+
+    bool hasPendingRecords(void) const {
+        return !m_pending.empty();
+    }
+
+    // Pending records are dropped also when commit fails; WriteAheadLogException is thrown then
+    void commit(void);
+    void reset(void);
+
+    // Size of committed frames in bytes
+    std::size_t size(void) const {
+        return m_size;
+    }
+
+private:
+    enum class Operation : uint8_t {
+        INSERT_POLICY = 1,
+        DELETE_POLICY,
+        SET_BUCKET,
+        DELETE_BUCKET,
+        DELETE_LINKING,
+        ERASE_POLICIES,
+    };
+
+    class Reader;
+    struct Record;
+
+    bool recording(void) const {
+        return isOpen() && !m_replaying;
+    }
+
+    void beginRecord(Operation operation);
+    void appendInteger(uint32_t value);
+    void appendString(const std::string &value);
+    void appendKey(const PolicyKey &key);
+
+    static Record decodeRecord(Reader &reader);
+    static void applyRecord(const Record &record, StorageBackend &backend);
+    void writeAll(const char *data, std::size_t size);
+
+    std::string m_filename;
+    int m_fd;
+    std::size_t m_size;
+    bool m_replaying;
+    std::string m_pending;
+};
+
+} /* namespace Cynara */
+
+#endif /* SRC_STORAGE_WRITEAHEADLOG_H_ */
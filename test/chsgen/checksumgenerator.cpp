@@ -86,7 +86,7 @@ TEST_F(ChsgenCommandlineTest, recordGeneration) {
         getOutput(out, err);
 
         ASSERT_EQ(CYNARA_API_SUCCESS, ret);
-        ASSERT_THAT(out, StartsWith(file + fieldSeparator + "$1$"));
+        ASSERT_THAT(out, StartsWith(file + fieldSeparator + "$xxh64$"));
         ASSERT_TRUE(err.empty());
     }
 }
@@ -114,6 +114,34 @@ TEST_F(ChsgenCommandlineTest, suffixErasing) {
         const auto ret = chsgen.run();
         getOutput(out, err);
 
+        ASSERT_EQ(CYNARA_API_SUCCESS, ret);
+        ASSERT_THAT(out, StartsWith(file + fieldSeparator + "$xxh64$"));
+        ASSERT_TRUE(err.empty());
+    }
+}
+
+/**
+ * @brief   Verify if checksum generator returns legacy records on demand
+ * @test    Expected result:
+ * - CYNARA_API_SUCCESS returned from checksum generator
+ * - MD5-crypt record in output stream
+ * - empty error stream
+ */
+TEST_F(ChsgenCommandlineTest, legacyRecordGeneration) {
+    using ::testing::StartsWith;
+
+    std::string err;
+    std::string out;
+
+    for (const std::string &file : { "_", "buckets" }) {
+        clearOutput();
+        prepare_argv({ execName, "--legacy", Cynara::PathConfig::testsPath + "/db3/" + file });
+        SCOPED_TRACE(file);
+
+        Cynara::ChecksumGenerator chsgen(this->argc(), this->argv());
+        const auto ret = chsgen.run();
+        getOutput(out, err);
+
         ASSERT_EQ(CYNARA_API_SUCCESS, ret);
         ASSERT_THAT(out, StartsWith(file + fieldSeparator + "$1$"));
         ASSERT_TRUE(err.empty());
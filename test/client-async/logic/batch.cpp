@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/client-async/logic/batch.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of batch requests of libcynara-client-async logic
+ */
+
+#include <map>
+#include <poll.h>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <attributes/attributes.h>
+#include <cynara-client-async.h>
+#include <cynara-error.h>
+#include <logic/Logic.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+#include "../../client-common/FakeService.h"
+
+using namespace Cynara;
+using ::testing::ElementsAre;
+
+namespace {
+
+const int MAX_ROUNDS = 200;
+const int POLL_TIMEOUT_MS = 50;
+
+class ClientAsyncBatchFixture : public ::testing::Test {
+protected:
+    ClientAsyncBatchFixture() : m_fd(-1), m_status(CYNARA_STATUS_FOR_READ),
+                                m_logic(onStatus, this) {}
+
+    void SetUp(void) {
+        m_service.setResult("p1", PredefinedPolicyType::ALLOW);
+        m_service.setResult("p2", PredefinedPolicyType::DENY);
+        m_service.setResult("p3", PredefinedPolicyType::ALLOW);
+    }
+
+    static void onStatus(int oldFd UNUSED, int newFd, cynara_async_status status, void *data) {
+        auto fixture = static_cast<ClientAsyncBatchFixture *>(data);
+        fixture->m_fd = newFd;
+        fixture->m_status = status;
+    }
+
+    static void onResponse(cynara_check_id checkId, cynara_async_call_cause cause, int response,
+                           void *data) {
+        auto fixture = static_cast<ClientAsyncBatchFixture *>(data);
+        if (cause == CYNARA_CALL_CAUSE_ANSWER)
+            fixture->m_answers[checkId] = response;
+    }
+
+    void createBatch(const std::vector<std::string> &privileges) {
+        ASSERT_EQ(CYNARA_API_SUCCESS,
+                  m_logic.createBatchRequest("client", "session", "user", privileges,
+                                             m_checkIds, onResponse, this));
+        ASSERT_EQ(privileges.size(), m_checkIds.size());
+    }
+
+    // Processes socket events until every key of batch is answered
+    void processAnswers(void) {
+        for (int round = 0; round < MAX_ROUNDS && m_answers.size() < m_checkIds.size();
+             ++round) {
+            struct pollfd desc = { m_fd, POLLIN, 0 };
+            if (m_status == CYNARA_STATUS_FOR_RW)
+                desc.events |= POLLOUT;
+            poll(&desc, 1, POLL_TIMEOUT_MS);
+            ASSERT_EQ(CYNARA_API_SUCCESS, m_logic.process());
+        }
+        ASSERT_EQ(m_checkIds.size(), m_answers.size());
+    }
+
+    std::vector<int> answers(void) const {
+        std::vector<int> answers;
+        for (auto checkId : m_checkIds) {
+            auto it = m_answers.find(checkId);
+            answers.push_back(it != m_answers.end() ? it->second : CYNARA_API_UNKNOWN_ERROR);
+        }
+        return answers;
+    }
+
+    FakeService m_service;
+    int m_fd;
+    cynara_async_status m_status;
+    std::vector<cynara_check_id> m_checkIds;
+    std::map<cynara_check_id, int> m_answers;
+    Logic m_logic;
+};
+
+} // namespace anonymous
+
+/**
+ * @brief   Answers of batch are passed to callbacks with check ids of their keys
+ */
+TEST_F(ClientAsyncBatchFixture, answersMappedToCheckIds) {
+    createBatch({ "p2", "p1", "p3" });
+    processAnswers();
+
+    ASSERT_THAT(answers(), ElementsAre(CYNARA_API_ACCESS_DENIED, CYNARA_API_ACCESS_ALLOWED,
+                                       CYNARA_API_ACCESS_ALLOWED));
+    ASSERT_THAT(m_service.checkRequests(), ElementsAre("batch p2 p1 p3"));
+}
+
+/**
+ * @brief   Keys not resolved within batch are checked with regular check requests
+ */
+TEST_F(ClientAsyncBatchFixture, notResolvedSentAsChecks) {
+    m_service.setNotResolved("p1");
+    createBatch({ "p1", "p2" });
+    processAnswers();
+
+    ASSERT_THAT(answers(), ElementsAre(CYNARA_API_ACCESS_ALLOWED, CYNARA_API_ACCESS_DENIED));
+    ASSERT_THAT(m_service.checkRequests(), ElementsAre("batch p1 p2", "check p1"));
+}
+
+/**
+ * @brief   Keys of batch lost with connection are sent again as regular checks
+ * @test    Scenario:
+ * - service closes connection after receiving batch without answering it
+ * - client reconnects and sends every key of batch with its own check request
+ */
+TEST_F(ClientAsyncBatchFixture, resentAfterReconnect) {
+    m_service.dropNextBatch();
+    createBatch({ "p2", "p3" });
+    processAnswers();
+
+    ASSERT_THAT(answers(), ElementsAre(CYNARA_API_ACCESS_DENIED, CYNARA_API_ACCESS_ALLOWED));
+    ASSERT_THAT(m_service.checkRequests(), ElementsAre("batch p2 p3", "check p2", "check p3"));
+}
+
+/**
+ * @brief   Batch is answered with single checks by service not knowing batch requests
+ */
+TEST_F(ClientAsyncBatchFixture, oldServiceFallback) {
+    m_service.setBatchSupported(false);
+    m_service.setSubscriptionSupported(false);
+    createBatch({ "p1", "p2" });
+    processAnswers();
+
+    ASSERT_THAT(answers(), ElementsAre(CYNARA_API_ACCESS_ALLOWED, CYNARA_API_ACCESS_DENIED));
+    auto requests = m_service.checkRequests();
+    ASSERT_EQ(std::vector<std::string>({ "check p1", "check p2" }),
+              std::vector<std::string>(requests.end() - 2, requests.end()));
+}
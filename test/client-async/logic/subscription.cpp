@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/client-async/logic/subscription.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of cache invalidation subscription of libcynara-client-async logic
+ */
+
+#include <map>
+#include <poll.h>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <attributes/attributes.h>
+#include <cynara-client-async.h>
+#include <cynara-error.h>
+#include <logic/Logic.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+#include "../../client-common/FakeService.h"
+
+using namespace Cynara;
+using ::testing::ElementsAre;
+
+namespace {
+
+const int MAX_ROUNDS = 200;
+const int POLL_TIMEOUT_MS = 50;
+
+class ClientAsyncSubscriptionFixture : public ::testing::Test {
+protected:
+    ClientAsyncSubscriptionFixture() : m_fd(-1), m_status(CYNARA_STATUS_FOR_READ),
+                                       m_logic(onStatus, this) {}
+
+    void SetUp(void) {
+        m_service.setResult("p1", PredefinedPolicyType::ALLOW);
+        m_service.setResult("p2", PredefinedPolicyType::DENY);
+    }
+
+    static void onStatus(int oldFd UNUSED, int newFd, cynara_async_status status, void *data) {
+        auto fixture = static_cast<ClientAsyncSubscriptionFixture *>(data);
+        fixture->m_fd = newFd;
+        fixture->m_status = status;
+    }
+
+    static void onResponse(cynara_check_id checkId, cynara_async_call_cause cause, int response,
+                           void *data) {
+        auto fixture = static_cast<ClientAsyncSubscriptionFixture *>(data);
+        if (cause == CYNARA_CALL_CAUSE_ANSWER)
+            fixture->m_answers[checkId] = response;
+    }
+
+    // Sends check and processes socket events until it is answered
+    int check(const std::string &privilege) {
+        cynara_check_id checkId;
+        int ret = m_logic.createCheckRequest("client", "session", "user", privilege, checkId,
+                                             onResponse, this);
+        if (ret != CYNARA_API_SUCCESS)
+            return ret;
+        // Check ids of answered checks are reused
+        m_answers.erase(checkId);
+
+        for (int round = 0; round < MAX_ROUNDS && !m_answers.count(checkId); ++round) {
+            struct pollfd desc = { m_fd, POLLIN, 0 };
+            if (m_status == CYNARA_STATUS_FOR_RW)
+                desc.events |= POLLOUT;
+            poll(&desc, 1, POLL_TIMEOUT_MS);
+            ret = m_logic.process();
+            if (ret != CYNARA_API_SUCCESS)
+                return ret;
+        }
+        return m_answers.count(checkId) ? m_answers[checkId] : CYNARA_API_UNKNOWN_ERROR;
+    }
+
+    FakeService m_service;
+    int m_fd;
+    cynara_async_status m_status;
+    std::map<cynara_check_id, int> m_answers;
+    Logic m_logic;
+};
+
+} // namespace anonymous
+
+/**
+ * @brief   Subscription is sent again after service restarted before answering it
+ * @test    Scenario:
+ * - service closes first connection right after subscription, like when it is restarted
+ * - subscription is sent again with the check and accepted
+ * - after connection is lost later, subscription is sent on next connection too
+ */
+TEST_F(ClientAsyncSubscriptionFixture, resentAfterRestart) {
+    m_service.dropNextSubscriptions(1);
+
+    ASSERT_EQ(CYNARA_API_ACCESS_ALLOWED, check("p1"));
+    m_service.dropNextChecks(1);
+    ASSERT_EQ(CYNARA_API_ACCESS_DENIED, check("p2"));
+
+    ASSERT_THAT(m_service.requests(), ElementsAre("subscribe", "subscribe", "check p1",
+                                                  "check p2", "subscribe", "check p2"));
+}
+
+/**
+ * @brief   Client stops subscribing to service closing consecutive connections on subscription
+ * @test    Scenario:
+ * - service closes connection on every subscription, like older versions
+ * - after two connections check is sent without subscription
+ * - subscription is not sent on later connections
+ */
+TEST_F(ClientAsyncSubscriptionFixture, oldServiceFallback) {
+    m_service.setSubscriptionSupported(false);
+
+    ASSERT_EQ(CYNARA_API_ACCESS_ALLOWED, check("p1"));
+    m_service.dropNextChecks(1);
+    ASSERT_EQ(CYNARA_API_ACCESS_DENIED, check("p2"));
+
+    ASSERT_THAT(m_service.requests(), ElementsAre("subscribe", "subscribe", "check p1",
+                                                  "check p2", "check p2"));
+}
+
+/**
+ * @brief   Check is resent as long as client manages to reconnect
+ * @test    Scenario:
+ * - service closes connection on check several times in a row
+ * - check is answered eventually
+ */
+TEST_F(ClientAsyncSubscriptionFixture, reconnectsUntilAnswered) {
+    ASSERT_EQ(CYNARA_API_ACCESS_ALLOWED, check("p1"));
+    m_service.dropNextChecks(3);
+    ASSERT_EQ(CYNARA_API_ACCESS_DENIED, check("p2"));
+
+    ASSERT_THAT(m_service.checkRequests(), ElementsAre("check p1", "check p2", "check p2",
+                                                       "check p2", "check p2"));
+}
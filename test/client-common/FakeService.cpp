@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/client-common/FakeService.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file contains implementation of fake cynara service
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <attributes/attributes.h>
+#include <config/PathConfig.h>
+#include <containers/BinaryQueue.h>
+#include <cynara-error.h>
+#include <protocol/ProtocolClient.h>
+#include <request/CheckBatchRequest.h>
+#include <request/CheckRequest.h>
+#include <request/InvalidationSubscribeRequest.h>
+#include <request/RequestContext.h>
+#include <request/SimpleCheckRequest.h>
+#include <response/CheckBatchResponse.h>
+#include <response/CheckResponse.h>
+#include <response/SimpleCheckResponse.h>
+#include <types/PolicyType.h>
+
+#include "FakeService.h"
+
+namespace Cynara {
+
+namespace {
+
+const int POLL_TIMEOUT_MS = 20;
+
+bool waitForInput(int fd) {
+    struct pollfd desc = { fd, POLLIN, 0 };
+    return TEMP_FAILURE_RETRY(poll(&desc, 1, POLL_TIMEOUT_MS)) > 0;
+}
+
+} // namespace anonymous
+
+FakeService::FakeService()
+    : m_batchSupported(true), m_subscriptionSupported(true), m_dropNextBatch(false),
+      m_subscriptionsToDrop(0), m_checksToDrop(0), m_closeConnection(false), m_stop(false) {
+    const auto &path = PathConfig::SocketPath::client;
+    mkdir(PathConfig::clientPath.c_str(), 0700);
+    unlink(path.c_str());
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenFd == -1 || bind(m_listenFd, reinterpret_cast<struct sockaddr *>(&address),
+                                 sizeof(address)) == -1 || listen(m_listenFd, 5) == -1) {
+        throw std::runtime_error("Cannot listen on " + path + ": " + strerror(errno));
+    }
+    m_thread = std::thread(&FakeService::run, this);
+}
+
+FakeService::~FakeService() {
+    m_stop = true;
+    m_thread.join();
+    close(m_listenFd);
+    unlink(PathConfig::SocketPath::client.c_str());
+}
+
+void FakeService::setResult(const std::string &privilege, const PolicyResult &result) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_results[privilege] = result;
+}
+
+void FakeService::setNotResolved(const std::string &privilege) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_notResolved.insert(privilege);
+}
+
+void FakeService::setBatchSupported(bool supported) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_batchSupported = supported;
+}
+
+void FakeService::setSubscriptionSupported(bool supported) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_subscriptionSupported = supported;
+}
+
+void FakeService::dropNextBatch(void) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dropNextBatch = true;
+}
+
+void FakeService::dropNextSubscriptions(unsigned int count) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_subscriptionsToDrop = count;
+}
+
+void FakeService::dropNextChecks(unsigned int count) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_checksToDrop = count;
+}
+
+std::vector<std::string> FakeService::requests(void) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_requests;
+}
+
+std::vector<std::string> FakeService::checkRequests(void) const {
+    std::vector<std::string> checks;
+    for (const auto &request : requests()) {
+        if (request != "subscribe")
+            checks.push_back(request);
+    }
+    return checks;
+}
+
+void FakeService::execute(const RequestContext &context, const CheckBatchRequest &request) {
+    std::string description = "batch";
+    for (const auto &key : request.keys()) {
+        description += " " + key.privilege().value();
+    }
+    record(description);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_batchSupported || m_dropNextBatch) {
+        m_dropNextBatch = false;
+        m_closeConnection = true;
+        return;
+    }
+
+    CheckBatchResponse::Answers answers;
+    for (const auto &key : request.keys()) {
+        const auto &privilege = key.privilege().value();
+        if (m_notResolved.count(privilege)) {
+            answers.emplace_back(CYNARA_API_ACCESS_NOT_RESOLVED, PolicyResult());
+            continue;
+        }
+        answers.emplace_back(CYNARA_API_SUCCESS, result(privilege));
+    }
+    context.returnResponse(CheckBatchResponse(std::move(answers), request.sequenceNumber()));
+}
+
+void FakeService::execute(const RequestContext &context, const CheckRequest &request) {
+    record("check " + request.key().privilege().value());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_checksToDrop > 0) {
+        --m_checksToDrop;
+        m_closeConnection = true;
+        return;
+    }
+    context.returnResponse(CheckResponse(result(request.key().privilege().value()),
+                                         request.sequenceNumber()));
+}
+
+void FakeService::execute(const RequestContext &context UNUSED,
+                          const InvalidationSubscribeRequest &request UNUSED) {
+    record("subscribe");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_subscriptionsToDrop > 0) {
+        --m_subscriptionsToDrop;
+        m_closeConnection = true;
+        return;
+    }
+    if (!m_subscriptionSupported)
+        m_closeConnection = true;
+}
+
+void FakeService::execute(const RequestContext &context, const SimpleCheckRequest &request) {
+    record("simple " + request.key().privilege().value());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    context.returnResponse(SimpleCheckResponse(CYNARA_API_SUCCESS,
+                                               result(request.key().privilege().value()),
+                                               request.sequenceNumber()));
+}
+
+void FakeService::run(void) {
+    while (!m_stop) {
+        if (!waitForInput(m_listenFd))
+            continue;
+
+        int fd = accept(m_listenFd, nullptr, nullptr);
+        if (fd == -1)
+            continue;
+        serve(fd);
+        close(fd);
+    }
+}
+
+void FakeService::serve(int fd) {
+    auto protocol = std::make_shared<ProtocolClient>();
+    auto readQueue = std::make_shared<BinaryQueue>();
+    auto writeQueue = std::make_shared<BinaryQueue>();
+    RequestContext context(protocol, writeQueue);
+    m_closeConnection = false;
+
+    while (!m_stop) {
+        if (!waitForInput(fd))
+            continue;
+
+        char buffer[4096];
+        ssize_t size = TEMP_FAILURE_RETRY(read(fd, buffer, sizeof(buffer)));
+        if (size <= 0)
+            return;
+        readQueue->appendCopy(buffer, size);
+
+        while (protocol->dispatchRequestFromBuffer(readQueue, *this, context)) {
+            if (m_closeConnection)
+                return;
+        }
+
+        std::vector<char> responses(writeQueue->size());
+        writeQueue->flattenConsume(responses.data(), responses.size());
+        for (std::size_t sent = 0; sent < responses.size();) {
+            ssize_t written = TEMP_FAILURE_RETRY(send(fd, responses.data() + sent,
+                                                      responses.size() - sent, MSG_NOSIGNAL));
+            if (written <= 0)
+                return;
+            sent += written;
+        }
+    }
+}
+
+PolicyResult FakeService::result(const std::string &privilege) const {
+    auto resultIt = m_results.find(privilege);
+    return resultIt != m_results.end() ? resultIt->second
+                                       : PolicyResult(PredefinedPolicyType::DENY);
+}
+
+void FakeService::record(const std::string &request) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_requests.push_back(request);
+}
+
+} // namespace Cynara
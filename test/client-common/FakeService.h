@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/client-common/FakeService.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       This file defines fake cynara service answering client requests
+ */
+
+#ifndef TEST_CLIENT_COMMON_FAKESERVICE_H_
+#define TEST_CLIENT_COMMON_FAKESERVICE_H_
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <request/RequestTaker.h>
+#include <types/PolicyResult.h>
+
+namespace Cynara {
+
+/**
+ * Listens on client socket of cynara service in its own thread and answers requests
+ * of one connection at a time. Results are configured per privilege, privileges
+ * without result are denied. Received requests are recorded, e.g. "batch p1 p2".
+ */
+class FakeService : public RequestTaker {
+public:
+    FakeService();
+    virtual ~FakeService();
+
+    void setResult(const std::string &privilege, const PolicyResult &result);
+    // Batched keys of privilege are answered as needing a full check
+    void setNotResolved(const std::string &privilege);
+    // Service not knowing batch requests closes connection on them, like older versions do
+    void setBatchSupported(bool supported);
+    void setSubscriptionSupported(bool supported);
+    // Next batch request is not answered and its connection is closed
+    void dropNextBatch(void);
+    // Connections are closed on next count subscriptions, like by a restarting service
+    void dropNextSubscriptions(unsigned int count);
+    // Next count check requests are not answered and their connections are closed
+    void dropNextChecks(unsigned int count);
+
+    std::vector<std::string> requests(void) const;
+    std::vector<std::string> checkRequests(void) const;
+
+    using RequestTaker::execute;
+
+    virtual void execute(const RequestContext &context, const CheckBatchRequest &request);
+    virtual void execute(const RequestContext &context, const CheckRequest &request);
+    virtual void execute(const RequestContext &context,
+                         const InvalidationSubscribeRequest &request);
+    virtual void execute(const RequestContext &context, const SimpleCheckRequest &request);
+
+private:
+    void run(void);
+    void serve(int fd);
+    // Must be called with mutex locked
+    PolicyResult result(const std::string &privilege) const;
+    void record(const std::string &request);
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, PolicyResult> m_results;
+    std::set<std::string> m_notResolved;
+    bool m_batchSupported;
+    bool m_subscriptionSupported;
+    bool m_dropNextBatch;
+    unsigned int m_subscriptionsToDrop;
+    unsigned int m_checksToDrop;
+    std::vector<std::string> m_requests;
+
+    // Set by request handlers, when connection is to be closed without answer
+    bool m_closeConnection;
+    int m_listenFd;
+    std::atomic<bool> m_stop;
+    std::thread m_thread;
+};
+
+} // namespace Cynara
+
+#endif /* TEST_CLIENT_COMMON_FAKESERVICE_H_ */
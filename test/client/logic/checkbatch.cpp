@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/client/logic/checkbatch.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of batch checks of libcynara-client logic
+ */
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cynara-error.h>
+#include <logic/Logic.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+#include "../../client-common/FakeService.h"
+
+using namespace Cynara;
+using ::testing::ElementsAre;
+
+namespace {
+
+const std::string CLIENT = "client";
+const std::string SESSION = "session";
+const std::string USER = "user";
+
+class ClientCheckBatchFixture : public ::testing::Test {
+protected:
+    void SetUp(void) {
+        m_service.setResult("p1", PredefinedPolicyType::ALLOW);
+        m_service.setResult("p2", PredefinedPolicyType::DENY);
+        m_service.setResult("p3", PredefinedPolicyType::ALLOW);
+    }
+
+    int checkBatch(Logic &logic, const std::vector<std::string> &privileges,
+                   std::vector<int> &results) {
+        return logic.checkBatch(CLIENT, SESSION, USER, privileges, results);
+    }
+
+    FakeService m_service;
+};
+
+} // namespace anonymous
+
+/**
+ * @brief   Cached keys are not sent to service again
+ * @test    Scenario:
+ * - check batch of keys, then batch of some of them and one more
+ * - second batch request carries only the key not checked before
+ */
+TEST_F(ClientCheckBatchFixture, cacheHitsServedLocally) {
+    Logic logic;
+    std::vector<int> results;
+
+    ASSERT_EQ(CYNARA_API_SUCCESS, checkBatch(logic, { "p1", "p2" }, results));
+    ASSERT_THAT(results, ElementsAre(CYNARA_API_ACCESS_ALLOWED, CYNARA_API_ACCESS_DENIED));
+
+    ASSERT_EQ(CYNARA_API_SUCCESS, checkBatch(logic, { "p2", "p3", "p1" }, results));
+    ASSERT_THAT(results, ElementsAre(CYNARA_API_ACCESS_DENIED, CYNARA_API_ACCESS_ALLOWED,
+                                     CYNARA_API_ACCESS_ALLOWED));
+
+    ASSERT_EQ(CYNARA_API_SUCCESS, checkBatch(logic, { "p3", "p1" }, results));
+    ASSERT_THAT(results, ElementsAre(CYNARA_API_ACCESS_ALLOWED, CYNARA_API_ACCESS_ALLOWED));
+
+    ASSERT_THAT(m_service.checkRequests(), ElementsAre("batch p1 p2", "batch p3"));
+}
+
+/**
+ * @brief   Answers for sent keys are placed at positions of their privileges
+ * @test    Scenario:
+ * - one key is cached by a single check, batch has it between not cached keys
+ * - results follow order of privileges, batch carries not cached keys in their order
+ */
+TEST_F(ClientCheckBatchFixture, positionsMappedBack) {
+    Logic logic;
+    std::vector<int> results;
+
+    ASSERT_EQ(CYNARA_API_ACCESS_ALLOWED, logic.check(CLIENT, SESSION, USER, "p3"));
+    ASSERT_EQ(CYNARA_API_SUCCESS, checkBatch(logic, { "p2", "p3", "p1", "p4" }, results));
+    ASSERT_THAT(results, ElementsAre(CYNARA_API_ACCESS_DENIED, CYNARA_API_ACCESS_ALLOWED,
+                                     CYNARA_API_ACCESS_ALLOWED, CYNARA_API_ACCESS_DENIED));
+    ASSERT_THAT(m_service.checkRequests(), ElementsAre("check p3", "batch p2 p1 p4"));
+}
+
+/**
+ * @brief   Keys not resolved within batch are checked with regular check requests
+ */
+TEST_F(ClientCheckBatchFixture, notResolvedSentAsChecks) {
+    m_service.setNotResolved("p3");
+    Logic logic;
+    std::vector<int> results;
+
+    ASSERT_EQ(CYNARA_API_SUCCESS, checkBatch(logic, { "p3", "p2", "p1" }, results));
+    ASSERT_THAT(results, ElementsAre(CYNARA_API_ACCESS_ALLOWED, CYNARA_API_ACCESS_DENIED,
+                                     CYNARA_API_ACCESS_ALLOWED));
+    ASSERT_THAT(m_service.checkRequests(), ElementsAre("batch p3 p2 p1", "check p3"));
+}
+
+/**
+ * @brief   Batch falls back to single checks with service not knowing batch requests
+ * @test    Scenario:
+ * - service closes connection on batch and subscription requests, like older versions
+ * - batch is answered with single checks; next batch is not even tried
+ */
+TEST_F(ClientCheckBatchFixture, oldServiceFallback) {
+    m_service.setBatchSupported(false);
+    m_service.setSubscriptionSupported(false);
+    Logic logic;
+    std::vector<int> results;
+
+    ASSERT_EQ(CYNARA_API_SUCCESS, checkBatch(logic, { "p1", "p2" }, results));
+    ASSERT_THAT(results, ElementsAre(CYNARA_API_ACCESS_ALLOWED, CYNARA_API_ACCESS_DENIED));
+
+    ASSERT_EQ(CYNARA_API_SUCCESS, checkBatch(logic, { "p3" }, results));
+    ASSERT_THAT(results, ElementsAre(CYNARA_API_ACCESS_ALLOWED));
+
+    auto requests = m_service.checkRequests();
+    ASSERT_EQ(std::vector<std::string>({ "check p1", "check p2", "check p3" }),
+              std::vector<std::string>(requests.end() - 3, requests.end()));
+    for (auto it = requests.begin(); it != requests.end() - 3; ++it)
+        ASSERT_EQ("batch p1 p2", *it);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/client/logic/subscription.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of cache invalidation subscription of libcynara-client logic
+ */
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cynara-error.h>
+#include <logic/Logic.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+#include "../../client-common/FakeService.h"
+
+using namespace Cynara;
+using ::testing::ElementsAre;
+
+namespace {
+
+const std::string CLIENT = "client";
+const std::string SESSION = "session";
+const std::string USER = "user";
+
+class ClientSubscriptionFixture : public ::testing::Test {
+protected:
+    void SetUp(void) {
+        m_service.setResult("p1", PredefinedPolicyType::ALLOW);
+        m_service.setResult("p2", PredefinedPolicyType::DENY);
+    }
+
+    int check(Logic &logic, const std::string &privilege) {
+        return logic.check(CLIENT, SESSION, USER, privilege);
+    }
+
+    FakeService m_service;
+};
+
+} // namespace anonymous
+
+/**
+ * @brief   Subscription is sent again after service restarted before answering it
+ * @test    Scenario:
+ * - service closes first connection right after subscription, like when it is restarted
+ * - subscription is sent again with the check and accepted
+ * - after connection is lost later, subscription is sent on next connection too
+ */
+TEST_F(ClientSubscriptionFixture, resentAfterRestart) {
+    m_service.dropNextSubscriptions(1);
+    Logic logic;
+
+    ASSERT_EQ(CYNARA_API_ACCESS_ALLOWED, check(logic, "p1"));
+    m_service.dropNextChecks(1);
+    ASSERT_EQ(CYNARA_API_ACCESS_DENIED, check(logic, "p2"));
+
+    ASSERT_THAT(m_service.requests(), ElementsAre("subscribe", "subscribe", "check p1",
+                                                  "check p2", "subscribe", "check p2"));
+}
+
+/**
+ * @brief   Client stops subscribing to service closing consecutive connections on subscription
+ * @test    Scenario:
+ * - service closes connection on every subscription, like older versions
+ * - after two connections check is sent without subscription
+ * - subscription is not sent on later connections
+ */
+TEST_F(ClientSubscriptionFixture, oldServiceFallback) {
+    m_service.setSubscriptionSupported(false);
+    Logic logic;
+
+    ASSERT_EQ(CYNARA_API_ACCESS_ALLOWED, check(logic, "p1"));
+    m_service.dropNextChecks(1);
+    ASSERT_EQ(CYNARA_API_ACCESS_DENIED, check(logic, "p2"));
+
+    ASSERT_THAT(m_service.requests(), ElementsAre("subscribe", "subscribe", "check p1",
+                                                  "check p2", "check p2"));
+}
+
+/**
+ * @brief   Check is resent as long as client manages to reconnect
+ * @test    Scenario:
+ * - service closes connection on check several times in a row
+ * - check is answered eventually
+ */
+TEST_F(ClientSubscriptionFixture, reconnectsUntilAnswered) {
+    Logic logic;
+
+    ASSERT_EQ(CYNARA_API_ACCESS_ALLOWED, check(logic, "p1"));
+    m_service.dropNextChecks(3);
+    ASSERT_EQ(CYNARA_API_ACCESS_DENIED, check(logic, "p2"));
+
+    ASSERT_THAT(m_service.checkRequests(), ElementsAre("check p1", "check p2", "check p2",
+                                                       "check p2", "check p2"));
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/common/containers/binaryqueue.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests for Cynara::BinaryQueue
+ */
+
+#include <cstring>
+#include <string>
+#include <sys/uio.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <containers/BinaryQueue.h>
+
+using namespace Cynara;
+
+namespace {
+
+std::string iovecToString(const struct iovec &vector) {
+    return std::string(static_cast<const char *>(vector.iov_base), vector.iov_len);
+}
+
+} // namespace anonymous
+
+TEST(BinaryQueue, exportIovecEmpty) {
+    BinaryQueue queue;
+    struct iovec vector[4];
+
+    ASSERT_EQ(0, queue.exportIovec(vector, 4));
+}
+
+TEST(BinaryQueue, exportIovecBuckets) {
+    BinaryQueue queue;
+    queue.appendCopy("abc", 3);
+    queue.appendCopy("de", 2);
+    queue.appendCopy("fghi", 4);
+
+    struct iovec vector[4];
+    ASSERT_EQ(3, queue.exportIovec(vector, 4));
+    ASSERT_EQ("abc", iovecToString(vector[0]));
+    ASSERT_EQ("de", iovecToString(vector[1]));
+    ASSERT_EQ("fghi", iovecToString(vector[2]));
+    ASSERT_EQ(9, queue.size());
+}
+
+TEST(BinaryQueue, exportIovecLimitedVector) {
+    BinaryQueue queue;
+    queue.appendCopy("abc", 3);
+    queue.appendCopy("de", 2);
+    queue.appendCopy("fghi", 4);
+
+    struct iovec vector[2];
+    ASSERT_EQ(2, queue.exportIovec(vector, 2));
+    ASSERT_EQ("abc", iovecToString(vector[0]));
+    ASSERT_EQ("de", iovecToString(vector[1]));
+}
+
+TEST(BinaryQueue, exportIovecAfterPartialConsume) {
+    BinaryQueue queue;
+    queue.appendCopy("abc", 3);
+    queue.appendCopy("de", 2);
+
+    queue.consume(4);
+
+    struct iovec vector[4];
+    ASSERT_EQ(1, queue.exportIovec(vector, 4));
+    ASSERT_EQ("e", iovecToString(vector[0]));
+    ASSERT_EQ(1, queue.size());
+}
+
+TEST(BinaryQueue, appendExtendsLastBucket) {
+    BinaryQueue queue;
+    queue.append("abc", 3);
+    queue.append("de", 2);
+
+    struct iovec vector[4];
+    ASSERT_EQ(1, queue.exportIovec(vector, 4));
+    ASSERT_EQ("abcde", iovecToString(vector[0]));
+}
+
+TEST(BinaryQueue, appendCopyLongData) {
+    BinaryQueue queue;
+    std::string data;
+    for (int i = 0; i < 5000; ++i)
+        data.push_back(static_cast<char>('a' + i % 26));
+
+    queue.appendCopy("x", 1);
+    queue.appendCopy(data.data(), data.size());
+    queue.consume(1);
+
+    std::string flattened(data.size(), '\0');
+    queue.flattenConsume(&flattened[0], flattened.size());
+    ASSERT_EQ(data, flattened);
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(BinaryQueue, importIovec) {
+    BinaryQueue queue;
+    queue.appendCopy("abc", 3);
+
+    struct iovec vector[4];
+    size_t count = queue.importIovec(vector, 4);
+    ASSERT_EQ(4, count);
+
+    // Received data span first two imported areas
+    std::string received(vector[0].iov_len + 2, 'x');
+    memcpy(vector[0].iov_base, received.data(), vector[0].iov_len);
+    memcpy(vector[1].iov_base, received.data() + vector[0].iov_len, 2);
+    queue.commitIovec(received.size());
+
+    ASSERT_EQ(3 + received.size(), queue.size());
+    std::string flattened(queue.size(), '\0');
+    queue.flatten(&flattened[0], flattened.size());
+    ASSERT_EQ("abc" + received, flattened);
+}
+
+TEST(BinaryQueue, commitIovecNothingReceived) {
+    BinaryQueue queue;
+
+    struct iovec vector[2];
+    queue.importIovec(vector, 2);
+    queue.commitIovec(0);
+
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(0, queue.exportIovec(vector, 2));
+}
@@ -189,3 +189,24 @@ TEST(Deserialization, vectorWithOverMaxString) {
     EXPECT_THROW(Cynara::ProtocolDeserialization::deserialize(stream, vector),
                  Cynara::InvalidProtocolException);
 }
+
+TEST(Deserialization, overMaxPolicyKeyFeature) {
+    using ::testing::_;
+
+    FakeIStream stream;
+
+    EXPECT_CALL(stream, read(_, _)).WillOnce(AssignInt(CYNARA_MAX_ID_LENGTH + 1));
+    EXPECT_THROW(Cynara::ProtocolDeserialization::deserializePolicyKeyFeature(stream),
+                 Cynara::InvalidProtocolException);
+}
+
+TEST(Deserialization, policyKeyFeatureWithoutView) {
+    using ::testing::_;
+
+    FakeIStream stream;
+
+    EXPECT_CALL(stream, read(_, _)).WillOnce(AssignInt(3))
+            .WillOnce(AssignString("app"));
+    auto feature = Cynara::ProtocolDeserialization::deserializePolicyKeyFeature(stream);
+    ASSERT_EQ("app", feature.toString());
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/common/protocols/ResponseSelector.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests for typed access to responses with Cynara::ResponseSelector
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <response/CheckResponse.h>
+#include <response/InvalidateCacheResponse.h>
+#include <response/ResponseSelector.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+using namespace Cynara;
+
+TEST(ResponseSelector, castMatchingType) {
+    ResponsePtr response = std::make_shared<CheckResponse>(
+            PolicyResult(PredefinedPolicyType::ALLOW), 7);
+
+    auto checkResponse = responseCast<CheckResponse>(response);
+    ASSERT_TRUE(bool(checkResponse));
+    ASSERT_EQ(response.get(), checkResponse.get());
+    ASSERT_EQ(7, checkResponse->sequenceNumber());
+}
+
+TEST(ResponseSelector, castOtherType) {
+    ResponsePtr response = std::make_shared<InvalidateCacheResponse>(7);
+
+    ASSERT_FALSE(bool(responseCast<CheckResponse>(response)));
+    ASSERT_FALSE(bool(responseCast<CheckResponse>(ResponsePtr())));
+}
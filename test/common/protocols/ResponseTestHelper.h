@@ -31,7 +31,9 @@
 #include <containers/RawBuffer.h>
 #include <protocol/Protocol.h>
 #include <request/RequestContext.h>
+#include <attributes/attributes.h>
 #include <response/pointers.h>
+#include <response/ResponseSelector.h>
 #include <response/ResponseTaker.h>
 
 #include "CommonsTestHelper.h"
@@ -39,6 +41,27 @@
 namespace {
 namespace ResponseTestHelper {
 
+template <typename R>
+class ComparingResponseTaker : public Cynara::IgnoringResponseTaker {
+public:
+    ComparingResponseTaker(const R &expected) : m_expected(expected), m_taken(0) {}
+
+    using Cynara::IgnoringResponseTaker::execute;
+
+    virtual void execute(const Cynara::RequestContext &context UNUSED, const R &response) {
+        compare(m_expected, response);
+        ++m_taken;
+    }
+
+    int taken(void) const {
+        return m_taken;
+    }
+
+private:
+    const R &m_expected;
+    int m_taken;
+};
+
 template <typename R>
 void testResponse(std::shared_ptr<R> response, Cynara::ProtocolPtr protocol) {
     auto queue = std::make_shared<Cynara::BinaryQueue>();
@@ -51,6 +74,14 @@ void testResponse(std::shared_ptr<R> response, Cynara::ProtocolPtr protocol) {
     ASSERT_EQ(queue->size(), static_cast<size_t>(0));
 
     compare(*response, dynamic_cast<R &>(*extractedResponse));
+
+    // Response dispatched to taker must be the same
+    ComparingResponseTaker<R> taker(*response);
+    response->execute(*protocol, context);
+    ASSERT_TRUE(protocol->dispatchResponseFromBuffer(queue, taker));
+    ASSERT_EQ(queue->size(), static_cast<size_t>(0));
+    ASSERT_EQ(1, taker.taken());
+    ASSERT_FALSE(protocol->dispatchResponseFromBuffer(queue, taker));
 }
 
 void binaryTestResponse(Cynara::ResponsePtr response, Cynara::ProtocolPtr protocol) {
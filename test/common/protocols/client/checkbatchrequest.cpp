@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/common/protocols/client/checkbatchrequest.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests for Cynara::CheckBatchRequest usage in Cynara::ProtocolClient
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <protocol/ProtocolClient.h>
+#include <request/CheckBatchRequest.h>
+#include <types/PolicyKey.h>
+
+#include <RequestTestHelper.h>
+#include <TestDataCollection.h>
+
+namespace {
+
+template<>
+void compare(const Cynara::CheckBatchRequest &req1, const Cynara::CheckBatchRequest &req2) {
+    EXPECT_EQ(req1.keys(), req2.keys());
+}
+
+} /* namespace anonymous */
+
+using namespace Cynara;
+using namespace RequestTestHelper;
+using namespace TestDataCollection;
+
+/* *** compare by objects test cases *** */
+
+TEST(ProtocolClient, CheckBatchRequest01) {
+    std::vector<PolicyKey> keys = {
+        Keys::k_cup,
+    };
+
+    auto request = std::make_shared<CheckBatchRequest>(keys, SN::min);
+    auto protocol = std::make_shared<ProtocolClient>();
+    testRequest(request, protocol);
+}
+
+TEST(ProtocolClient, CheckBatchRequest02) {
+    std::vector<PolicyKey> keys = {
+        Keys::k_nun, Keys::k_cup, Keys::k_wup, Keys::k_cwp, Keys::k_cuw, Keys::k_cww,
+        Keys::k_wuw, Keys::k_wwp, Keys::k_www, Keys::k_aaa, Keys::k_wua, Keys::k_nua,
+    };
+
+    auto request = std::make_shared<CheckBatchRequest>(keys, SN::max);
+    auto protocol = std::make_shared<ProtocolClient>();
+    testRequest(request, protocol);
+}
+
+TEST(ProtocolClient, CheckBatchRequestEmpty) {
+    auto request = std::make_shared<CheckBatchRequest>(std::vector<PolicyKey>(), SN::mid);
+    auto protocol = std::make_shared<ProtocolClient>();
+    testRequest(request, protocol);
+}
+
+/* *** compare by serialized data test cases *** */
+
+TEST(ProtocolClient, CheckBatchRequestBinary01) {
+    std::vector<PolicyKey> keys = {
+        Keys::k_cup,
+    };
+
+    auto request = std::make_shared<CheckBatchRequest>(keys, SN::min);
+    auto protocol = std::make_shared<ProtocolClient>();
+    binaryTestRequest(request, protocol);
+}
+
+TEST(ProtocolClient, CheckBatchRequestBinary02) {
+    std::vector<PolicyKey> keys = {
+        Keys::k_nun, Keys::k_cup, Keys::k_wup, Keys::k_cwp, Keys::k_cuw, Keys::k_cww,
+        Keys::k_wuw, Keys::k_wwp, Keys::k_www, Keys::k_aaa, Keys::k_wua, Keys::k_nua,
+    };
+
+    auto request = std::make_shared<CheckBatchRequest>(keys, SN::max);
+    auto protocol = std::make_shared<ProtocolClient>();
+    binaryTestRequest(request, protocol);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/common/protocols/client/checkbatchresponse.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests for Cynara::CheckBatchResponse usage in Cynara::ProtocolClient
+ */
+
+#include <gtest/gtest.h>
+
+#include <cynara-error.h>
+#include <protocol/ProtocolClient.h>
+#include <response/CheckBatchResponse.h>
+
+#include <ResponseTestHelper.h>
+#include <TestDataCollection.h>
+
+namespace {
+
+template<>
+void compare(const Cynara::CheckBatchResponse &resp1, const Cynara::CheckBatchResponse &resp2) {
+    EXPECT_EQ(resp1.answers(), resp2.answers());
+}
+
+typedef Cynara::CheckBatchResponse::Answer Answer;
+
+} /* namespace anonymous */
+
+using namespace Cynara;
+using namespace ResponseTestHelper;
+using namespace TestDataCollection;
+
+/* *** compare by objects test cases *** */
+
+TEST(ProtocolClient, CheckBatchResponse01) {
+    CheckBatchResponse::Answers answers = {
+        Answer(CYNARA_API_SUCCESS, Results::allow),
+    };
+
+    auto response = std::make_shared<CheckBatchResponse>(answers, SN::min);
+    auto protocol = std::make_shared<ProtocolClient>();
+    testResponse(response, protocol);
+}
+
+TEST(ProtocolClient, CheckBatchResponse02) {
+    CheckBatchResponse::Answers answers = {
+        Answer(CYNARA_API_SUCCESS, Results::allow),
+        Answer(CYNARA_API_SUCCESS, Results::deny),
+        Answer(CYNARA_API_ACCESS_NOT_RESOLVED, Results::plugin_1),
+        Answer(CYNARA_API_SUCCESS, Results::plugin_2),
+    };
+
+    auto response = std::make_shared<CheckBatchResponse>(answers, SN::max);
+    auto protocol = std::make_shared<ProtocolClient>();
+    testResponse(response, protocol);
+}
+
+/* *** compare by serialized data test cases *** */
+
+TEST(ProtocolClient, CheckBatchResponseBinary01) {
+    CheckBatchResponse::Answers answers = {
+        Answer(CYNARA_API_SUCCESS, Results::allow),
+    };
+
+    auto response = std::make_shared<CheckBatchResponse>(answers, SN::min);
+    auto protocol = std::make_shared<ProtocolClient>();
+    binaryTestResponse(response, protocol);
+}
+
+TEST(ProtocolClient, CheckBatchResponseBinary02) {
+    CheckBatchResponse::Answers answers = {
+        Answer(CYNARA_API_SUCCESS, Results::allow),
+        Answer(CYNARA_API_SUCCESS, Results::deny),
+        Answer(CYNARA_API_ACCESS_NOT_RESOLVED, Results::plugin_1),
+        Answer(CYNARA_API_SUCCESS, Results::plugin_2),
+    };
+
+    auto response = std::make_shared<CheckBatchResponse>(answers, SN::max);
+    auto protocol = std::make_shared<ProtocolClient>();
+    binaryTestResponse(response, protocol);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/common/protocols/client/invalidatecacheresponse.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests for Cynara::InvalidateCacheResponse usage in Cynara::ProtocolClient
+ */
+
+#include <gtest/gtest.h>
+
+#include <protocol/ProtocolClient.h>
+#include <response/InvalidateCacheResponse.h>
+
+#include <ResponseTestHelper.h>
+#include <TestDataCollection.h>
+
+namespace {
+
+template<>
+void compare(const Cynara::InvalidateCacheResponse &resp1, const Cynara::InvalidateCacheResponse &resp2)
+{
+    EXPECT_EQ(resp1.sequenceNumber(), resp2.sequenceNumber());
+}
+
+} /* namespace anonymous */
+
+using namespace Cynara;
+using namespace ResponseTestHelper;
+using namespace TestDataCollection;
+
+/* *** compare by objects test cases *** */
+
+TEST(ProtocolClient, InvalidateCacheResponse01) {
+    auto resp = std::make_shared<InvalidateCacheResponse>(SN::min);
+    auto protocol = std::make_shared<ProtocolClient>();
+    testResponse(resp, protocol);
+}
+
+TEST(ProtocolClient, InvalidateCacheResponse02) {
+    auto resp = std::make_shared<InvalidateCacheResponse>(SN::max);
+    auto protocol = std::make_shared<ProtocolClient>();
+    testResponse(resp, protocol);
+}
+
+/* *** compare by serialized data test cases *** */
+
+TEST(ProtocolClient, InvalidateCacheResponseBinary01) {
+    auto resp = std::make_shared<InvalidateCacheResponse>(SN::min);
+    auto protocol = std::make_shared<ProtocolClient>();
+    binaryTestResponse(resp, protocol);
+}
+
+TEST(ProtocolClient, InvalidateCacheResponseBinary02) {
+    auto resp = std::make_shared<InvalidateCacheResponse>(SN::max);
+    auto protocol = std::make_shared<ProtocolClient>();
+    binaryTestResponse(resp, protocol);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/common/protocols/client/invalidationsubscriberequest.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests for Cynara::InvalidationSubscribeRequest usage in Cynara::ProtocolClient
+ */
+
+#include <gtest/gtest.h>
+
+#include <protocol/ProtocolClient.h>
+#include <request/InvalidationSubscribeRequest.h>
+
+#include <RequestTestHelper.h>
+#include <TestDataCollection.h>
+
+namespace {
+
+template<>
+void compare(const Cynara::InvalidationSubscribeRequest &req1, const Cynara::InvalidationSubscribeRequest &req2)
+{
+    EXPECT_EQ(req1.sequenceNumber(), req2.sequenceNumber());
+}
+
+} /* namespace anonymous */
+
+using namespace Cynara;
+using namespace RequestTestHelper;
+using namespace TestDataCollection;
+
+/* *** compare by objects test cases *** */
+
+TEST(ProtocolClient, InvalidationSubscribeRequest01) {
+    auto req = std::make_shared<InvalidationSubscribeRequest>(SN::min);
+    auto protocol = std::make_shared<ProtocolClient>();
+    testRequest(req, protocol);
+}
+
+TEST(ProtocolClient, InvalidationSubscribeRequest02) {
+    auto req = std::make_shared<InvalidationSubscribeRequest>(SN::max);
+    auto protocol = std::make_shared<ProtocolClient>();
+    testRequest(req, protocol);
+}
+
+/* *** compare by serialized data test cases *** */
+
+TEST(ProtocolClient, InvalidationSubscribeRequestBinary01) {
+    auto req = std::make_shared<InvalidationSubscribeRequest>(SN::min);
+    auto protocol = std::make_shared<ProtocolClient>();
+    binaryTestRequest(req, protocol);
+}
+
+TEST(ProtocolClient, InvalidationSubscribeRequestBinary02) {
+    auto req = std::make_shared<InvalidationSubscribeRequest>(SN::max);
+    auto protocol = std::make_shared<ProtocolClient>();
+    binaryTestRequest(req, protocol);
+}
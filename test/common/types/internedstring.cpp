@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/common/types/internedstring.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests for Cynara::InternedString
+ */
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <types/InternedString.h>
+
+using namespace Cynara;
+
+TEST(InternedString, sameValueSameEntry) {
+    InternedString s1("interned_same");
+    InternedString s2(std::string("interned_") + "same");
+
+    ASSERT_EQ(s1, s2);
+    ASSERT_EQ(s1.id(), s2.id());
+    ASSERT_EQ(&s1.value(), &s2.value());
+    ASSERT_EQ("interned_same", s1.value());
+}
+
+TEST(InternedString, differentValues) {
+    InternedString s1("interned_1");
+    InternedString s2("interned_2");
+
+    ASSERT_NE(s1, s2);
+    ASSERT_NE(s1.id(), s2.id());
+    ASSERT_EQ("interned_1", s1.value());
+    ASSERT_EQ("interned_2", s2.value());
+}
+
+TEST(InternedString, releasedWithLastReference) {
+    auto sizeBefore = InternedString::poolSize();
+
+    auto s1 = std::unique_ptr<InternedString>(new InternedString("interned_released"));
+    auto s2 = std::unique_ptr<InternedString>(new InternedString(*s1));
+    ASSERT_EQ(sizeBefore + 1, InternedString::poolSize());
+
+    s1.reset();
+    ASSERT_EQ(sizeBefore + 1, InternedString::poolSize());
+    ASSERT_EQ("interned_released", s2->value());
+
+    s2.reset();
+    ASSERT_EQ(sizeBefore, InternedString::poolSize());
+}
+
+TEST(InternedString, movedFromStaysValid) {
+    InternedString s1("interned_moved");
+    InternedString s2(std::move(s1));
+
+    ASSERT_EQ(s1, s2);
+    ASSERT_EQ("interned_moved", s1.value());
+}
+
+TEST(InternedString, lookupFindsInterned) {
+    InternedString s1("interned_looked_up");
+    auto s2 = InternedString::lookup("interned_looked_up", 18);
+
+    ASSERT_TRUE(s2.isInterned());
+    ASSERT_EQ(s1, s2);
+    ASSERT_EQ(s1.id(), s2.id());
+}
+
+TEST(InternedString, lookupDoesNotIntern) {
+    auto sizeBefore = InternedString::poolSize();
+
+    auto s1 = InternedString::lookup("interned_transient", 18);
+    auto s2 = InternedString::lookup("interned_transient", 18);
+    ASSERT_EQ(sizeBefore, InternedString::poolSize());
+    ASSERT_FALSE(s1.isInterned());
+    ASSERT_EQ(InternedString::NOT_INTERNED_ID, s1.id());
+    ASSERT_EQ("interned_transient", s1.value());
+    ASSERT_EQ(s1, s2);
+
+    InternedString s3("interned_transient");
+    ASSERT_EQ(s1, s3);
+    ASSERT_NE(s1, InternedString::lookup("interned_other", 14));
+}
+
+TEST(InternedString, concurrentInterning) {
+    const int threadsCount = 4;
+    std::vector<std::vector<InternedString>> interned(threadsCount);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threadsCount; ++t) {
+        threads.emplace_back([&interned, t] () {
+            for (int i = 0; i < 1000; ++i)
+                interned[t].push_back(InternedString("interned_" + std::to_string(i % 100)));
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    for (int t = 1; t < threadsCount; ++t) {
+        for (int i = 0; i < 1000; ++i)
+            ASSERT_EQ(interned[0][i].id(), interned[t][i].id());
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/common/types/policyarena.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests for Cynara::PolicyArena
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "types/InternedString.h"
+#include "types/Policy.h"
+#include "types/PolicyArena.h"
+#include "types/PolicyBucket.h"
+#include "types/PolicyCollection.h"
+#include "types/PolicyKey.h"
+#include "types/PolicyResult.h"
+#include "types/PolicyType.h"
+
+using namespace Cynara;
+
+/**
+ * @brief   Policies created by arena are independent of arena and of each other
+ * @test    Scenario:
+ * - create more policies than first block holds and destroy arena
+ * - policies keep their values; releasing some of them does not affect others
+ */
+TEST(PolicyArena, policiesOutliveArena) {
+    const std::size_t count = 3 * PolicyArena::MIN_BLOCK_CAPACITY;
+    PolicyCollection policies;
+    {
+        PolicyArena arena;
+        for (std::size_t i = 0; i < count; ++i) {
+            policies.push_back(arena.create(PolicyKey("c" + std::to_string(i), "u", "p"),
+                                            PolicyResult(PredefinedPolicyType::ALLOW)));
+        }
+    }
+
+    policies.erase(policies.begin(), policies.begin() + count / 2);
+    for (std::size_t i = 0; i < policies.size(); ++i) {
+        ASSERT_EQ(PolicyKey("c" + std::to_string(count / 2 + i), "u", "p"), policies[i]->key());
+        ASSERT_EQ(PredefinedPolicyType::ALLOW, policies[i]->result().policyType());
+    }
+}
+
+/**
+ * @brief   Released policy is destroyed, while other policies of its block are alive
+ * @test    Expected result:
+ * - strings of released policy are no longer interned, strings of kept one still are
+ */
+TEST(PolicyArena, releasedPolicyIsDestroyed) {
+    const std::string keptClient = "arena-kept-client";
+    const std::string releasedClient = "arena-released-client";
+    PolicyArena arena;
+    auto kept = arena.create(PolicyKey(keptClient, "u", "p"),
+                             PolicyResult(PredefinedPolicyType::ALLOW));
+    auto released = arena.create(PolicyKey(releasedClient, "u", "p"),
+                                 PolicyResult(PredefinedPolicyType::ALLOW));
+
+    released.reset();
+    ASSERT_FALSE(InternedString::lookup(releasedClient.data(), releasedClient.size()).isInterned());
+    ASSERT_TRUE(InternedString::lookup(keptClient.data(), keptClient.size()).isInterned());
+    ASSERT_EQ(keptClient, kept->key().client().value());
+}
+
+/**
+ * @brief   Bulk insert into bucket gives the same bucket as inserting policies one by one
+ */
+TEST(PolicyArena, bucketBulkInsert) {
+    PolicyArena arena(2);
+    PolicyKey key("c", "u", "p");
+    PolicyCollection policies = {
+        arena.create(key, PolicyResult(PredefinedPolicyType::ALLOW)),
+        arena.create(PolicyKey("c", "u", "*"), PolicyResult(PredefinedPolicyType::ALLOW)),
+        arena.create(key, PolicyResult(PredefinedPolicyType::DENY)),
+    };
+
+    PolicyBucket bucket("bucket");
+    bucket.setDirty(false);
+    bucket.insertPolicies(policies);
+
+    ASSERT_TRUE(bucket.dirty());
+    ASSERT_EQ(2, bucket.size());
+    ASSERT_EQ(1, bucket.listPolicies(key).size());
+    ASSERT_EQ(PredefinedPolicyType::DENY, bucket.listPolicies(key).at(0).result().policyType());
+}
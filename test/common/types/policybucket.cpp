@@ -21,6 +21,9 @@
  */
 
 #include <algorithm>
+#include <cstdlib>
+#include <set>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -31,6 +34,7 @@
 #include "types/PolicyBucket.h"
 #include "types/PolicyCollection.h"
 #include "types/PolicyKey.h"
+#include "types/PolicyKeyHelpers.h"
 
 #include "../../helpers.h"
 
@@ -152,6 +156,31 @@ TEST_F(PolicyBucketFixture, filtered_wildcard_none) {
     ASSERT_THAT(filtered, IsEmpty());
 }
 
+TEST_F(PolicyBucketFixture, match_wildcard) {
+    using ::testing::UnorderedElementsAreArray;
+
+    auto policiesToStay = Helpers::pickFromCollection(wildcardPolicies, { 0, 1, 3 });
+
+    PolicyBucket bucket("match_wildcard", wildcardPolicies);
+    PolicyKey key("c1", "u1", "p2");
+    PolicyBucket::Matches matches;
+    auto count = bucket.match(key, PolicyKeyHashes(key), matches);
+
+    ASSERT_THAT(PolicyCollection(matches.begin(), matches.begin() + count),
+                UnorderedElementsAreArray(policiesToStay));
+}
+
+TEST_F(PolicyBucketFixture, match_wildcard_key) {
+    // Wildcard features of key must not produce duplicated matches
+    PolicyBucket bucket("match_wildcard_key", wildcardPolicies);
+    PolicyKey key("*", "*", "*");
+    PolicyBucket::Matches matches;
+    auto count = bucket.match(key, PolicyKeyHashes(key), matches);
+
+    ASSERT_EQ(1u, count);
+    ASSERT_EQ(wildcardPolicies.at(3), matches.at(0));
+}
+
 /**
  * @brief   Validate PolicyBucketIds during creation - passing bucket ids
  * @test    Scenario:
@@ -177,3 +206,179 @@ TEST_F(PolicyBucketFixture, bucket_id_validation_fails) {
         ASSERT_THROW(PolicyBucket(PolicyBucketId(*it)), InvalidBucketIdException);
     }
 }
+
+/**
+ * @brief   Track modifications of policies in bucket
+ * @test    Scenario:
+ * - New bucket is dirty, as it was never persisted
+ * - Changing default policy or deleting non-existent policy keeps bucket clean
+ * - Inserting or deleting policies makes bucket dirty
+ */
+TEST_F(PolicyBucketFixture, dirty_flag) {
+    PolicyBucket bucket("bucket", pkPolicies);
+    ASSERT_TRUE(bucket.dirty());
+
+    bucket.setDirty(false);
+    bucket.setDefaultPolicy(PredefinedPolicyType::ALLOW);
+    bucket.deletePolicy(otherPk);
+    bucket.deletePolicy([] (PolicyPtr) -> bool { return false; });
+    ASSERT_FALSE(bucket.dirty());
+
+    bucket.deletePolicy(pk1);
+    ASSERT_TRUE(bucket.dirty());
+
+    bucket.setDirty(false);
+    bucket.insertPolicy(Policy::simpleWithKey(pk1, PredefinedPolicyType::DENY));
+    ASSERT_TRUE(bucket.dirty());
+
+    bucket.setDirty(false);
+    bucket.deletePolicy([] (PolicyPtr) -> bool { return true; });
+    ASSERT_TRUE(bucket.dirty());
+}
+
+/**
+ * @brief   Filtered listing and erasing give the same results as full scan
+ * @test    Scenario:
+ * - fill bucket with policies combined from few values of every feature
+ * - for every filter combined from those values, "*" and any, compare listed policies
+ *   with policies matching filter and erase them from copy of bucket
+ * - deleting and replacing policies keeps indexes consistent
+ */
+TEST_F(PolicyBucketFixture, list_and_erase_filtered) {
+    using ::testing::UnorderedElementsAreArray;
+
+    const std::vector<std::string> values = { "a", "b", "*" };
+    auto any = PolicyKeyFeature::createAny();
+    std::vector<PolicyKeyFeature> filterValues = { any };
+    for (const auto &value : values)
+        filterValues.push_back(PolicyKeyFeature::create(value));
+    filterValues.push_back(PolicyKeyFeature::create("other"));
+
+    PolicyBucket bucket("bucket");
+    std::vector<Policy> all;
+    for (const auto &client : values) {
+        for (const auto &user : values) {
+            for (const auto &privilege : values) {
+                Policy policy(PolicyKey(client, user, privilege), PredefinedPolicyType::ALLOW);
+                bucket.insertPolicy(std::make_shared<Policy>(policy));
+                all.push_back(policy);
+            }
+        }
+    }
+    bucket.deletePolicy(PolicyKey("a", "a", "a"));
+    all.erase(std::find_if(all.begin(), all.end(), [] (const Policy &policy) -> bool {
+        return policy.key() == PolicyKey("a", "a", "a");
+    }));
+    bucket.insertPolicy(Policy::simpleWithKey(PolicyKey("b", "b", "b"),
+                                              PredefinedPolicyType::DENY));
+
+    for (const auto &client : filterValues) {
+        for (const auto &user : filterValues) {
+            for (const auto &privilege : filterValues) {
+                PolicyKey filter(client, user, privilege);
+                SCOPED_TRACE(filter.toString());
+
+                std::vector<PolicyKey> expected;
+                for (const auto &policy : all) {
+                    if (policy.key().matchFilter(filter))
+                        expected.push_back(policy.key());
+                }
+
+                std::vector<PolicyKey> listed;
+                for (const auto &policy : bucket.listPolicies(filter))
+                    listed.push_back(policy.key());
+                ASSERT_THAT(listed, UnorderedElementsAreArray(expected));
+
+                PolicyBucket erased(bucket);
+                ASSERT_EQ(expected.size(), erased.erasePolicies(filter));
+                ASSERT_EQ(all.size() - expected.size(), erased.size());
+                ASSERT_TRUE(erased.listPolicies(filter).empty());
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Links to other buckets are indexed
+ * @test    Scenario:
+ * - bucket contains policies linking to two buckets and a policy replaced by a link
+ * - getSubBuckets() lists linked buckets
+ * - deleteLinking() removes only policies linking to given bucket
+ */
+TEST_F(PolicyBucketFixture, delete_linking) {
+    using ::testing::ElementsAre;
+    using ::testing::UnorderedElementsAre;
+
+    PolicyBucket bucket("bucket", pkPolicies);
+    bucket.insertPolicy(Policy::bucketWithKey(pk1, "linked"));
+    bucket.insertPolicy(Policy::bucketWithKey(otherPk, "linked"));
+    auto otherLink = Policy::bucketWithKey(pk2, "other");
+    bucket.insertPolicy(otherLink);
+    ASSERT_THAT(bucket.getSubBuckets(), ElementsAre("linked", "other"));
+
+    bucket.setDirty(false);
+    ASSERT_EQ(0, bucket.deleteLinking("missing"));
+    ASSERT_FALSE(bucket.dirty());
+
+    ASSERT_EQ(2, bucket.deleteLinking("linked"));
+    ASSERT_TRUE(bucket.dirty());
+    ASSERT_THAT(bucket.getSubBuckets(), ElementsAre("other"));
+    ASSERT_THAT(bucket, UnorderedElementsAre(otherLink, pkPolicies.at(2)));
+}
+
+/**
+ * @brief   Secondary indexes stay consistent with policies
+ * @test    Scenario:
+ * - insert, replace, erase and unlink random policies, some of them linking to buckets
+ * - after every operation filtered listing and sub buckets are compared with full scan
+ */
+TEST_F(PolicyBucketFixture, random_indexes) {
+    std::srand(1);
+    PolicyBucket bucket("bucket");
+    auto scan = [&bucket] (const PolicyKey &filter) {
+        std::set<std::string> keys;
+        for (const auto &policy : bucket) {
+            if (policy->key().matchFilter(filter))
+                keys.insert(policy->key().toString());
+        }
+        return keys;
+    };
+
+    for (int i = 0; i < 2000; ++i) {
+        PolicyKey key("c" + std::to_string(std::rand() % 8), "u" + std::to_string(std::rand() % 3),
+                      "p" + std::to_string(std::rand() % 8));
+        PolicyBucketId link = "b" + std::to_string(std::rand() % 3);
+        switch (std::rand() % 5) {
+            case 0:
+            case 1:
+                bucket.insertPolicy(Policy::simpleWithKey(key, PredefinedPolicyType::ALLOW));
+                break;
+            case 2:
+                bucket.insertPolicy(Policy::bucketWithKey(key, link));
+                break;
+            case 3:
+                bucket.erasePolicies(PolicyKey(key.client(), PolicyKeyFeature::createAny(), key.privilege()));
+                break;
+            default:
+                if (std::rand() % 10 == 0)
+                    bucket.deleteLinking(link);
+                else
+                    bucket.deletePolicy(key);
+                break;
+        }
+
+        PolicyKey filter(key.client(), PolicyKeyFeature::createAny(), key.privilege());
+        std::set<std::string> listed;
+        for (const auto &policy : bucket.listPolicies(filter)) {
+            listed.insert(policy.key().toString());
+        }
+        ASSERT_EQ(scan(filter), listed);
+
+        PolicyBucket::BucketIds links;
+        for (const auto &policy : bucket) {
+            if (policy->result().policyType() == PredefinedPolicyType::BUCKET)
+                links.insert(policy->result().metadata());
+        }
+        ASSERT_EQ(links, bucket.getSubBuckets());
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/common/types/policymap.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests for Cynara::PolicyMap
+ */
+
+#include <cstdlib>
+#include <map>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "types/Policy.h"
+#include "types/PolicyKey.h"
+#include "types/PolicyMap.h"
+#include "types/PolicyType.h"
+
+using namespace Cynara;
+
+/**
+ * @brief   Policy map behaves like associative container with key equality
+ * @test    Scenario:
+ * - insert, replace and erase random policies, comparing map with std::map
+ * - erasures leave tombstones and inserts rehash table, both must keep all policies findable
+ */
+TEST(PolicyMap, randomOperations) {
+    std::srand(1);
+    PolicyMap policies;
+    std::map<std::string, PolicyPtr> reference;
+
+    for (int i = 0; i < 5000; ++i) {
+        PolicyKey key("c" + std::to_string(std::rand() % 20), "u" + std::to_string(std::rand() % 5),
+                      "p" + std::to_string(std::rand() % 20));
+        const std::string keyString = key.toString();
+
+        if (std::rand() % 3) {
+            auto policy = Policy::simpleWithKey(key, PredefinedPolicyType::ALLOW);
+            auto it = reference.find(keyString);
+            auto replaced = policies.insert(policy);
+            ASSERT_EQ(it != reference.end() ? it->second : nullptr, replaced);
+            reference[keyString] = policy;
+        } else {
+            auto it = reference.find(keyString);
+            auto erased = policies.erase(key);
+            ASSERT_EQ(it != reference.end() ? it->second : nullptr, erased);
+            if (it != reference.end())
+                reference.erase(it);
+        }
+        ASSERT_EQ(reference.size(), policies.size());
+    }
+
+    std::size_t count = 0;
+    for (const auto &policy : policies) {
+        auto it = reference.find(policy->key().toString());
+        ASSERT_NE(reference.end(), it);
+        ASSERT_EQ(it->second, policy);
+        ASSERT_EQ(policy, *policies.find(policy->key()));
+        ++count;
+    }
+    ASSERT_EQ(reference.size(), count);
+}
+
+/**
+ * @brief   Empty map does not find anything and has no elements
+ */
+TEST(PolicyMap, empty) {
+    PolicyMap policies;
+    PolicyKey key("c", "u", "p");
+
+    ASSERT_TRUE(policies.empty());
+    ASSERT_EQ(nullptr, policies.find(key));
+    ASSERT_EQ(nullptr, policies.erase(key));
+    ASSERT_TRUE(policies.begin() == policies.end());
+
+    policies.insert(Policy::simpleWithKey(key, PredefinedPolicyType::DENY));
+    policies.erase(key);
+    ASSERT_TRUE(policies.empty());
+    ASSERT_EQ(nullptr, policies.find(key));
+    ASSERT_TRUE(policies.begin() == policies.end());
+}
+
+/**
+ * @brief   Policies are kept at compact positions
+ * @test    Expected result:
+ * - inserted policy takes last position, replacing policy keeps position
+ * - last policy takes position of erased one
+ */
+TEST(PolicyMap, positions) {
+    PolicyMap policies;
+    PolicyKey key1("c1", "u", "p");
+    PolicyKey key2("c2", "u", "p");
+    PolicyKey key3("c3", "u", "p");
+
+    ASSERT_EQ(PolicyMap::npos, policies.position(key1));
+    policies.insert(Policy::simpleWithKey(key1, PredefinedPolicyType::ALLOW));
+    policies.insert(Policy::simpleWithKey(key2, PredefinedPolicyType::ALLOW));
+    policies.insert(Policy::simpleWithKey(key3, PredefinedPolicyType::ALLOW));
+    ASSERT_EQ(0, policies.position(key1));
+    ASSERT_EQ(2, policies.position(key3));
+
+    auto policy = Policy::simpleWithKey(key2, PredefinedPolicyType::DENY);
+    policies.insert(policy);
+    ASSERT_EQ(1, policies.position(key2));
+    ASSERT_EQ(policy, policies.at(1));
+
+    policies.erase(key1);
+    ASSERT_EQ(PolicyMap::npos, policies.position(key1));
+    ASSERT_EQ(0, policies.position(key3));
+    ASSERT_EQ(key3, policies.at(0)->key());
+    ASSERT_EQ(1, policies.position(key2));
+}
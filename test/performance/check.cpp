@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/performance/check.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Performance tests of check request round trip through service logic
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <attributes/attributes.h>
+#include <containers/BinaryQueue.h>
+#include <plugin/PluginManager.h>
+#include <protocol/ProtocolClient.h>
+#include <request/CheckRequest.h>
+#include <request/RequestContext.h>
+#include <request/SetPoliciesRequest.h>
+#include <storage/DecisionCache.h>
+#include <storage/InMemoryStorageBackend.h>
+#include <storage/Storage.h>
+#include <types/Policy.h>
+#include <types/PolicyBucket.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+#include <logic/Logic.h>
+#include <sockets/SocketManager.h>
+
+#include "../Benchmark.h"
+#include "../storage/databasedirfixture.h"
+
+/*
+ * Allocations are counted by replacing global operator new, which is why these tests
+ * are kept in an executable of their own
+ */
+namespace {
+
+std::atomic<bool> countAllocations(false);
+std::atomic<std::size_t> allocations(0);
+
+} // namespace anonymous
+
+void *operator new(std::size_t size) {
+    if (countAllocations)
+        ++allocations;
+
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t size UNUSED) noexcept {
+    std::free(ptr);
+}
+
+using namespace Cynara;
+
+namespace {
+
+class CheckPerformanceFixture : public DatabaseDirFixture {
+protected:
+    virtual void SetUp() {
+        DatabaseDirFixture::SetUp();
+
+        InMemoryStorageBackend initial(m_dbPath);
+        initial.createBucket(defaultPolicyBucketId, PolicyResult(PredefinedPolicyType::DENY));
+        initial.save();
+
+        // Service is set up like in Cynara::init(), with decision cache enabled
+        m_backend.reset(new InMemoryStorageBackend(m_dbPath));
+        m_storage = std::make_shared<Storage>(*m_backend, DecisionCache::CACHE_DEFAULT_CAPACITY);
+        m_logic = std::make_shared<Logic>();
+        m_logic->bindStorage(m_storage);
+        m_logic->bindSocketManager(std::make_shared<SocketManager>());
+        m_logic->bindPluginManager(std::make_shared<PluginManager>(m_dbPath + "plugins/"));
+        m_logic->loadDb();
+
+        m_protocol = std::make_shared<ProtocolClient>();
+        m_readQueue = std::make_shared<BinaryQueue>();
+        m_writeQueue = std::make_shared<BinaryQueue>();
+    }
+
+    virtual void TearDown() {
+        m_logic->unbindAll();
+        m_logic.reset();
+        m_storage.reset();
+        m_backend.reset();
+        DatabaseDirFixture::TearDown();
+    }
+
+    void setPolicy(const PolicyKey &key, PolicyType type) {
+        RequestContext context(ResponseTakerPtr(), m_writeQueue);
+        m_logic->execute(context, SetPoliciesRequest({{ defaultPolicyBucketId,
+                                                        { Policy(key, PolicyResult(type)) } }},
+                                                     {}, 1));
+    }
+
+    void fillRequests(const PolicyKey &key, unsigned int count) {
+        RequestContext context(ResponseTakerPtr(), m_readQueue);
+        for (auto i = 0u; i < count; ++i) {
+            m_protocol->execute(context, CheckRequest(key, i));
+        }
+    }
+
+    // Dispatches requests built on stack to logic, like SocketManager does without workers
+    void handleRequests(void) {
+        RequestContext context(m_protocol, m_writeQueue);
+
+        while (m_protocol->dispatchRequestFromBuffer(m_readQueue, *m_logic, context)) {
+        }
+
+        m_output.resize(m_writeQueue->size());
+        m_writeQueue->flattenConsume(m_output.data(), m_output.size());
+    }
+
+    std::unique_ptr<InMemoryStorageBackend> m_backend;
+    std::shared_ptr<Storage> m_storage;
+    std::shared_ptr<Logic> m_logic;
+    std::shared_ptr<ProtocolClient> m_protocol;
+    BinaryQueuePtr m_readQueue;
+    BinaryQueuePtr m_writeQueue;
+    std::vector<char> m_output;
+};
+
+} // namespace anonymous
+
+/**
+ * @brief   Cached check round trip through service logic does at most one allocation
+ * @test    Scenario:
+ * - set ALLOW policy for checked key
+ * - warm up decision cache, chunk pool and buffers with a round of checks
+ * - dispatch another round of checks to logic and count allocations
+ */
+TEST_F(CheckPerformanceFixture, round_trip_allocations) {
+    using std::chrono::nanoseconds;
+
+    const PolicyKey key("client", "user", "privilege");
+    const unsigned int checks = 10000;
+    setPolicy(key, PredefinedPolicyType::ALLOW);
+
+    fillRequests(key, checks);
+    handleRequests();
+    ASSERT_EQ(1u, m_storage->decisionCache().misses());
+
+    fillRequests(key, checks);
+    allocations = 0;
+    countAllocations = true;
+    auto result = Benchmark::measure<nanoseconds>([&] () {
+        handleRequests();
+    });
+    countAllocations = false;
+
+    ASSERT_EQ(0u, m_readQueue->size());
+    ASSERT_FALSE(m_output.empty());
+    ASSERT_EQ(1u, m_storage->decisionCache().misses());
+    ASSERT_LE(allocations.load(), static_cast<std::size_t>(checks));
+
+    RecordProperty("performance", std::to_string(result.count() / checks) + " [ns]");
+    RecordProperty("allocations", std::to_string(allocations.load()));
+}
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/service/logic/checkworkerpool.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of ordering of requests completed by check workers
+ */
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <attributes/attributes.h>
+#include <containers/BinaryQueue.h>
+#include <request/CancelRequest.h>
+#include <request/CheckBatchRequest.h>
+#include <request/CheckRequest.h>
+#include <request/RequestContext.h>
+#include <request/SimpleCheckRequest.h>
+#include <response/ResponseTaker.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+#include <logic/CheckLogicInterface.h>
+#include <logic/CheckWorkerPool.h>
+
+using namespace Cynara;
+
+namespace {
+
+/*
+ * Storage checks of keys with held privileges block until privilege is released.
+ * Everything done in main thread is recorded as "<what>:<sequence number>".
+ */
+class FakeCheckLogic : public CheckLogicInterface {
+public:
+    using CheckLogicInterface::execute;
+
+    void hold(const std::string &privilege) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_held.insert(privilege);
+    }
+
+    void release(const std::string &privilege) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_held.erase(privilege);
+        }
+        m_condition.notify_all();
+    }
+
+    virtual PolicyResult checkStorage(const PolicyKey &key) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto privilege = key.privilege().toString();
+        m_condition.wait(lock, [&] (void) -> bool {
+            return m_held.find(privilege) == m_held.end();
+        });
+        ++m_checked;
+        return PolicyResult(PredefinedPolicyType::ALLOW);
+    }
+
+    virtual void finishCheck(const RequestContext &context UNUSED, const CheckRequest &request,
+                             const PolicyResult &storageResult UNUSED) {
+        record("check", request.sequenceNumber());
+    }
+
+    virtual void finishSimpleCheck(const RequestContext &context UNUSED,
+                                   const SimpleCheckRequest &request,
+                                   const PolicyResult &storageResult UNUSED) {
+        record("simple", request.sequenceNumber());
+    }
+
+    virtual void finishCheckBatch(const RequestContext &context UNUSED,
+                                  const CheckBatchRequest &request,
+                                  const std::vector<PolicyResult> &storageResults) {
+        record("batch" + std::to_string(storageResults.size()), request.sequenceNumber());
+    }
+
+    virtual void execute(const RequestContext &context UNUSED, const CancelRequest &request) {
+        record("cancel", request.sequenceNumber());
+    }
+
+    virtual void contextClosed(const RequestContext &context UNUSED) {
+        record("closed", 0);
+    }
+
+    unsigned int checked(void) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_checked;
+    }
+
+    const std::vector<std::string> &calls(void) const {
+        return m_calls;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::set<std::string> m_held;
+    unsigned int m_checked = 0;
+    std::vector<std::string> m_calls;
+
+    void record(const std::string &what, ProtocolFrameSequenceNumber sequenceNumber) {
+        m_calls.push_back(what + ":" + std::to_string(sequenceNumber));
+    }
+};
+
+class CheckWorkerPoolFixture : public ::testing::Test {
+protected:
+    CheckWorkerPoolFixture()
+        : m_logic(std::make_shared<FakeCheckLogic>()), m_pool(2),
+          m_linkA(std::make_shared<BinaryQueue>()), m_linkB(std::make_shared<BinaryQueue>()) {
+        m_pool.bindLogic(m_logic);
+        m_pool.start();
+    }
+
+    ~CheckWorkerPoolFixture() {
+        m_pool.stop();
+        m_pool.unbindAll();
+    }
+
+    RequestContext context(const BinaryQueuePtr &link) {
+        return RequestContext(ResponseTakerPtr(), link);
+    }
+
+    static PolicyKey key(const std::string &privilege) {
+        return PolicyKey("client", "user", privilege);
+    }
+
+    void check(const BinaryQueuePtr &link, const std::string &privilege,
+               ProtocolFrameSequenceNumber sequenceNumber) {
+        m_pool.dispatch(std::make_shared<CheckRequest>(key(privilege), sequenceNumber),
+                        context(link));
+    }
+
+    // Handles results, which workers delivered to main thread within timeout
+    void processResults(int timeoutMs = 100) {
+        struct pollfd desc = { m_pool.notificationFd(), POLLIN, 0 };
+        poll(&desc, 1, timeoutMs);
+        m_pool.processResults();
+    }
+
+    void processUntilChecked(unsigned int checks) {
+        for (int i = 0; i < 100 && m_logic->checked() < checks; ++i)
+            processResults();
+        processResults();
+    }
+
+    void processUntilCalls(size_t calls) {
+        for (int i = 0; i < 100 && m_logic->calls().size() < calls; ++i)
+            processResults();
+    }
+
+    std::shared_ptr<FakeCheckLogic> m_logic;
+    CheckWorkerPool m_pool;
+    BinaryQueuePtr m_linkA;
+    BinaryQueuePtr m_linkB;
+};
+
+} // namespace anonymous
+
+TEST_F(CheckWorkerPoolFixture, linkFifoWithInterleavedOther) {
+    m_logic->hold("slow");
+
+    check(m_linkA, "slow", 1);
+    m_pool.dispatch(std::make_shared<CancelRequest>(2), context(m_linkA));
+    check(m_linkA, "fast", 3);
+    m_pool.dispatch(std::make_shared<SimpleCheckRequest>(key("fast"), 4), context(m_linkA));
+    m_pool.dispatch(std::make_shared<CheckBatchRequest>(
+                        std::vector<PolicyKey>{key("fast"), key("fast")}, 5),
+                    context(m_linkA));
+
+    // Requests after the held one are evaluated, but cannot be finished yet
+    processUntilChecked(4);
+    ASSERT_TRUE(m_logic->calls().empty());
+
+    m_logic->release("slow");
+    processUntilCalls(5);
+
+    std::vector<std::string> expected = { "check:1", "cancel:2", "check:3", "simple:4",
+                                          "batch2:5" };
+    ASSERT_EQ(expected, m_logic->calls());
+}
+
+TEST_F(CheckWorkerPoolFixture, otherOnIdleLinkIsExecutedAtOnce) {
+    m_pool.dispatch(std::make_shared<CancelRequest>(1), context(m_linkA));
+
+    std::vector<std::string> expected = { "cancel:1" };
+    ASSERT_EQ(expected, m_logic->calls());
+}
+
+TEST_F(CheckWorkerPoolFixture, resultsOutOfOrderAcrossLinks) {
+    m_logic->hold("slow");
+
+    check(m_linkA, "slow", 1);
+    check(m_linkB, "fast", 2);
+
+    // Link B does not wait for link A
+    processUntilCalls(1);
+    std::vector<std::string> expected = { "check:2" };
+    ASSERT_EQ(expected, m_logic->calls());
+
+    m_logic->release("slow");
+    processUntilCalls(2);
+    expected.push_back("check:1");
+    ASSERT_EQ(expected, m_logic->calls());
+}
+
+TEST_F(CheckWorkerPoolFixture, linkClosedWhileResultsPending) {
+    m_logic->hold("slow");
+
+    check(m_linkA, "slow", 1);
+    m_pool.dispatch(std::make_shared<CancelRequest>(2), context(m_linkA));
+    check(m_linkB, "fast", 3);
+    processUntilCalls(1);
+
+    m_pool.contextClosed(context(m_linkA));
+
+    // Results of closed link are dropped, other links are not affected
+    m_logic->release("slow");
+    processUntilChecked(2);
+
+    std::vector<std::string> expected = { "check:3", "closed:0" };
+    ASSERT_EQ(expected, m_logic->calls());
+}
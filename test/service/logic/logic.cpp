@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/service/logic/logic.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of committing policy modifications by service logic
+ */
+
+#include <csignal>
+#include <map>
+#include <memory>
+#include <sys/resource.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <attributes/attributes.h>
+#include <containers/BinaryQueue.h>
+#include <plugin/PluginManager.h>
+#include <request/RequestContext.h>
+#include <request/SetPoliciesRequest.h>
+#include <response/CodeResponse.h>
+#include <response/ResponseTaker.h>
+#include <storage/InMemoryStorageBackend.h>
+#include <storage/Storage.h>
+#include <types/Policy.h>
+#include <types/PolicyBucketId.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+#include <logic/Logic.h>
+#include <sockets/SocketManager.h>
+
+#include "../../storage/databasedirfixture.h"
+
+using namespace Cynara;
+
+namespace {
+
+class CodeResponseTaker : public ResponseTaker {
+public:
+    using ResponseTaker::execute;
+
+    virtual void execute(const RequestContext &context UNUSED, const CodeResponse &response) {
+        m_codes.push_back(response.m_code);
+    }
+
+    std::vector<CodeResponse::Code> m_codes;
+};
+
+/*
+ * While guard exists, files cannot grow, so writes of write-ahead log fail with EFBIG
+ */
+class FileSizeLimitGuard {
+public:
+    FileSizeLimitGuard() {
+        getrlimit(RLIMIT_FSIZE, &m_limit);
+        m_handler = signal(SIGXFSZ, SIG_IGN);
+        struct rlimit limit = m_limit;
+        limit.rlim_cur = 0;
+        setrlimit(RLIMIT_FSIZE, &limit);
+    }
+
+    ~FileSizeLimitGuard() {
+        setrlimit(RLIMIT_FSIZE, &m_limit);
+        signal(SIGXFSZ, m_handler);
+    }
+
+private:
+    struct rlimit m_limit;
+    sighandler_t m_handler;
+};
+
+class LogicCommitFixture : public DatabaseDirFixture {
+protected:
+    virtual void SetUp() {
+        DatabaseDirFixture::SetUp();
+
+        InMemoryStorageBackend initial(m_dbPath);
+        initial.createBucket(defaultPolicyBucketId, PolicyResult(PredefinedPolicyType::DENY));
+        initial.save();
+
+        m_backend.reset(new InMemoryStorageBackend(m_dbPath));
+        m_storage = std::make_shared<Storage>(*m_backend);
+        m_logic = std::make_shared<Logic>();
+        m_logic->bindStorage(m_storage);
+        m_logic->bindSocketManager(std::make_shared<SocketManager>());
+        m_logic->bindPluginManager(std::make_shared<PluginManager>(m_dbPath + "plugins/"));
+        m_logic->loadDb();
+
+        m_taker = std::make_shared<CodeResponseTaker>();
+        m_queue = std::make_shared<BinaryQueue>();
+    }
+
+    virtual void TearDown() {
+        m_logic->unbindAll();
+        m_logic.reset();
+        m_storage.reset();
+        m_backend.reset();
+        DatabaseDirFixture::TearDown();
+    }
+
+    void setPolicy(const PolicyKey &key, PolicyType type) {
+        RequestContext context(m_taker, m_queue);
+        m_logic->execute(context, SetPoliciesRequest({{ defaultPolicyBucketId,
+                                                        { Policy(key, PolicyResult(type)) } }},
+                                                     {}, 1));
+    }
+
+    PolicyType check(const PolicyKey &key) {
+        return m_storage->checkPolicy(key).policyType();
+    }
+
+    std::unique_ptr<InMemoryStorageBackend> m_backend;
+    std::shared_ptr<Storage> m_storage;
+    std::shared_ptr<Logic> m_logic;
+    std::shared_ptr<CodeResponseTaker> m_taker;
+    BinaryQueuePtr m_queue;
+};
+
+} // namespace anonymous
+
+/**
+ * @brief   Modifications, which cannot be committed, are reported as failed and reverted
+ * @test    Scenario:
+ * - set policy, while write-ahead log cannot be written
+ * - admin gets FAILED only after commit and checks do not see the policy any more
+ * - set another policy, when log can be written again
+ * - only the second policy is committed and survives reloading database
+ */
+TEST_F(LogicCommitFixture, failedCommitIsReverted) {
+    PolicyKey failedKey("client", "user", "failed");
+    PolicyKey committedKey("client", "user", "committed");
+
+    setPolicy(failedKey, PredefinedPolicyType::ALLOW);
+    ASSERT_TRUE(m_taker->m_codes.empty());
+    {
+        FileSizeLimitGuard guard;
+        m_logic->commitPolicyChanges();
+    }
+    ASSERT_EQ(std::vector<CodeResponse::Code>({ CodeResponse::Code::FAILED }), m_taker->m_codes);
+    ASSERT_EQ(PredefinedPolicyType::DENY, check(failedKey));
+    ASSERT_EQ(0u, m_storage->journalSize());
+
+    setPolicy(committedKey, PredefinedPolicyType::ALLOW);
+    m_logic->commitPolicyChanges();
+    ASSERT_EQ(std::vector<CodeResponse::Code>({ CodeResponse::Code::FAILED,
+                                                CodeResponse::Code::OK }), m_taker->m_codes);
+    ASSERT_EQ(PredefinedPolicyType::DENY, check(failedKey));
+    ASSERT_EQ(PredefinedPolicyType::ALLOW, check(committedKey));
+
+    InMemoryStorageBackend reloaded(m_dbPath);
+    Storage reloadedStorage(reloaded);
+    reloadedStorage.load();
+    ASSERT_EQ(PredefinedPolicyType::DENY, reloadedStorage.checkPolicy(failedKey).policyType());
+    ASSERT_EQ(PredefinedPolicyType::ALLOW,
+              reloadedStorage.checkPolicy(committedKey).policyType());
+}
@@ -42,7 +42,11 @@ const std::string helpMessage(
     "  -u, --user=USER              change user to USER "
                  "[by default uid is not changed]\n"
     "  -g, --group=GROUP            change group to GROUP "
-                 "[by default gid is not changed]\n");
+                 "[by default gid is not changed]\n"
+    "  -w, --workers=COUNT          evaluate checks in COUNT worker threads "
+                 "[by default checks are evaluated in main thread]\n"
+    "  -i, --decision-index         evaluate checks with compiled index "
+                 "of all buckets [by default index is not used]\n");
 
 } // namespace
 
@@ -540,3 +544,123 @@ TEST_F(CynaraCommandlineTest, groupOptionNoParam) {
         ASSERT_EQ(std::string("Missing argument for option: ") + groupOpt + "\n", err);
     }
 }
+
+/**
+ * @brief   Verify if passing workers option to commandline succeeds
+ * @test    Expected result:
+ * - call handler indicates success
+ * - empty output stream
+ * - empty error stream
+ */
+TEST_F(CynaraCommandlineTest, workersOption) {
+    std::string err;
+    std::string out;
+
+    std::string workersParam("4");
+
+    for (const auto &workersOpt : { "-w", "--workers" }) {
+        clearOutput();
+        prepare_argv({ execName, workersOpt, workersParam});
+
+        SCOPED_TRACE(workersOpt);
+        const auto options = Parser::handleCmdlineOptions(this->argc(), this->argv());
+        getOutput(out, err);
+
+        ASSERT_FALSE(options.m_error);
+        ASSERT_FALSE(options.m_exit);
+        ASSERT_FALSE(options.m_daemon);
+        ASSERT_EQ(options.m_mask, static_cast<mode_t>(-1));
+        ASSERT_EQ(options.m_uid, static_cast<uid_t>(-1));
+        ASSERT_EQ(options.m_gid, static_cast<gid_t>(-1));
+        ASSERT_EQ(options.m_workers, 4);
+        ASSERT_TRUE(out.empty());
+        ASSERT_TRUE(err.empty());
+    }
+}
+
+/**
+ * @brief   Verify if passing invalid workers option to commandline fails
+ * @test    Expected result:
+ * - call handler indicates failure
+ * - help message in output stream
+ * - error message in error stream
+ */
+TEST_F(CynaraCommandlineTest, workersOptionInvalid) {
+    std::string err;
+    std::string out;
+
+    for (const auto &workersParam : { "WORKERS", "-1", "4x" }) {
+        for (const auto &workersOpt : { "-w", "--workers" }) {
+            clearOutput();
+            prepare_argv({ execName, workersOpt, workersParam});
+
+            SCOPED_TRACE(workersOpt);
+            const auto options = Parser::handleCmdlineOptions(this->argc(), this->argv());
+            getOutput(out, err);
+
+            ASSERT_TRUE(options.m_error);
+            ASSERT_TRUE(options.m_exit);
+            ASSERT_FALSE(options.m_daemon);
+            ASSERT_EQ(options.m_workers, -1);
+            ASSERT_EQ(helpMessage, out);
+            ASSERT_EQ(std::string("Invalid param: ") + workersParam + "\n", err);
+        }
+    }
+}
+
+/**
+ * @brief   Verify if passing no workers option to commandline fails
+ * @test    Expected result:
+ * - call handler indicates failure
+ * - help message in output stream
+ * - error message in error stream
+ */
+TEST_F(CynaraCommandlineTest, workersOptionNoParam) {
+    std::string err;
+    std::string out;
+
+    for (const auto &workersOpt : { "-w", "--workers" }) {
+        clearOutput();
+        prepare_argv({ execName, workersOpt});
+
+        SCOPED_TRACE(workersOpt);
+        const auto options = Parser::handleCmdlineOptions(this->argc(), this->argv());
+        getOutput(out, err);
+
+        ASSERT_TRUE(options.m_error);
+        ASSERT_TRUE(options.m_exit);
+        ASSERT_FALSE(options.m_daemon);
+        ASSERT_EQ(options.m_workers, 0);
+        ASSERT_EQ(helpMessage, out);
+        ASSERT_EQ(std::string("Missing argument for option: ") + workersOpt + "\n", err);
+    }
+}
+
+/**
+ * @brief   Verify if passing decision index option to commandline succeeds
+ * @test    Expected result:
+ * - call handler indicates success
+ * - empty output stream
+ * - empty error stream
+ */
+TEST_F(CynaraCommandlineTest, decisionIndexOption) {
+    std::string err;
+    std::string out;
+
+    for (const auto &indexOpt : { "-i", "--decision-index" }) {
+        clearOutput();
+        prepare_argv({ execName, indexOpt });
+
+        SCOPED_TRACE(indexOpt);
+        const auto options = Parser::handleCmdlineOptions(this->argc(), this->argv());
+        getOutput(out, err);
+
+        ASSERT_FALSE(options.m_error);
+        ASSERT_FALSE(options.m_exit);
+        ASSERT_FALSE(options.m_daemon);
+        ASSERT_EQ(options.m_workers, 0);
+        ASSERT_TRUE(options.m_decisionIndex);
+        ASSERT_TRUE(out.empty());
+        ASSERT_TRUE(err.empty());
+    }
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/service/sockets/descriptor.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of reading requests through read arena of Descriptor
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <attributes/attributes.h>
+#include <cynara-limits.h>
+#include <containers/BinaryQueue.h>
+#include <protocol/ProtocolClient.h>
+#include <request/CheckRequest.h>
+#include <request/RequestContext.h>
+#include <request/RequestTaker.h>
+#include <response/pointers.h>
+#include <types/PolicyKey.h>
+
+#include <sockets/Descriptor.h>
+
+using namespace Cynara;
+using ::testing::ElementsAre;
+
+namespace {
+
+// Records dispatched checks as "<client><user><privilege>:<sequence number>"
+class RecordingRequestTaker : public RequestTaker {
+public:
+    using RequestTaker::execute;
+
+    virtual void execute(const RequestContext &context UNUSED, const CheckRequest &request) {
+        const auto &key = request.key();
+        m_checks.push_back(key.client().toString() + key.user().toString() +
+                           key.privilege().toString() + ":" +
+                           std::to_string(request.sequenceNumber()));
+    }
+
+    std::vector<std::string> m_checks;
+};
+
+class DescriptorFixture : public ::testing::Test {
+protected:
+    void SetUp(void) {
+        m_descriptor.setProtocol(std::make_shared<ProtocolClient>());
+    }
+
+    static std::string frame(const PolicyKey &key, ProtocolFrameSequenceNumber number) {
+        ProtocolClient protocol;
+        auto queue = std::make_shared<BinaryQueue>();
+        RequestContext context(ResponseTakerPtr(), queue);
+        protocol.execute(context, CheckRequest(key, number));
+
+        std::string data(queue->size(), '\0');
+        queue->flattenConsume(&data[0], data.size());
+        return data;
+    }
+
+    static std::string frame(const std::string &privilege, ProtocolFrameSequenceNumber number) {
+        return frame(PolicyKey("c", "u", privilege), number);
+    }
+
+    /*
+     * Passes data to descriptor like SocketManager does with data read from socket:
+     * reads fill arena tail, but none is longer than maxRead
+     */
+    void receive(const std::string &data, size_t maxRead = DEFAULT_BUFFER_SIZE) {
+        RequestContext context(m_descriptor.responseTaker(), m_descriptor.writeQueue());
+        size_t offset = 0;
+        while (offset < data.size()) {
+            size_t available;
+            unsigned char *tail = m_descriptor.readArenaTail(available);
+            size_t size = std::min(std::min(available, maxRead), data.size() - offset);
+            memcpy(tail, data.data() + offset, size);
+            offset += size;
+
+            m_descriptor.commitRead(size);
+            while (m_descriptor.dispatchRequest(m_taker, context)) {
+            }
+            m_descriptor.releaseParsedRead();
+        }
+    }
+
+    Descriptor m_descriptor;
+    RecordingRequestTaker m_taker;
+};
+
+} // namespace anonymous
+
+/**
+ * @brief   Frame split across two reads is dispatched once it is complete
+ */
+TEST_F(DescriptorFixture, frameSplitAcrossReads) {
+    auto data = frame("p1", 1);
+
+    receive(data.substr(0, data.size() / 2));
+    ASSERT_TRUE(m_taker.m_checks.empty());
+
+    receive(data.substr(data.size() / 2));
+    ASSERT_THAT(m_taker.m_checks, ElementsAre("cup1:1"));
+}
+
+/**
+ * @brief   All frames pipelined in one read are dispatched in order
+ */
+TEST_F(DescriptorFixture, pipelinedFramesInOneRead) {
+    receive(frame("p1", 1) + frame("p2", 2) + frame("p3", 3));
+    ASSERT_THAT(m_taker.m_checks, ElementsAre("cup1:1", "cup2:2", "cup3:3"));
+}
+
+/**
+ * @brief   Unparsed tail of read is kept for next read
+ * @test    Scenario:
+ * - one read carries complete frame and beginning of next one
+ * - after dispatching first frame, beginning of second one is moved to arena start
+ * - second read completes second frame and carries whole third one
+ */
+TEST_F(DescriptorFixture, unparsedTailKept) {
+    auto second = frame("p2", 2);
+    auto split = second.size() - 3;
+
+    receive(frame("p1", 1) + second.substr(0, split));
+    ASSERT_THAT(m_taker.m_checks, ElementsAre("cup1:1"));
+
+    receive(second.substr(split) + frame("p3", 3));
+    ASSERT_THAT(m_taker.m_checks, ElementsAre("cup1:1", "cup2:2", "cup3:3"));
+}
+
+/**
+ * @brief   Frame larger than default buffer is received by growing arena
+ * @test    Scenario:
+ * - frames before and after large one are pipelined with it
+ * - large frame fills arena in several reads, so arena is doubled with partial frame kept
+ * - all frames are dispatched with their contents intact
+ */
+TEST_F(DescriptorFixture, frameLargerThanDefaultBuffer) {
+    // Identifiers are limited, so frame is made large with all of them at their limit
+    std::string id(CYNARA_MAX_ID_LENGTH, 'x');
+    for (size_t i = 0; i < id.size(); ++i)
+        id[i] = static_cast<char>('a' + i % 26);
+    auto large = frame(PolicyKey(id, id, id), 2);
+    ASSERT_LT(DEFAULT_BUFFER_SIZE, large.size());
+
+    receive(frame("p1", 1) + large + frame("p3", 3),
+            DEFAULT_BUFFER_SIZE / 3);
+    ASSERT_THAT(m_taker.m_checks, ElementsAre("cup1:1", id + id + id + ":2", "cup3:3"));
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/service/sockets/socketmanager.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of handling pipelined requests by SocketManager main loop steps
+ */
+
+#include <memory>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <containers/BinaryQueue.h>
+#include <plugin/PluginManager.h>
+#include <protocol/ProtocolClient.h>
+#include <request/CheckRequest.h>
+#include <request/RequestContext.h>
+#include <response/CheckResponse.h>
+#include <response/pointers.h>
+#include <storage/InMemoryStorageBackend.h>
+#include <storage/Storage.h>
+#include <types/Policy.h>
+#include <types/PolicyBucket.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+#include <logic/Logic.h>
+#include <sockets/SocketManager.h>
+
+#include "../../storage/databasedirfixture.h"
+
+using namespace Cynara;
+
+namespace {
+
+// Drives main loop steps over a connection given by test
+class TestSocketManager : public SocketManager {
+public:
+    using SocketManager::addConnection;
+    using SocketManager::createEpoll;
+    using SocketManager::descriptor;
+    using SocketManager::flushPendingWrites;
+    using SocketManager::readyForRead;
+    using SocketManager::readyForWrite;
+
+    // Returns events reported by epoll for fd without waiting longer than timeout
+    uint32_t pollEvents(int fd, int timeout) {
+        struct epoll_event events[MAX_EPOLL_EVENTS];
+        int count = epoll_wait(epollFd(), events, MAX_EPOLL_EVENTS, timeout);
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.fd == fd)
+                return events[i].events;
+        }
+        return 0;
+    }
+};
+
+class SocketManagerFixture : public DatabaseDirFixture {
+protected:
+    virtual void SetUp() {
+        DatabaseDirFixture::SetUp();
+
+        InMemoryStorageBackend initial(m_dbPath);
+        initial.createBucket(defaultPolicyBucketId, PolicyResult(PredefinedPolicyType::DENY));
+        initial.insertPolicy(defaultPolicyBucketId, std::make_shared<Policy>(m_key,
+                             PolicyResult(PredefinedPolicyType::ALLOW)));
+        initial.save();
+
+        m_backend.reset(new InMemoryStorageBackend(m_dbPath));
+        m_storage = std::make_shared<Storage>(*m_backend);
+        m_manager = std::make_shared<TestSocketManager>();
+        m_logic = std::make_shared<Logic>();
+        m_logic->bindStorage(m_storage);
+        m_logic->bindSocketManager(m_manager);
+        m_logic->bindPluginManager(std::make_shared<PluginManager>(m_dbPath + "plugins/"));
+        m_logic->loadDb();
+        m_manager->bindLogic(m_logic);
+
+        int fds[2];
+        ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+        m_serviceFd = fds[0];
+        m_clientFd = fds[1];
+        m_manager->createEpoll();
+        m_manager->addConnection(m_serviceFd, true, std::make_shared<ProtocolClient>());
+
+        m_requests = std::make_shared<BinaryQueue>();
+        m_responses = std::make_shared<BinaryQueue>();
+        m_sent = 0;
+        m_answered = 0;
+    }
+
+    virtual void TearDown() {
+        close(m_clientFd);
+        close(m_serviceFd);
+        m_manager->unbindAll();
+        m_logic->unbindAll();
+        m_logic.reset();
+        m_manager.reset();
+        m_storage.reset();
+        m_backend.reset();
+        DatabaseDirFixture::TearDown();
+    }
+
+    // Writes count check requests to client end of connection at once
+    void sendChecks(unsigned int count) {
+        RequestContext context(ResponseTakerPtr(), m_requests);
+        for (unsigned int i = 0; i < count; ++i) {
+            m_protocol.execute(context, CheckRequest(m_key, m_sent++));
+        }
+
+        std::string data(m_requests->size(), '\0');
+        m_requests->flattenConsume(&data[0], data.size());
+        ASSERT_EQ(static_cast<ssize_t>(data.size()),
+                  write(m_clientFd, data.data(), data.size()));
+    }
+
+    // Handles input like main loop pass does: reads requests and flushes responses
+    void serviceLoopPass(void) {
+        m_manager->readyForRead(m_serviceFd);
+        m_manager->flushPendingWrites();
+    }
+
+    // Reads responses waiting on client end of connection and checks their order
+    void receiveResponses(void) {
+        char buffer[4096];
+        ssize_t size;
+        while ((size = read(m_clientFd, buffer, sizeof(buffer))) > 0) {
+            m_responses->appendCopy(buffer, size);
+        }
+
+        ResponsePtr response;
+        while ((response = m_protocol.extractResponseFromBuffer(m_responses))) {
+            auto checkResponse = std::dynamic_pointer_cast<CheckResponse>(response);
+            ASSERT_NE(nullptr, checkResponse);
+            ASSERT_EQ(static_cast<ProtocolFrameSequenceNumber>(m_answered++),
+                      checkResponse->sequenceNumber());
+            ASSERT_EQ(PredefinedPolicyType::ALLOW, checkResponse->m_resultRef.policyType());
+        }
+    }
+
+    bool writeArmed(void) {
+        return m_manager->descriptor(m_serviceFd).isWriteArmed();
+    }
+
+    bool hasDataToWrite(void) {
+        return m_manager->descriptor(m_serviceFd).hasDataToWrite();
+    }
+
+    const PolicyKey m_key = PolicyKey("client", "user", "privilege");
+    std::unique_ptr<InMemoryStorageBackend> m_backend;
+    std::shared_ptr<Storage> m_storage;
+    std::shared_ptr<TestSocketManager> m_manager;
+    std::shared_ptr<Logic> m_logic;
+    ProtocolClient m_protocol;
+    BinaryQueuePtr m_requests;
+    BinaryQueuePtr m_responses;
+    int m_serviceFd;
+    int m_clientFd;
+    unsigned int m_sent;
+    unsigned int m_answered;
+};
+
+} // namespace anonymous
+
+/**
+ * @brief   Responses to pipelined requests are sent at once without arming EPOLLOUT
+ * @test    Scenario:
+ * - several requests are written to connection with one write
+ * - one main loop pass answers all of them with one sendmsg
+ * - EPOLLOUT is never armed, as write queue is emptied right away
+ */
+TEST_F(SocketManagerFixture, pipelinedRequestsAnswered) {
+    sendChecks(5);
+    ASSERT_TRUE(m_manager->pollEvents(m_serviceFd, 0) & EPOLLIN);
+
+    serviceLoopPass();
+    EXPECT_FALSE(hasDataToWrite());
+    EXPECT_FALSE(writeArmed());
+    EXPECT_EQ(0u, m_manager->pollEvents(m_serviceFd, 0));
+
+    receiveResponses();
+    EXPECT_EQ(5u, m_answered);
+}
+
+/**
+ * @brief   EPOLLOUT is armed only while write queue is not empty
+ * @test    Scenario:
+ * - requests are pipelined until responses do not fit into socket buffer
+ * - EPOLLOUT is armed then and reported by epoll once client reads responses
+ * - after remaining responses are sent with full sendmsg, EPOLLOUT is disarmed
+ * - all responses are received in order of requests
+ */
+TEST_F(SocketManagerFixture, writeArmedOnlyWithPendingData) {
+    const int bufferSize = 4096;
+    ASSERT_EQ(0, setsockopt(m_serviceFd, SOL_SOCKET, SO_SNDBUF, &bufferSize,
+                            sizeof(bufferSize)));
+
+    for (int i = 0; i < 1000 && !hasDataToWrite(); ++i) {
+        sendChecks(50);
+        serviceLoopPass();
+    }
+    ASSERT_TRUE(hasDataToWrite());
+    ASSERT_TRUE(writeArmed());
+
+    for (int i = 0; i < 1000 && hasDataToWrite(); ++i) {
+        ASSERT_TRUE(writeArmed());
+        receiveResponses();
+        ASSERT_TRUE(m_manager->pollEvents(m_serviceFd, 1000) & EPOLLOUT);
+        m_manager->readyForWrite(m_serviceFd);
+    }
+    ASSERT_FALSE(hasDataToWrite());
+    EXPECT_FALSE(writeArmed());
+
+    receiveResponses();
+    EXPECT_EQ(m_sent, m_answered);
+    EXPECT_EQ(0u, m_manager->pollEvents(m_serviceFd, 0) & EPOLLOUT);
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/storage/checksum/checksuminputstream.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of single pass checksum verification of database files
+ */
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <config/PathConfig.h>
+#include <exceptions/ChecksumRecordCorruptedException.h>
+#include <storage/Checksum.h>
+#include <storage/ChecksumInputStream.h>
+#include <storage/ChecksumValidator.h>
+
+#include "../databasedirfixture.h"
+
+using namespace Cynara;
+
+namespace {
+
+class ChecksumInputStreamFixture : public DatabaseDirFixture {
+protected:
+    std::string bucketContents(int lines = 2000) {
+        std::string contents;
+        for (int i = 0; i < lines; ++i)
+            contents += "client" + std::to_string(i) + ";user;privilege;0xFFFF;\n";
+        return contents;
+    }
+
+    void writeFile(const std::string &filename, const std::string &contents) {
+        std::ofstream file(m_dbPath + filename);
+        file << contents;
+    }
+
+    void loadRecord(ChecksumValidator &validator, const std::string &filename,
+                    const std::string &contents, Checksum::Algorithm algorithm) {
+        std::istringstream checksums(filename + PathConfig::StoragePath::fieldSeparator +
+                                     ChecksumValidator::generate(contents, algorithm) +
+                                     PathConfig::StoragePath::recordSeparator);
+        validator.load(checksums);
+    }
+
+    // Parses only first record, as deserializers do not have to read file till the end
+    void readFirstLine(ChecksumInputStream &stream) {
+        std::string line;
+        ASSERT_TRUE(static_cast<bool>(std::getline(stream, line)));
+        ASSERT_EQ("client0;user;privilege;0xFFFF;", line);
+    }
+};
+
+} // namespace
+
+/**
+ * @brief   Verify file which was only partially parsed
+ * @test    Expected result:
+ * - stream does not keep contents for XXH64 records
+ * - verify() covers unread part of file and accepts it
+ */
+TEST_F(ChecksumInputStreamFixture, verifyPartiallyRead) {
+    const std::string filename("_bucket");
+    auto contents = bucketContents();
+    writeFile(filename, contents);
+
+    ChecksumValidator validator(m_dbPath);
+    loadRecord(validator, filename, contents, Checksum::Algorithm::XXH64);
+    ASSERT_FALSE(validator.needsContents(m_dbPath + filename, false));
+
+    ChecksumInputStream stream(m_dbPath + filename, false);
+    ASSERT_TRUE(stream.is_open());
+    readFirstLine(stream);
+    ASSERT_NO_THROW(validator.verify(stream, m_dbPath + filename, false));
+}
+
+/**
+ * @brief   Verify file corrupted after parsed part
+ * @test    Expected result: verify() throws ChecksumRecordCorruptedException
+ */
+TEST_F(ChecksumInputStreamFixture, corruptedTail) {
+    const std::string filename("_bucket");
+    auto contents = bucketContents();
+
+    ChecksumValidator validator(m_dbPath);
+    loadRecord(validator, filename, contents, Checksum::Algorithm::XXH64);
+    contents[contents.size() - 2] = '0';
+    writeFile(filename, contents);
+
+    ChecksumInputStream stream(m_dbPath + filename, false);
+    readFirstLine(stream);
+    ASSERT_THROW(validator.verify(stream, m_dbPath + filename, false),
+                 ChecksumRecordCorruptedException);
+}
+
+/**
+ * @brief   Verify file with legacy MD5-crypt record
+ * @test    Expected result:
+ * - stream has to keep contents for MD5-crypt records
+ * - verify() accepts backup file with valid legacy checksum
+ */
+TEST_F(ChecksumInputStreamFixture, verifyLegacy) {
+    const std::string filename("_bucket");
+    const std::string backupFilename(filename + PathConfig::StoragePath::backupFilenameSuffix);
+    // some crypt(3) implementations limit length of data
+    auto contents = bucketContents(10);
+    writeFile(backupFilename, contents);
+
+    ChecksumValidator validator(m_dbPath);
+    loadRecord(validator, filename, contents, Checksum::Algorithm::MD5_CRYPT);
+    ASSERT_TRUE(validator.needsContents(m_dbPath + backupFilename, true));
+
+    ChecksumInputStream stream(m_dbPath + backupFilename, true);
+    readFirstLine(stream);
+    ASSERT_NO_THROW(validator.verify(stream, m_dbPath + backupFilename, true));
+    ASSERT_EQ(contents, stream.contents());
+}
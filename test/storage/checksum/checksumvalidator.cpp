@@ -23,14 +23,19 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <config/PathConfig.h>
 #include <exceptions/ChecksumRecordCorruptedException.h>
+#include <storage/Checksum.h>
 #include <storage/ChecksumValidator.h>
 
 #include "checksumvalidatorfixture.h"
@@ -47,7 +52,7 @@ const char ChecksumValidatorFixture::m_recordSeparator(PathConfig::StoragePath::
 const size_t ChecksumValidatorFixture::m_firstLine(1);
 
 /**
- * @brief   Verify if generate() can use systems' crypt(3) implementation
+ * @brief   Verify if generate() returns checksum for any data
  * @test    Expected result: no exceptions are thrown and non-empty string is returned
  */
 TEST_F(ChecksumValidatorFixture, generateChecksum) {
@@ -152,3 +157,70 @@ TEST_F(ChecksumValidatorFixture, checksumMismatch) {
                      ChecksumRecordCorruptedException);
     }
 }
+
+/**
+ * @brief   Verify if streaming hash matches reference XXH64 values
+ * @test    Expected result: digests of reference inputs are equal to published values
+ */
+TEST_F(ChecksumValidatorFixture, xxh64ReferenceValues) {
+    const std::vector<std::pair<std::string, uint64_t>> references = {
+        { "", 0xEF46DB3751D8E999ULL },
+        { "a", 0xD24EC4F1A98C6E5BULL },
+        { "abc", 0x44BC2CF5AD770999ULL },
+    };
+
+    for (const auto &reference : references) {
+        SCOPED_TRACE(reference.first);
+
+        Checksum::Hasher hasher;
+        hasher.update(reference.first.data(), reference.first.size());
+        ASSERT_EQ(reference.second, hasher.digest());
+    }
+}
+
+/**
+ * @brief   Verify if hash does not depend on how data was split between updates
+ * @test    Expected result: feeding data in chunks of any size gives the same checksum
+ */
+TEST_F(ChecksumValidatorFixture, xxh64Incremental) {
+    std::string data;
+    for (int i = 0; i < 1000; ++i)
+        data += "client;user;privilege;0xFFFF;" + std::to_string(i) + "\n";
+
+    const auto expected = ChecksumValidator::generate(data);
+    for (std::size_t chunk : { 1, 3, 7, 31, 32, 33, 4096 }) {
+        SCOPED_TRACE(chunk);
+
+        Checksum::Hasher hasher;
+        for (std::size_t pos = 0; pos < data.size(); pos += chunk)
+            hasher.update(data.data() + pos, std::min(chunk, data.size() - pos));
+        ASSERT_EQ(expected, hasher.checksum());
+    }
+}
+
+/**
+ * @brief   Verify if compare() accepts records of both algorithms and rejects unknown ones
+ * @test    Expected result:
+ * - files matching MD5-crypt and XXH64 records are accepted
+ * - record of unknown algorithm makes compare() throw ChecksumRecordCorruptedException
+ */
+TEST_F(ChecksumValidatorFixture, compareAlgorithms) {
+    const std::string contents(";0x0;\n");
+    std::stringstream buffer;
+    buffer << "legacy" << m_fieldSeparator
+           << ChecksumValidator::generate(contents, Checksum::Algorithm::MD5_CRYPT) << m_recordSeparator
+           << "fast" << m_fieldSeparator
+           << ChecksumValidator::generate(contents, Checksum::Algorithm::XXH64) << m_recordSeparator
+           << "unknown" << m_fieldSeparator << "$5$$unknown" << m_recordSeparator;
+
+    FakeChecksumValidator validator(m_dbPath);
+    validator.load(buffer);
+
+    ASSERT_EQ(0u, validator.sums().at("fast").find("$xxh64$"));
+    ASSERT_NO_THROW(validator.compare(contents, m_dbPath + "legacy", false));
+    ASSERT_NO_THROW(validator.compare(contents, m_dbPath + "fast", false));
+    ASSERT_THROW(validator.compare(contents, m_dbPath + "unknown", false),
+                 ChecksumRecordCorruptedException);
+    ASSERT_THROW(validator.compare(contents + " ", m_dbPath + "fast", false),
+                 ChecksumRecordCorruptedException);
+}
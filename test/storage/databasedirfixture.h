@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/storage/databasedirfixture.h
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Fixture providing temporary database directory
+ */
+
+#ifndef TEST_STORAGE_DATABASEDIRFIXTURE_H_
+#define TEST_STORAGE_DATABASEDIRFIXTURE_H_
+
+#include <cstdlib>
+#include <dirent.h>
+#include <string>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+class DatabaseDirFixture : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        char dirTemplate[] = "/tmp/cynara-db-XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dirTemplate));
+        m_dbPath = std::string(dirTemplate) + "/";
+    }
+
+    virtual void TearDown() {
+        DIR *dir = opendir(m_dbPath.c_str());
+        if (dir != nullptr) {
+            struct dirent *entry;
+            while ((entry = readdir(dir)) != nullptr) {
+                std::string name = entry->d_name;
+                if (name != "." && name != "..")
+                    unlink((m_dbPath + name).c_str());
+            }
+            closedir(dir);
+        }
+        rmdir(m_dbPath.c_str());
+    }
+
+    std::string m_dbPath;
+};
+
+#endif /* TEST_STORAGE_DATABASEDIRFIXTURE_H_ */
@@ -284,6 +284,8 @@ TEST_F(InMemoryStorageBackendFixture, load_from_backup) {
         InSequence s;
         EXPECT_CALL(backend, buckets()).WillRepeatedly(ReturnRef(m_buckets));
         EXPECT_CALL(backend, postLoadCleanup(true)).WillOnce(Return());
+        // Snapshot of loaded database is published at the end
+        EXPECT_CALL(backend, buckets()).WillRepeatedly(ReturnRef(m_buckets));
         backend.load();
     }
 
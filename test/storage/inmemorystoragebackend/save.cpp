@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/storage/inmemorystoragebackend/save.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of incremental saving of InMemoryStorageBackend
+ */
+
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <gtest/gtest.h>
+
+#include <config/PathConfig.h>
+#include <storage/InMemoryStorageBackend.h>
+#include <types/Policy.h>
+#include <types/PolicyBucket.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+#include "../databasedirfixture.h"
+
+using namespace Cynara;
+
+namespace {
+
+class IncrementalSaveFixture : public DatabaseDirFixture {
+protected:
+    ino_t inode(const std::string &filename) {
+        struct stat st;
+        if (stat((m_dbPath + filename).c_str(), &st) != 0)
+            return 0;
+        return st.st_ino;
+    }
+
+    bool exists(const std::string &filename) {
+        struct stat st;
+        return stat((m_dbPath + filename).c_str(), &st) == 0;
+    }
+
+    void prepareDatabase(InMemoryStorageBackend::DatabaseFormat format) {
+        InMemoryStorageBackend backend(m_dbPath);
+        backend.setFormat(format);
+        backend.createBucket(defaultPolicyBucketId, PolicyResult(PredefinedPolicyType::DENY));
+        backend.createBucket("clean", PolicyResult(PredefinedPolicyType::DENY));
+        backend.createBucket("modified", PolicyResult(PredefinedPolicyType::DENY));
+        backend.insertPolicy("clean", std::make_shared<Policy>(PolicyKey("c", "u", "p"),
+                             PolicyResult(PredefinedPolicyType::ALLOW)));
+        backend.save();
+    }
+
+    void checkIncrementalSave(InMemoryStorageBackend::DatabaseFormat format) {
+        const std::string cleanFile = PathConfig::StoragePath::bucketFilenamePrefix + "clean";
+        const std::string modifiedFile = PathConfig::StoragePath::bucketFilenamePrefix +
+                                         "modified";
+        prepareDatabase(format);
+
+        InMemoryStorageBackend backend(m_dbPath);
+        backend.load();
+        ASSERT_EQ(format, backend.format());
+
+        auto cleanInode = inode(cleanFile);
+        auto modifiedInode = inode(modifiedFile);
+        ASSERT_NE(0u, cleanInode);
+        ASSERT_NE(0u, modifiedInode);
+
+        backend.insertPolicy("modified", std::make_shared<Policy>(PolicyKey("c", "u", "p"),
+                             PolicyResult(PredefinedPolicyType::ALLOW)));
+        backend.updateBucket("clean", PolicyResult(PredefinedPolicyType::ALLOW));
+        backend.save();
+
+        EXPECT_EQ(cleanInode, inode(cleanFile));
+        EXPECT_NE(modifiedInode, inode(modifiedFile));
+        EXPECT_FALSE(exists(cleanFile + PathConfig::StoragePath::backupFilenameSuffix));
+        EXPECT_FALSE(exists(modifiedFile + PathConfig::StoragePath::backupFilenameSuffix));
+        EXPECT_FALSE(exists(PathConfig::StoragePath::guardFilename));
+
+        // second save reuses checksums recorded by the first one
+        backend.save();
+        EXPECT_EQ(cleanInode, inode(cleanFile));
+
+        InMemoryStorageBackend loaded(m_dbPath);
+        ASSERT_NO_THROW(loaded.load());
+        EXPECT_EQ(1u, loaded.listPolicies("clean", PolicyKey("c", "u", "p")).size());
+        EXPECT_EQ(1u, loaded.listPolicies("modified", PolicyKey("c", "u", "p")).size());
+        EXPECT_EQ(PredefinedPolicyType::ALLOW,
+                  loaded.inMemoryBuckets()->at("clean").defaultPolicy().policyType());
+    }
+};
+
+} // namespace
+
+/**
+ * @brief   Save only modified buckets of text database
+ * @test    Scenario:
+ * - Load database and modify policies of one bucket and default policy of another
+ * - After save only modified bucket file is replaced, the other one keeps its inode
+ * - No backup files nor guard are left and database loads with valid checksums
+ */
+TEST_F(IncrementalSaveFixture, save_modified_text) {
+    checkIncrementalSave(InMemoryStorageBackend::DatabaseFormat::TEXT);
+}
+
+/**
+ * @brief   Save only modified buckets of binary database
+ * @test    Scenario is the same as in save_modified_text
+ */
+TEST_F(IncrementalSaveFixture, save_modified_binary) {
+    checkIncrementalSave(InMemoryStorageBackend::DatabaseFormat::BINARY);
+}
+
+/**
+ * @brief   Rewrite whole database when format changes
+ * @test    Scenario:
+ * - Load text database and switch it to binary format
+ * - All bucket files are replaced
+ */
+TEST_F(IncrementalSaveFixture, save_format_change) {
+    const std::string cleanFile = PathConfig::StoragePath::bucketFilenamePrefix + "clean";
+    prepareDatabase(InMemoryStorageBackend::DatabaseFormat::TEXT);
+
+    InMemoryStorageBackend backend(m_dbPath);
+    backend.load();
+    auto cleanInode = inode(cleanFile);
+    backend.setFormat(InMemoryStorageBackend::DatabaseFormat::BINARY);
+    backend.save();
+    EXPECT_NE(cleanInode, inode(cleanFile));
+
+    InMemoryStorageBackend loaded(m_dbPath);
+    ASSERT_NO_THROW(loaded.load());
+    EXPECT_EQ(InMemoryStorageBackend::DatabaseFormat::BINARY, loaded.format());
+    EXPECT_EQ(1u, loaded.listPolicies("clean", PolicyKey("c", "u", "p")).size());
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/storage/inmemorystoragebackend/wal.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of write-ahead log of InMemoryStorageBackend
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <config/PathConfig.h>
+#include <exceptions/DatabaseCorruptedException.h>
+#include <storage/Checksum.h>
+#include <storage/InMemoryStorageBackend.h>
+#include <types/Policy.h>
+#include <types/PolicyBucket.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+#include "../databasedirfixture.h"
+
+using namespace Cynara;
+
+namespace {
+
+class WriteAheadLogFixture : public DatabaseDirFixture {
+protected:
+    off_t walSize(void) {
+        struct stat st;
+        if (stat((m_dbPath + PathConfig::StoragePath::walFilename).c_str(), &st) != 0)
+            return -1;
+        return st.st_size;
+    }
+
+    void prepareDatabase(void) {
+        InMemoryStorageBackend backend(m_dbPath);
+        backend.createBucket(defaultPolicyBucketId, PolicyResult(PredefinedPolicyType::DENY));
+        backend.createBucket("bucket", PolicyResult(PredefinedPolicyType::DENY));
+        backend.insertPolicy("bucket", std::make_shared<Policy>(PolicyKey("c", "u", "p"),
+                             PolicyResult(PredefinedPolicyType::ALLOW)));
+        backend.save();
+    }
+
+    // Loads database, modifies it and commits modifications to log without saving
+    void commitModifications(void) {
+        InMemoryStorageBackend backend(m_dbPath);
+        backend.load();
+        backend.createBucket("new", PolicyResult(PredefinedPolicyType::ALLOW));
+        backend.insertPolicy(defaultPolicyBucketId,
+                             std::make_shared<Policy>(PolicyKey("c", "u", "p"),
+                             PolicyResult(PredefinedPolicyType::BUCKET, "new")));
+        backend.deletePolicy("bucket", PolicyKey("c", "u", "p"));
+        backend.commit();
+        ASSERT_LT(0u, backend.journalSize());
+    }
+
+    // Appends frame with valid checksum of given payload to the log
+    void appendFrame(const std::string &payload) {
+        Checksum::Hasher hasher;
+        hasher.update(payload.data(), payload.size());
+        uint32_t size = static_cast<uint32_t>(payload.size());
+        uint32_t reserved = 0;
+        uint64_t checksum = hasher.digest();
+
+        std::string frame(reinterpret_cast<const char *>(&size), sizeof(size));
+        frame.append(reinterpret_cast<const char *>(&reserved), sizeof(reserved));
+        frame.append(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+        frame.append(payload);
+
+        int fd = open((m_dbPath + PathConfig::StoragePath::walFilename).c_str(),
+                      O_WRONLY | O_APPEND);
+        ASSERT_LE(0, fd);
+        ASSERT_EQ(static_cast<ssize_t>(frame.size()), write(fd, frame.data(), frame.size()));
+        close(fd);
+    }
+
+    static void appendString(std::string &payload, const std::string &value) {
+        uint32_t length = static_cast<uint32_t>(value.size());
+        payload.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        payload.append(value);
+    }
+
+    // Record inserting ALLOW policy for key (x, y, z) into "bucket"
+    static std::string insertRecord(void) {
+        std::string payload(1, 1);
+        appendString(payload, "bucket");
+        appendString(payload, "x");
+        appendString(payload, "y");
+        appendString(payload, "z");
+        uint32_t type = PredefinedPolicyType::ALLOW;
+        payload.append(reinterpret_cast<const char *>(&type), sizeof(type));
+        appendString(payload, "");
+        return payload;
+    }
+
+    void checkUndecodableFrame(const std::string &payload) {
+        prepareDatabase();
+        commitModifications();
+        appendFrame(payload);
+        auto size = walSize();
+
+        InMemoryStorageBackend backend(m_dbPath);
+        ASSERT_THROW(backend.load(), DatabaseCorruptedException);
+        EXPECT_FALSE(backend.hasBucket("bucket"));
+        // Log is kept as it is, it is not mistaken for a torn tail
+        EXPECT_EQ(size, walSize());
+
+        // Database was not overwritten with any part of the frame
+        unlink((m_dbPath + PathConfig::StoragePath::walFilename).c_str());
+        InMemoryStorageBackend reloaded(m_dbPath);
+        ASSERT_NO_THROW(reloaded.load());
+        EXPECT_FALSE(reloaded.hasBucket("new"));
+        EXPECT_EQ(1u, reloaded.listPolicies("bucket", PolicyKey("c", "u", "p")).size());
+        EXPECT_TRUE(reloaded.listPolicies("bucket", PolicyKey("x", "y", "z")).empty());
+    }
+
+    void checkModifications(InMemoryStorageBackend &backend) {
+        ASSERT_TRUE(backend.hasBucket("new"));
+        EXPECT_EQ(PredefinedPolicyType::ALLOW,
+                  backend.inMemoryBuckets()->at("new").defaultPolicy().policyType());
+        EXPECT_EQ(1u, backend.listPolicies(defaultPolicyBucketId,
+                                           PolicyKey("c", "u", "p")).size());
+        EXPECT_TRUE(backend.listPolicies("bucket", PolicyKey("c", "u", "p")).empty());
+    }
+};
+
+} // namespace
+
+/**
+ * @brief   Committed modifications survive restart without saving database
+ * @test    Scenario:
+ * - Modify loaded database and commit modifications to write-ahead log only
+ * - Loading database replays log, folds it into database and empties the log
+ */
+TEST_F(WriteAheadLogFixture, replay_committed) {
+    prepareDatabase();
+    commitModifications();
+
+    InMemoryStorageBackend backend(m_dbPath);
+    ASSERT_NO_THROW(backend.load());
+    checkModifications(backend);
+    EXPECT_EQ(0u, backend.journalSize());
+    EXPECT_EQ(0, walSize());
+
+    InMemoryStorageBackend reloaded(m_dbPath);
+    ASSERT_NO_THROW(reloaded.load());
+    checkModifications(reloaded);
+}
+
+/**
+ * @brief   Torn frame at the end of log is dropped
+ * @test    Scenario:
+ * - Commit modifications and append incomplete frame to the log
+ * - Loading database applies complete frame and ignores torn one
+ */
+TEST_F(WriteAheadLogFixture, drop_torn_frame) {
+    prepareDatabase();
+    commitModifications();
+
+    int fd = open((m_dbPath + PathConfig::StoragePath::walFilename).c_str(), O_WRONLY | O_APPEND);
+    ASSERT_LE(0, fd);
+    const char torn[] = { 0x40, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(torn)), write(fd, torn, sizeof(torn)));
+    close(fd);
+
+    InMemoryStorageBackend backend(m_dbPath);
+    ASSERT_NO_THROW(backend.load());
+    checkModifications(backend);
+    EXPECT_EQ(0, walSize());
+}
+
+/**
+ * @brief   Frame with valid checksum and unknown operation makes database corrupted
+ * @test    Scenario:
+ * - Commit modifications and append frame with a valid record followed by unknown operation
+ * - Loading database fails with DatabaseCorruptedException, none of the frames is folded
+ *   into database and log is not truncated
+ */
+TEST_F(WriteAheadLogFixture, undecodable_frame_unknown_operation) {
+    checkUndecodableFrame(insertRecord() + std::string(1, 0x7f));
+}
+
+/**
+ * @brief   Frame with valid checksum and record running past payload makes database corrupted
+ * @test    Scenario:
+ * - Commit modifications and append frame with a valid record followed by a truncated one
+ * - Loading database fails with DatabaseCorruptedException, none of the frames is folded
+ *   into database and log is not truncated
+ */
+TEST_F(WriteAheadLogFixture, undecodable_frame_overrun) {
+    auto record = insertRecord();
+    checkUndecodableFrame(record + record.substr(0, record.size() - 2));
+}
+
+/**
+ * @brief   Saving database empties write-ahead log
+ * @test    Scenario:
+ * - Commit modifications to log and save database afterwards
+ * - Log is empty and database contains modifications
+ */
+TEST_F(WriteAheadLogFixture, save_resets_log) {
+    prepareDatabase();
+
+    InMemoryStorageBackend backend(m_dbPath);
+    backend.load();
+    backend.createBucket("new", PolicyResult(PredefinedPolicyType::ALLOW));
+    backend.commit();
+    ASSERT_LT(0, walSize());
+
+    backend.save();
+    EXPECT_EQ(0u, backend.journalSize());
+    EXPECT_EQ(0, walSize());
+
+    InMemoryStorageBackend loaded(m_dbPath);
+    ASSERT_NO_THROW(loaded.load());
+    EXPECT_TRUE(loaded.hasBucket("new"));
+}
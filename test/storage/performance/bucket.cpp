@@ -24,6 +24,7 @@
 #include <chrono>
 #include <cstdlib>
 #include <memory>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -32,6 +33,7 @@
 #include <types/Policy.h>
 #include <types/PolicyBucket.h>
 #include <types/PolicyKey.h>
+#include <types/PolicyKeyHelpers.h>
 #include <types/PolicyType.h>
 
 #include "../../Benchmark.h"
@@ -101,6 +103,37 @@ TEST(Performance, bucket_filtered_100000) {
     RecordProperty(key, value);
 }
 
+TEST(Performance, bucket_match_100000) {
+    using std::chrono::microseconds;
+
+    PolicyBucket bucket("test");
+
+    PolicyKeyGenerator generator(100, 10);
+
+    const std::size_t policyNumber = 100000;
+    for (std::size_t i = 0; i < policyNumber; ++i) {
+        bucket.insertPolicy(std::make_shared<Policy>(generator.randomKey(),
+                            PredefinedPolicyType::ALLOW));
+    }
+
+    const unsigned int measureRepeats = 1000;
+    std::vector<PolicyKey> keys;
+    for (auto i = 0u; i < measureRepeats; ++i) {
+        keys.push_back(generator.randomKey());
+    }
+
+    auto result = Benchmark::measure<microseconds>([&bucket, &keys] () {
+        PolicyBucket::Matches matches;
+        for (const auto &key : keys) {
+            bucket.match(key, PolicyKeyHashes(key), matches);
+        }
+    });
+
+    auto key = std::string("performance_" + std::to_string(policyNumber));
+    auto value = std::to_string(result.count() / measureRepeats) + " [us]";
+    RecordProperty(key, value);
+}
+
 TEST(Performance, bucket_hasBucket) {
     using std::chrono::microseconds;
 
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/storage/serializer/binary.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests for binary database format
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <config/PathConfig.h>
+#include <exceptions/BinaryFileCorruptedException.h>
+#include <exceptions/DatabaseCorruptedException.h>
+#include <storage/BinaryDeserializer.h>
+#include <storage/BinaryFormat.h>
+#include <storage/BinarySerializer.h>
+#include <storage/Checksum.h>
+#include <storage/InMemoryStorageBackend.h>
+#include <types/Policy.h>
+#include <types/PolicyBucket.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+#include "../databasedirfixture.h"
+
+using namespace Cynara;
+
+namespace {
+
+class BinaryDatabaseFixture : public DatabaseDirFixture {
+protected:
+    void fillDatabase(InMemoryStorageBackend &backend) {
+        backend.createBucket("other", PolicyResult(PredefinedPolicyType::ALLOW, "meta"));
+        backend.insertPolicy(defaultPolicyBucketId, std::make_shared<Policy>(
+            PolicyKey("client", "user", "privilege"), PolicyResult(PredefinedPolicyType::DENY)));
+        backend.insertPolicy(defaultPolicyBucketId, std::make_shared<Policy>(
+            PolicyKey(PolicyKeyFeature::createWildcard(), PolicyKeyFeature::create("user"),
+                      PolicyKeyFeature::create("privilege")),
+            PolicyResult(PredefinedPolicyType::BUCKET, "other")));
+        backend.insertPolicy("other", std::make_shared<Policy>(
+            PolicyKey("client", "user", "privilege"), PolicyResult(0xAB, "plugin data")));
+    }
+
+    typedef std::tuple<PolicyBucketId, std::string, std::string, std::string, PolicyType,
+                       std::string> PolicyRow;
+
+    std::set<PolicyRow> dumpRows(const InMemoryStorageBackend &backend) {
+        std::set<PolicyRow> rows;
+        for (const auto &bucketIter : *backend.inMemoryBuckets()) {
+            const auto &bucket = bucketIter.second;
+            rows.insert(PolicyRow(bucket.id(), "", "", "", bucket.defaultPolicy().policyType(),
+                                  bucket.defaultPolicy().metadata()));
+            for (const auto &policy : bucket) {
+                rows.insert(PolicyRow(bucket.id(), policy->key().client().toString(),
+                                      policy->key().user().toString(),
+                                      policy->key().privilege().toString(),
+                                      policy->result().policyType(),
+                                      policy->result().metadata()));
+            }
+        }
+        return rows;
+    }
+
+};
+
+} // namespace
+
+TEST_F(BinaryDatabaseFixture, save_load_binary) {
+    InMemoryStorageBackend backend(m_dbPath);
+    backend.createBucket(defaultPolicyBucketId, PolicyResult(PredefinedPolicyType::DENY));
+    fillDatabase(backend);
+    backend.setFormat(InMemoryStorageBackend::DatabaseFormat::BINARY);
+    backend.save();
+
+    ASSERT_TRUE(BinaryDeserializer::isBinaryFile(m_dbPath +
+                                                 PathConfig::StoragePath::indexFilename));
+
+    InMemoryStorageBackend loaded(m_dbPath);
+    loaded.load();
+    ASSERT_EQ(InMemoryStorageBackend::DatabaseFormat::BINARY, loaded.format());
+    ASSERT_EQ(dumpRows(backend), dumpRows(loaded));
+}
+
+TEST_F(BinaryDatabaseFixture, convert_text_to_binary_and_back) {
+    InMemoryStorageBackend backend(m_dbPath);
+    backend.createBucket(defaultPolicyBucketId, PolicyResult(PredefinedPolicyType::DENY));
+    fillDatabase(backend);
+    backend.save();
+
+    InMemoryStorageBackend text(m_dbPath);
+    text.load();
+    ASSERT_EQ(InMemoryStorageBackend::DatabaseFormat::TEXT, text.format());
+    text.setFormat(InMemoryStorageBackend::DatabaseFormat::BINARY);
+    text.save();
+
+    InMemoryStorageBackend binary(m_dbPath);
+    binary.load();
+    ASSERT_EQ(InMemoryStorageBackend::DatabaseFormat::BINARY, binary.format());
+    ASSERT_EQ(dumpRows(backend), dumpRows(binary));
+    binary.setFormat(InMemoryStorageBackend::DatabaseFormat::TEXT);
+    binary.save();
+
+    InMemoryStorageBackend back(m_dbPath);
+    back.load();
+    ASSERT_EQ(InMemoryStorageBackend::DatabaseFormat::TEXT, back.format());
+    ASSERT_EQ(dumpRows(backend), dumpRows(back));
+}
+
+TEST_F(BinaryDatabaseFixture, corrupted_bucket_file) {
+    InMemoryStorageBackend backend(m_dbPath);
+    backend.createBucket(defaultPolicyBucketId, PolicyResult(PredefinedPolicyType::DENY));
+    fillDatabase(backend);
+    backend.setFormat(InMemoryStorageBackend::DatabaseFormat::BINARY);
+    backend.save();
+
+    std::string bucketFilename = m_dbPath + PathConfig::StoragePath::bucketFilenamePrefix +
+                                 "other";
+    {
+        std::fstream file(bucketFilename, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('#');
+    }
+
+    ASSERT_THROW(BinaryDeserializer deserializer(bucketFilename), BinaryFileCorruptedException);
+
+    InMemoryStorageBackend loaded(m_dbPath);
+    ASSERT_THROW(loaded.load(), DatabaseCorruptedException);
+}
+
+TEST_F(BinaryDatabaseFixture, truncated_file) {
+    PolicyBucket bucket("bucket", PolicyResult(PredefinedPolicyType::DENY));
+    bucket.insertPolicy(std::make_shared<Policy>(PolicyKey("c", "u", "p"),
+                                                 PolicyResult(PredefinedPolicyType::ALLOW)));
+    std::string filename = m_dbPath + "bucket";
+    BinarySerializer::dumpBucket(filename, bucket);
+
+    PolicyBucket loaded("bucket", PolicyResult(PredefinedPolicyType::DENY));
+    BinaryDeserializer(filename).loadPolicies(loaded);
+    ASSERT_EQ(1u, loaded.size());
+
+    ASSERT_EQ(0, truncate(filename.c_str(), 30));
+    ASSERT_THROW(BinaryDeserializer deserializer(filename), BinaryFileCorruptedException);
+}
+
+TEST_F(BinaryDatabaseFixture, wrong_file_kind) {
+    PolicyBucket bucket("bucket", PolicyResult(PredefinedPolicyType::DENY));
+    std::string filename = m_dbPath + "bucket";
+    BinarySerializer::dumpBucket(filename, bucket);
+
+    Buckets buckets;
+    ASSERT_THROW(BinaryDeserializer(filename).initBuckets(buckets),
+                 BinaryFileCorruptedException);
+}
+
+TEST_F(BinaryDatabaseFixture, huge_record_count) {
+    PolicyBucket bucket("bucket", PolicyResult(PredefinedPolicyType::DENY));
+    std::string filename = m_dbPath + "bucket";
+    BinarySerializer::dumpBucket(filename, bucket);
+
+    {
+        // Count multiplied by record size would wrap around on 32-bit size_t
+        uint32_t recordCount = 0xFFFFFFFF;
+        std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offsetof(BinaryFormat::FileHeader, recordCount));
+        file.write(reinterpret_cast<const char *>(&recordCount), sizeof(recordCount));
+    }
+
+    ASSERT_THROW(BinaryDeserializer deserializer(filename), BinaryFileCorruptedException);
+}
+
+TEST_F(BinaryDatabaseFixture, invalid_policy_type) {
+    PolicyBucket bucket("bucket", PolicyResult(PredefinedPolicyType::DENY));
+    bucket.insertPolicy(std::make_shared<Policy>(PolicyKey("c", "u", "p"),
+                                                 PolicyResult(PredefinedPolicyType::ALLOW)));
+    std::string filename = m_dbPath + "bucket";
+    BinarySerializer::dumpBucket(filename, bucket);
+
+    {
+        // Type is out of PolicyType range; checksum is fixed, so only type is invalid
+        std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+        auto header = reinterpret_cast<BinaryFormat::FileHeader *>(&content[0]);
+        auto record = reinterpret_cast<BinaryFormat::PolicyRecord *>(header + 1);
+        record->type = 0x10000;
+        Checksum::Hasher hasher;
+        hasher.update(content.data() + sizeof(*header), content.size() - sizeof(*header));
+        header->checksum = hasher.digest();
+        file.seekp(0);
+        file.write(content.data(), content.size());
+    }
+
+    PolicyBucket loaded("bucket", PolicyResult(PredefinedPolicyType::DENY));
+    ASSERT_THROW(BinaryDeserializer(filename).loadPolicies(loaded),
+                 BinaryFileCorruptedException);
+}
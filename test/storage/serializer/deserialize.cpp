@@ -22,6 +22,7 @@
 
 #include <istream>
 #include <memory>
+#include <string>
 #include <tuple>
 
 #include <gmock/gmock.h>
@@ -197,3 +198,70 @@ TEST_F(StorageDeserializerFixture, load_buckets_io_error) {
 
     ASSERT_THROW(deserializer.loadBuckets(buckets), BucketDeserializationException);
 }
+
+TEST_F(StorageDeserializerFixture, load_many_buckets) {
+    using ::testing::Pointee;
+    using ::testing::UnorderedElementsAre;
+
+    const std::size_t bucketsCount = 32;
+    Buckets buckets;
+    for (std::size_t i = 0; i < bucketsCount; ++i) {
+        auto bucketId = "bucket" + std::to_string(i);
+        buckets.insert({ bucketId, PolicyBucket(bucketId, PredefinedPolicyType::DENY) });
+    }
+
+    // Buckets may be loaded concurrently, so opener cannot be a mock with expectations
+    auto streamOpenerFunc = [] (const std::string &bucketId)
+                                -> std::shared_ptr<Cynara::BucketDeserializer> {
+        auto stream = std::make_shared<std::istringstream>("c;u;p;0;" + bucketId);
+        return std::make_shared<BucketDeserializer>(stream);
+    };
+    StorageDeserializer deserializer(nullptr, streamOpenerFunc);
+
+    deserializer.loadBuckets(buckets);
+
+    ASSERT_EQ(bucketsCount, buckets.size());
+    for (const auto &bucket : buckets) {
+        ASSERT_THAT(bucket.second, UnorderedElementsAre(
+            Pointee(Policy(PolicyKey("c", "u", "p"),
+                           PolicyResult(PredefinedPolicyType::DENY, bucket.first)))
+        ));
+    }
+}
+
+TEST_F(StorageDeserializerFixture, load_many_buckets_first_error) {
+    const std::size_t bucketsCount = 32;
+    Buckets buckets;
+    for (std::size_t i = 0; i < bucketsCount; ++i) {
+        auto bucketId = "bucket" + std::to_string(i + 10);
+        buckets.insert({ bucketId, PolicyBucket(bucketId, PredefinedPolicyType::DENY) });
+    }
+
+    // Several buckets fail; failure of the first one in buckets order is expected,
+    // as if buckets were loaded sequentially
+    auto failing = [] (const std::string &bucketId) -> bool {
+        return bucketId == "bucket15" || bucketId == "bucket23" || bucketId == "bucket40";
+    };
+    auto streamOpenerFunc = [this, &failing] (const std::string &bucketId)
+                                -> std::shared_ptr<Cynara::BucketDeserializer> {
+        if (failing(bucketId))
+            return nullptr;
+        return emptyBucketStream();
+    };
+    StorageDeserializer deserializer(nullptr, streamOpenerFunc);
+
+    PolicyBucketId expectedId;
+    for (const auto &bucket : buckets) {
+        if (failing(bucket.first)) {
+            expectedId = bucket.first;
+            break;
+        }
+    }
+
+    try {
+        deserializer.loadBuckets(buckets);
+        FAIL() << "BucketDeserializationException expected";
+    } catch (const BucketDeserializationException &ex) {
+        ASSERT_EQ(expectedId, ex.bucketId());
+    }
+}
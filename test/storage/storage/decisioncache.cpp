@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/storage/storage/decisioncache.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of decision cache used by Storage
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "types/PolicyType.h"
+#include "types/PolicyKey.h"
+#include "types/PolicyResult.h"
+#include "storage/DecisionCache.h"
+#include "storage/Storage.h"
+
+#include "fakestoragebackend.h"
+#include "../../helpers.h"
+
+using namespace Cynara;
+
+TEST(DecisionCache, missAndHit) {
+    DecisionCache cache(10);
+    PolicyKey pk = Helpers::generatePolicyKey();
+    PolicyResult result;
+
+    ASSERT_FALSE(cache.get(pk, result));
+    cache.update(pk, PolicyResult(PredefinedPolicyType::ALLOW));
+    ASSERT_TRUE(cache.get(pk, result));
+    ASSERT_EQ(PredefinedPolicyType::ALLOW, result.policyType());
+
+    ASSERT_EQ(1, cache.hits());
+    ASSERT_EQ(1, cache.misses());
+}
+
+TEST(DecisionCache, clear) {
+    DecisionCache cache(10);
+    PolicyKey pk = Helpers::generatePolicyKey();
+    PolicyResult result;
+
+    cache.update(pk, PolicyResult(PredefinedPolicyType::ALLOW));
+    cache.clear();
+    ASSERT_FALSE(cache.get(pk, result));
+}
+
+TEST(DecisionCache, evictLeastRecentlyUsed) {
+    DecisionCache cache(2);
+    PolicyKey pk1 = Helpers::generatePolicyKey("1");
+    PolicyKey pk2 = Helpers::generatePolicyKey("2");
+    PolicyKey pk3 = Helpers::generatePolicyKey("3");
+    PolicyResult result;
+
+    cache.update(pk1, PolicyResult(PredefinedPolicyType::ALLOW));
+    cache.update(pk2, PolicyResult(PredefinedPolicyType::DENY));
+    ASSERT_TRUE(cache.get(pk1, result));
+    cache.update(pk3, PolicyResult(PredefinedPolicyType::ALLOW));
+
+    ASSERT_TRUE(cache.get(pk1, result));
+    ASSERT_FALSE(cache.get(pk2, result));
+    ASSERT_TRUE(cache.get(pk3, result));
+}
+
+TEST(DecisionCache, hitWithEqualKey) {
+    DecisionCache cache(10);
+    PolicyResult result;
+
+    cache.update(Helpers::generatePolicyKey("1"), PolicyResult(PredefinedPolicyType::ALLOW));
+    ASSERT_TRUE(cache.get(Helpers::generatePolicyKey("1"), result));
+    ASSERT_EQ(PredefinedPolicyType::ALLOW, result.policyType());
+    ASSERT_FALSE(cache.get(Helpers::generatePolicyKey("2"), result));
+}
+
+TEST(DecisionCache, transientKeysComparedByValue) {
+    auto transientKey = [] (const std::string &privilege) -> PolicyKey {
+        return PolicyKey(PolicyKeyFeature::createTransient("cache_client", 12),
+                         PolicyKeyFeature::createTransient("cache_user", 10),
+                         PolicyKeyFeature::createTransient(privilege.data(), privilege.size()));
+    };
+    DecisionCache cache(10);
+    PolicyResult result;
+
+    cache.update(transientKey("cache_privilege_1"), PolicyResult(PredefinedPolicyType::ALLOW));
+    cache.update(transientKey("cache_privilege_2"), PolicyResult(PredefinedPolicyType::DENY));
+    ASSERT_TRUE(cache.get(transientKey("cache_privilege_1"), result));
+    ASSERT_EQ(PredefinedPolicyType::ALLOW, result.policyType());
+    ASSERT_TRUE(cache.get(transientKey("cache_privilege_2"), result));
+    ASSERT_EQ(PredefinedPolicyType::DENY, result.policyType());
+    ASSERT_FALSE(cache.get(transientKey("cache_privilege_3"), result));
+}
+
+TEST(DecisionCache, concurrentHits) {
+    DecisionCache cache(10);
+    PolicyKey pk = Helpers::generatePolicyKey();
+    cache.update(pk, PolicyResult(PredefinedPolicyType::ALLOW));
+
+    const unsigned int threadsCount = 4;
+    const unsigned int repeats = 1000;
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < threadsCount; ++i) {
+        threads.push_back(std::thread([&cache, &pk] () {
+            PolicyResult result;
+            for (unsigned int j = 0; j < repeats; ++j)
+                cache.get(pk, result);
+        }));
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    ASSERT_EQ(threadsCount * repeats, cache.hits());
+}
+
+TEST(DecisionCache, disabled) {
+    DecisionCache cache(0);
+    PolicyKey pk = Helpers::generatePolicyKey();
+    PolicyResult result;
+
+    cache.update(pk, PolicyResult(PredefinedPolicyType::ALLOW));
+    ASSERT_FALSE(cache.get(pk, result));
+}
+
+TEST(DecisionCache, storageCachesAndInvalidates) {
+    using ::testing::_;
+    using ::testing::Return;
+    using ::testing::ReturnPointee;
+
+    PolicyBucket bucket(defaultPolicyBucketId);
+    FakeStorageBackend backend;
+    Cynara::Storage storage(backend, 10);
+    PolicyKey pk = Helpers::generatePolicyKey();
+
+    EXPECT_CALL(backend, searchBucket(defaultPolicyBucketId, pk))
+        .Times(2)
+        .WillRepeatedly(ReturnPointee(&bucket));
+    EXPECT_CALL(backend, hasBucket(defaultPolicyBucketId)).WillRepeatedly(Return(true));
+    EXPECT_CALL(backend, insertPolicy(defaultPolicyBucketId, _));
+
+    ASSERT_EQ(PredefinedPolicyType::DENY, storage.checkPolicy(pk).policyType());
+    ASSERT_EQ(PredefinedPolicyType::DENY, storage.checkPolicy(pk).policyType());
+    ASSERT_EQ(1, storage.decisionCache().hits());
+
+    bucket.insertPolicy(Policy::simpleWithKey(pk, PredefinedPolicyType::ALLOW));
+    storage.insertPolicies({ { defaultPolicyBucketId,
+                               { Policy(pk, PredefinedPolicyType::ALLOW) } } });
+    ASSERT_EQ(PredefinedPolicyType::ALLOW, storage.checkPolicy(pk).policyType());
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/storage/storage/decisionindex.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Differential tests of decision index against recursive storage check
+ */
+
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cynara-admin-types.h>
+
+#include "storage/DecisionIndex.h"
+#include "storage/InMemoryStorageBackend.h"
+#include "storage/Storage.h"
+#include "storage/StorageSnapshot.h"
+#include "types/Policy.h"
+#include "types/PolicyBucket.h"
+#include "types/PolicyKey.h"
+#include "types/PolicyResult.h"
+#include "types/PolicyType.h"
+
+using namespace Cynara;
+
+namespace {
+
+const std::vector<std::string> clients = { "c0", "c1", "c2", "*" };
+const std::vector<std::string> users = { "u0", "u1", "*" };
+const std::vector<std::string> privileges = { "p0", "p1", "p2", "*" };
+const std::size_t bucketsCount = 8;
+
+template <typename T>
+const T &pick(const std::vector<T> &values) {
+    return values.at(std::rand() % values.size());
+}
+
+PolicyBucketId bucketName(std::size_t index) {
+    return index == 0 ? defaultPolicyBucketId : "bucket" + std::to_string(index);
+}
+
+PolicyResult randomResult(std::size_t bucketIndex, bool allowNone) {
+    // Links lead only to buckets with greater indexes, so bucket graph has no cycles
+    std::size_t linkable = bucketsCount - bucketIndex - 1;
+    switch (std::rand() % (linkable ? 5 : 4)) {
+        case 0:
+            return PredefinedPolicyType::ALLOW;
+        case 1:
+            return PredefinedPolicyType::DENY;
+        case 2:
+            return allowNone ? PolicyResult(PredefinedPolicyType::NONE)
+                             : PolicyResult(PredefinedPolicyType::ALLOW);
+        case 3:
+            // Plugin type with metadata, ties are decided by order of evaluation
+            return PolicyResult(0x10, "meta" + std::to_string(std::rand() % 3));
+        default:
+            return PolicyResult(PredefinedPolicyType::BUCKET,
+                                bucketName(bucketIndex + 1 + std::rand() % linkable));
+    }
+}
+
+void fillRandomDatabase(Storage &storage) {
+    for (std::size_t i = 1; i < bucketsCount; ++i)
+        storage.addOrUpdateBucket(bucketName(i), randomResult(bucketsCount, true));
+    storage.addOrUpdateBucket(defaultPolicyBucketId, randomResult(bucketsCount, false));
+
+    std::map<PolicyBucketId, std::vector<Policy>> policies;
+    for (std::size_t i = 0; i < bucketsCount; ++i) {
+        for (int j = 0; j < 12; ++j) {
+            policies[bucketName(i)].push_back(Policy(PolicyKey(pick(clients), pick(users),
+                                                               pick(privileges)),
+                                                     randomResult(i, true)));
+        }
+    }
+    storage.insertPolicies(policies);
+}
+
+void expectSameResults(Storage &reference, Storage &indexed) {
+    auto keyClients = clients;
+    keyClients.push_back("cX");
+
+    for (const auto &client : keyClients) {
+        for (const auto &user : users) {
+            for (const auto &privilege : privileges) {
+                PolicyKey key(client, user, privilege);
+                SCOPED_TRACE(key.toString());
+                ASSERT_EQ(reference.checkPolicy(key), indexed.checkPolicy(key));
+            }
+        }
+    }
+}
+
+} // namespace anonymous
+
+/**
+ * @brief   Decision index must give the same results as recursive check
+ * @test    Scenario:
+ * - fill storage with random acyclic graph of buckets and random policies
+ * - check every key combined from used features with and without decision index
+ * - modify storage through indexed storage and compare results again
+ */
+TEST(DecisionIndex, differentialRandomDatabases) {
+    for (unsigned seed = 1; seed <= 50; ++seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        std::srand(seed);
+
+        InMemoryStorageBackend backend("/fake/path"); // don't use load() or save()
+        Storage reference(backend);
+        Storage indexed(backend, 0, true);
+
+        fillRandomDatabase(indexed);
+        expectSameResults(reference, indexed);
+
+        indexed.insertPolicies({{ bucketName(1), { Policy(PolicyKey("c1", "*", "p1"),
+                                                          PredefinedPolicyType::DENY) } }});
+        expectSameResults(reference, indexed);
+
+        indexed.erasePolicies(defaultPolicyBucketId, false,
+                              PolicyKey("c0", CYNARA_ADMIN_ANY, CYNARA_ADMIN_ANY));
+        expectSameResults(reference, indexed);
+
+        indexed.deleteBucket(bucketName(bucketsCount - 1));
+        expectSameResults(reference, indexed);
+    }
+}
+
+/**
+ * @brief   Checks racing with compilation of decision index give the same results
+ * @test    Scenario:
+ * - fill storage with random database and modify it, so index is not compiled yet
+ * - check the same keys in concurrent threads; some of them compile index, others
+ *   are evaluated by recursive check meanwhile
+ * - compare results with storage without decision index
+ */
+TEST(DecisionIndex, concurrentChecksWhileCompiling) {
+    const unsigned threadsCount = 4;
+    std::srand(1);
+
+    InMemoryStorageBackend backend("/fake/path"); // don't use load() or save()
+    Storage reference(backend);
+    Storage indexed(backend, 0, true);
+    fillRandomDatabase(indexed);
+
+    std::vector<PolicyKey> keys;
+    std::vector<PolicyResult> expected;
+    for (const auto &client : clients) {
+        for (const auto &privilege : privileges) {
+            keys.push_back(PolicyKey(client, users.front(), privilege));
+            expected.push_back(reference.checkPolicy(keys.back()));
+        }
+    }
+
+    for (int round = 0; round < 10; ++round) {
+        indexed.insertPolicies({{ bucketName(1), { Policy(PolicyKey("c1", "*", "p1"),
+                                                          randomResult(1, true)) } }});
+        for (std::size_t i = 0; i < keys.size(); ++i)
+            expected[i] = reference.checkPolicy(keys[i]);
+
+        std::vector<std::vector<PolicyResult>> results(threadsCount);
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < threadsCount; ++t) {
+            threads.emplace_back([&indexed, &keys, &results, t] () {
+                for (const auto &key : keys)
+                    results[t].push_back(indexed.checkPolicy(key));
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+
+        for (unsigned t = 0; t < threadsCount; ++t)
+            ASSERT_EQ(expected, results[t]);
+    }
+}
+
+/**
+ * @brief   Disabled decision index does not evaluate checks
+ * @test    Expected result:
+ * - check() returns false, so storage uses recursive check
+ */
+TEST(DecisionIndex, disabled) {
+    Buckets buckets = { { defaultPolicyBucketId, PolicyBucket(defaultPolicyBucketId) } };
+    StorageSnapshot snapshot(buckets);
+    PolicyKey key("c", "u", "p");
+    PolicyResult result;
+
+    DecisionIndex index(false);
+    ASSERT_FALSE(index.check(snapshot, key, PolicyKeyHashes(key), result));
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2015 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+/**
+ * @file        test/storage/storage/snapshot.cpp
+ * @author      Lukasz Wojciechowski <l.wojciechow@partner.samsung.com>
+ * @version     1.0
+ * @brief       Tests of storage snapshots read without locks
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <exceptions/BucketNotExistsException.h>
+#include <storage/InMemoryStorageBackend.h>
+#include <storage/Storage.h>
+#include <storage/StorageSnapshot.h>
+#include <types/Policy.h>
+#include <types/PolicyBucket.h>
+#include <types/PolicyKey.h>
+#include <types/PolicyResult.h>
+#include <types/PolicyType.h>
+
+using namespace Cynara;
+
+/**
+ * @brief   Modification publishes new snapshot sharing unmodified buckets
+ * @test    Expected result:
+ * - modified bucket is copied, other buckets are shared with previous snapshot
+ * - pinned snapshot still holds previous version of modified bucket
+ */
+TEST(StorageSnapshot, sharesUnmodifiedBuckets) {
+    InMemoryStorageBackend backend("/fake/path"); // don't use load() or save()
+    Storage storage(backend);
+    PolicyKey key("c", "u", "p");
+
+    storage.addOrUpdateBucket(defaultPolicyBucketId, PredefinedPolicyType::DENY);
+    storage.addOrUpdateBucket("other", PredefinedPolicyType::DENY);
+    auto pinned = storage.snapshot();
+    ASSERT_NE(nullptr, pinned);
+
+    storage.insertPolicies({ { defaultPolicyBucketId,
+                               { Policy(key, PredefinedPolicyType::ALLOW) } } });
+    auto current = storage.snapshot();
+
+    ASSERT_NE(pinned, current);
+    ASSERT_EQ(pinned->sharedBucket("other"), current->sharedBucket("other"));
+    ASSERT_NE(pinned->sharedBucket(defaultPolicyBucketId),
+              current->sharedBucket(defaultPolicyBucketId));
+    ASSERT_TRUE(pinned->listPolicies(defaultPolicyBucketId, key).empty());
+    ASSERT_EQ(1, current->listPolicies(defaultPolicyBucketId, key).size());
+    ASSERT_EQ(PredefinedPolicyType::ALLOW, storage.checkPolicy(key).policyType());
+}
+
+/**
+ * @brief   Published buckets share policies with backend until it modifies them
+ * @test    Expected result:
+ * - after publishing, backend bucket and its snapshot copy share policies
+ * - first modification copies policies of modified bucket only
+ * - snapshot copy keeps its version of policies
+ */
+TEST(StorageSnapshot, copiesPoliciesOnModification) {
+    InMemoryStorageBackend backend("/fake/path");
+    Storage storage(backend);
+    PolicyKey key("c", "u", "p");
+
+    storage.addOrUpdateBucket(defaultPolicyBucketId, PredefinedPolicyType::DENY);
+    storage.addOrUpdateBucket("other", PredefinedPolicyType::DENY);
+    storage.insertPolicies({ { "other", { Policy(key, PredefinedPolicyType::ALLOW) } } });
+    auto pinned = storage.snapshot();
+    const auto &buckets = *backend.inMemoryBuckets();
+
+    ASSERT_TRUE(buckets.at("other").sharesPolicies(*pinned->bucket("other")));
+    ASSERT_TRUE(buckets.at(defaultPolicyBucketId).sharesPolicies(
+                *pinned->bucket(defaultPolicyBucketId)));
+
+    storage.deletePolicies({ { "other", { key } } });
+
+    ASSERT_FALSE(buckets.at("other").sharesPolicies(*pinned->bucket("other")));
+    ASSERT_TRUE(buckets.at(defaultPolicyBucketId).sharesPolicies(
+                *pinned->bucket(defaultPolicyBucketId)));
+    ASSERT_EQ(1, pinned->listPolicies("other", key).size());
+    ASSERT_TRUE(buckets.at("other").empty());
+    ASSERT_TRUE(buckets.at("other").sharesPolicies(*storage.snapshot()->bucket("other")));
+}
+
+/**
+ * @brief   Deleted bucket disappears only from snapshots published after deletion
+ */
+TEST(StorageSnapshot, deleteBucket) {
+    InMemoryStorageBackend backend("/fake/path");
+    Storage storage(backend);
+
+    storage.addOrUpdateBucket(defaultPolicyBucketId, PredefinedPolicyType::DENY);
+    storage.addOrUpdateBucket("other", PredefinedPolicyType::ALLOW);
+    auto pinned = storage.snapshot();
+    storage.deleteBucket("other");
+
+    ASSERT_NE(nullptr, pinned->bucket("other"));
+    ASSERT_EQ(nullptr, storage.snapshot()->bucket("other"));
+    ASSERT_THROW(storage.listPolicies("other", PolicyKey("c", "u", "p")),
+                 BucketNotExistsException);
+}
+
+/**
+ * @brief   Checks run concurrently with modifications
+ * @test    Scenario:
+ * - reader threads check key, while writer keeps adding and removing policy for it
+ * - readers see either version of bucket, never anything else
+ */
+TEST(StorageSnapshot, concurrentChecks) {
+    InMemoryStorageBackend backend("/fake/path");
+    Storage storage(backend, 100, true);
+    PolicyKey key("c", "u", "p");
+    storage.addOrUpdateBucket(defaultPolicyBucketId, PredefinedPolicyType::DENY);
+
+    std::atomic<bool> done(false);
+    std::atomic<unsigned> unexpected(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] () -> void {
+            while (!done) {
+                auto type = storage.checkPolicy(key).policyType();
+                if (type != PredefinedPolicyType::ALLOW && type != PredefinedPolicyType::DENY)
+                    ++unexpected;
+            }
+        });
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        storage.insertPolicies({ { defaultPolicyBucketId,
+                                   { Policy(key, PredefinedPolicyType::ALLOW) } } });
+        storage.deletePolicies({ { defaultPolicyBucketId, { key } } });
+    }
+    done = true;
+    for (auto &reader : readers)
+        reader.join();
+
+    ASSERT_EQ(0, unexpected);
+    ASSERT_EQ(PredefinedPolicyType::DENY, storage.checkPolicy(key).policyType());
+}